@@ -129,7 +129,38 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // the parser has no INCLUDE clause, the included columns of a covering index are given as an index option
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      if (strcmp(option->defname, "include") != 0 || option->arg == nullptr ||
+          option->arg->type != duckdb_libpgquery::T_PGString) {
+        throw NotImplementedException(fmt::format("index option {} is not supported", option->defname));
+      }
+      auto names = StringUtil::Split(reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str, ',');
+      for (const auto &name : names) {
+        auto column_ref = ResolveColumn(*table, std::vector{StringUtil::Strip(name, ' ')});
+        include_cols.emplace_back(std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+      }
+    }
+  }
+
+  // without a USING clause the parser reports its own default access method, which is a B+ tree here
+  auto index_type = IndexType::BPlusTreeIndex;
+  auto access_method = StringUtil::Lower(stmt->accessMethod);
+  if (access_method == "hash") {
+    index_type = IndexType::HashTableIndex;
+  } else if (access_method == "lsm") {
+    index_type = IndexType::LsmTreeIndex;
+  } else if (access_method == "learned") {
+    index_type = IndexType::LearnedIndex;
+  } else if (access_method != "btree" && access_method != DEFAULT_INDEX_TYPE) {
+    throw NotImplementedException(fmt::format("index type {} is not supported", access_method));
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), stmt->unique,
+                                          std::move(include_cols), index_type);
 }
 
 }  // namespace bustub
@@ -39,6 +39,20 @@ BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager
     free_list_.emplace_back(static_cast<int>(i));
     (pages_ + i)->ResetMemory();  // better to resetmemory
   }
+
+  size_t hint_count = 1;
+  while (hint_count < pool_size_ * 2) {
+    hint_count *= 2;
+  }
+  hint_mask_ = hint_count - 1;
+  frame_page_ids_ = std::make_unique<std::atomic<page_id_t>[]>(pool_size_);
+  frame_hints_ = std::make_unique<std::atomic<frame_id_t>[]>(hint_count);
+  for (size_t i = 0; i < pool_size_; ++i) {
+    frame_page_ids_[i].store(INVALID_PAGE_ID);
+  }
+  for (size_t i = 0; i < hint_count; ++i) {
+    frame_hints_[i].store(0);
+  }
 }
 
 BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
@@ -51,11 +65,8 @@ auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
     paid = AllocatePage();
     auto num_free = free_list_.back();
     Page *ppage = pages_ + num_free;
-    // ppage->WLatch();
-    ppage->page_id_ = paid;
-    // ppage->ResetMemory();
+    SetFramePage(num_free, paid, [](Page *) {});
     ++((ppage)->pin_count_);
-    // ppage->WUnlatch();
     free_list_.pop_back();
     page_table_.emplace(paid, num_free);
     replacer_->RecordAccess(num_free);
@@ -75,15 +86,14 @@ auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
     throw Exception("pin count should not be that");
   }
   // ppage->RUnlatch();
-  // ppage->WLatch();
-  if (ppage->is_dirty_) {
-    disk_manager_->WritePage(ppage->page_id_, ppage->data_);
-    ppage->is_dirty_ = false;
-  }
-  ppage->ResetMemory();
-  ppage->page_id_ = paid;
+  SetFramePage(fid, paid, [this](Page *page) {
+    if (page->is_dirty_) {
+      disk_manager_->WritePage(page->page_id_, page->data_);
+      page->is_dirty_ = false;
+    }
+    page->ResetMemory();
+  });
   ++((ppage)->pin_count_);
-  // ppage->WUnlatch();
   page_table_.emplace(paid, fid);
   replacer_->RecordAccess(fid);
   replacer_->SetEvictable(fid, false);
@@ -103,12 +113,8 @@ auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType
   if (!free_list_.empty()) {
     auto num_free = free_list_.back();
     Page *ppage = pages_ + num_free;
-    // ppage->WLatch();
-    // ppage->ResetMemory();
-    disk_manager_->ReadPage(page_id, (ppage)->data_);
-    ppage->page_id_ = page_id;
+    SetFramePage(num_free, page_id, [this, page_id](Page *page) { disk_manager_->ReadPage(page_id, page->data_); });
     ++((ppage)->pin_count_);
-    // ppage->WUnlatch();
     free_list_.pop_back();
     page_table_.emplace(page_id, num_free);
     replacer_->RecordAccess(num_free);
@@ -126,16 +132,15 @@ auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType
   }
   page_table_.erase(page_table_.find(ppage->page_id_));
   // ppage->RUnlatch();
-  // ppage->WLatch();
-  if (ppage->is_dirty_) {
-    disk_manager_->WritePage(ppage->page_id_, ppage->data_);
-    ppage->is_dirty_ = false;
-  }
-  ppage->ResetMemory();
-  disk_manager_->ReadPage(page_id, (ppage)->data_);
-  ppage->page_id_ = page_id;
+  SetFramePage(fid, page_id, [this, page_id](Page *page) {
+    if (page->is_dirty_) {
+      disk_manager_->WritePage(page->page_id_, page->data_);
+      page->is_dirty_ = false;
+    }
+    page->ResetMemory();
+    disk_manager_->ReadPage(page_id, page->data_);
+  });
   ++((ppage)->pin_count_);
-  // ppage->WUnlatch();
   page_table_.emplace(page_id, fid);
   replacer_->RecordAccess(fid);
   replacer_->SetEvictable(fid, false);
@@ -200,16 +205,20 @@ auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
   replacer_->Remove(fid);
   page_table_.erase(ite);
   DeallocatePage(page_id);
-  // ppage->WLatch();
-  ppage->ResetMemory();
-  ppage->page_id_ = INVALID_PAGE_ID;
-  ppage->is_dirty_ = false;
-  // ppage->WUnlatch();
+  SetFramePage(fid, INVALID_PAGE_ID, [](Page *page) {
+    page->ResetMemory();
+    page->is_dirty_ = false;
+  });
   return true;
 }
 
 auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
 
+auto BufferPoolManager::IsPageResident(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return page_table_.find(page_id) != page_table_.end();
+}
+
 auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, FetchPage(page_id)}; }
 
 auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
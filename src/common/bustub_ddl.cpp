@@ -56,25 +56,23 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   for (const auto &col : stmt.cols_) {
     auto idx = stmt.table_->schema_.GetColIdx(col->col_name_.back());
     col_ids.push_back(idx);
-    if (stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-      throw NotImplementedException("only support creating index on integer column");
-    }
   }
   auto key_schema = Schema::CopySchema(&stmt.table_->schema_, col_ids);
 
-  // TODO(spring2023): If you want to support composite index key for leaderboard optimization, remove this assertion
-  // and create index with different key type that can hold multiple keys based on number of index columns.
-  //
-  // You can also create clustered index that directly stores value inside the index by modifying the value type.
+  if (col_ids.empty()) {
+    throw NotImplementedException("index must have at least one column");
+  }
 
-  if (col_ids.empty() || col_ids.size() > 2) {
-    throw NotImplementedException("only support creating index with exactly one or two columns");
+  std::vector<uint32_t> include_col_ids;
+  for (const auto &col : stmt.include_cols_) {
+    include_col_ids.push_back(stmt.table_->schema_.GetColIdx(col->col_name_.back()));
   }
 
+  // The key type is picked by the catalog from the key schema, e.g. one or two integer columns get a native integer
+  // key, other key shapes get a memcmp-comparable normalized key. A non-unique index appends the RID to the key.
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-      txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
+  auto info = catalog_->CreateIndex(txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema,
+                                    col_ids, stmt.is_unique_, include_col_ids, stmt.index_type_);
   l.unlock();
 
   if (info == nullptr) {
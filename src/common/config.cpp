@@ -18,6 +18,12 @@ std::atomic<bool> enable_logging(false);
 
 std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
+std::atomic<bool> enable_optimistic_index_read(false);
+
+std::atomic<bool> enable_index_change_buffer(true);
+
+std::atomic<bool> enable_index_bloom_filter(true);
+
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -19,14 +20,30 @@
 #include "common/logger.h"
 #include "common/rid.h"
 #include "container/disk/hash/disk_extendible_hash_table.h"
+#include "storage/index/normalized_key.h"
 
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                         bool unique_keys)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      unique_keys_(unique_keys) {
+  // the directory starts at global depth 0, with a single empty bucket
+  Page *page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the directory page of a hash table");
+  }
+  memset(page->GetData(), 0, BUSTUB_PAGE_SIZE);
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+  dir_page->SetPageId(directory_page_id_);
+  dir_page->SetLSN(INVALID_LSN);
+  dir_page->SetBucketPageId(0, NewBucketPage());
+  dir_page->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
 }
 
 /*****************************************************************************
@@ -46,22 +63,49 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+  return reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+auto HASH_TABLE_TYPE::NewBucketPage() -> page_id_t {
+  page_id_t bucket_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&bucket_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a bucket page of a hash table");
+  }
+  memset(page->GetData(), 0, BUSTUB_PAGE_SIZE);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  return bucket_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::InsertIntoBucket(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value)
+    -> std::optional<bool> {
+  auto hash = Hash(key);
+  if (unique_keys_) {
+    std::vector<ValueType> values;
+    if (bucket->GetValue(key, comparator_, &values, hash)) {
+      return false;
+    }
+  }
+  if (bucket->Insert(key, value, comparator_, hash)) {
+    return true;
+  }
+  // the pair is already in the bucket unless it is full
+  if (!bucket->IsFull()) {
+    return false;
+  }
+  return std::nullopt;
 }
 
 /*****************************************************************************
@@ -69,7 +113,16 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool found;
+  {
+    auto bucket_guard = buffer_pool_manager_->FetchPageRead(KeyToPageId(key, dir_page));
+    found = bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>()->GetValue(key, comparator_, result, Hash(key));
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +130,78 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  // optimistically insert into the bucket under the shared table latch, only a full bucket takes the exclusive one
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  std::optional<bool> inserted;
+  {
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(KeyToPageId(key, dir_page));
+    inserted = InsertIntoBucket(bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>(), key, value);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (inserted.has_value()) {
+    return *inserted;
+  }
+  return SplitInsert(transaction, key, value);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool dir_dirty = false;
+  std::optional<bool> inserted;
+  // split the bucket of the key until it has room, all of its pairs may hash to the same half
+  while (true) {
+    auto bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    auto bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+    auto *bucket = bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+    inserted = InsertIntoBucket(bucket, key, value);
+    if (inserted.has_value()) {
+      break;
+    }
+
+    auto local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == dir_page->GetGlobalDepth()) {
+      if (dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE) {
+        bucket_guard.Drop();
+        buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+        table_latch_.WUnlock();
+        throw Exception(ExceptionType::OUT_OF_RANGE, "hash table directory is full");
+      }
+      dir_page->IncrGlobalDepth();
+    }
+    dir_dirty = true;
+
+    // the pairs whose hash has the high bit set move to the split image
+    auto high_bit = dir_page->GetLocalHighBit(bucket_idx);
+    auto image_page_id = NewBucketPage();
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      if (dir_page->GetBucketPageId(idx) == bucket_page_id) {
+        dir_page->IncrLocalDepth(idx);
+        if ((idx & high_bit) != 0) {
+          dir_page->SetBucketPageId(idx, image_page_id);
+        }
+      }
+    }
+    auto image_guard = buffer_pool_manager_->FetchPageWrite(image_page_id);
+    auto *image = image_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE && bucket->IsOccupied(slot); slot++) {
+      if (!bucket->IsReadable(slot)) {
+        continue;
+      }
+      auto slot_hash = Hash(bucket->KeyAt(slot));
+      if ((slot_hash & high_bit) != 0) {
+        image->Insert(bucket->KeyAt(slot), bucket->ValueAt(slot), comparator_, slot_hash);
+        bucket->RemoveAt(slot);
+      }
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+  return *inserted;
 }
 
 /*****************************************************************************
@@ -90,14 +209,78 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool removed;
+  bool empty;
+  {
+    auto bucket_guard = buffer_pool_manager_->FetchPageWrite(KeyToPageId(key, dir_page));
+    auto *bucket = bucket_guard.template AsMut<HASH_TABLE_BUCKET_TYPE>();
+    removed = bucket->Remove(key, value, comparator_, Hash(key));
+    empty = bucket->IsEmpty();
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  bool dir_dirty = false;
+  // the merged bucket is empty too if its split image was, keep merging while that is the case
+  while (true) {
+    auto bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    auto bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    auto local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == 0) {
+      break;
+    }
+    auto image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    auto image_page_id = dir_page->GetBucketPageId(image_idx);
+    // an insert may have refilled the bucket before the exclusive latch was taken, merge whichever one is empty
+    page_id_t empty_page_id;
+    page_id_t kept_page_id;
+    {
+      auto bucket_guard = buffer_pool_manager_->FetchPageRead(bucket_page_id);
+      auto image_guard = buffer_pool_manager_->FetchPageRead(image_page_id);
+      if (bucket_guard.template As<HASH_TABLE_BUCKET_TYPE>()->IsEmpty()) {
+        empty_page_id = bucket_page_id;
+        kept_page_id = image_page_id;
+      } else if (image_guard.template As<HASH_TABLE_BUCKET_TYPE>()->IsEmpty()) {
+        empty_page_id = image_page_id;
+        kept_page_id = bucket_page_id;
+      } else {
+        break;
+      }
+    }
+
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      auto page_id = dir_page->GetBucketPageId(idx);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        dir_page->SetBucketPageId(idx, kept_page_id);
+        dir_page->DecrLocalDepth(idx);
+      }
+    }
+    buffer_pool_manager_->DeletePage(empty_page_id);
+    while (dir_page->CanShrink()) {
+      dir_page->DecrGlobalDepth();
+    }
+    dir_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
@@ -135,4 +318,9 @@ template class DiskExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16
 template class DiskExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
 template class DiskExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class DiskExtendibleHashTable<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class DiskExtendibleHashTable<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class DiskExtendibleHashTable<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class DiskExtendibleHashTable<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
 }  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bitmap_heap_scan_executor.cpp
+//
+// Identification: src/execution/bitmap_heap_scan_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/bitmap_heap_scan_executor.h"
+
+#include <optional>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/executors/index_scan_executor.h"
+#include "storage/index/b_plus_tree_index.h"
+
+namespace bustub {
+
+BitmapHeapScanExecutor::BitmapHeapScanExecutor(ExecutorContext *exec_ctx, const BitmapHeapScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void BitmapHeapScanExecutor::Init() {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  bitmap_ = ScanIndex(plan_->index_scans_.front());
+  for (size_t i = 1; i < plan_->index_scans_.size(); i++) {
+    if (plan_->op_type_ == BitmapOpType::And) {
+      if (bitmap_.GetPageCount() == 0) {
+        break;
+      }
+      bitmap_.IntersectWith(ScanIndex(plan_->index_scans_[i]));
+    } else {
+      bitmap_.UnionWith(ScanIndex(plan_->index_scans_[i]));
+    }
+  }
+  page_ids_ = bitmap_.GetPageIds();
+  page_idx_ = 0;
+  tuples_.clear();
+  tuple_idx_ = 0;
+}
+
+auto BitmapHeapScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  const auto *filter_predicate = plan_->filter_predicate_.get();
+  while (true) {
+    // each page is fetched once, for all of its tuples in the bitmap
+    while (tuple_idx_ == tuples_.size()) {
+      if (page_idx_ == page_ids_.size()) {
+        return false;
+      }
+      auto page_id = page_ids_[page_idx_++];
+      tuples_ = table_info_->table_->GetTuples(page_id, bitmap_.GetSlots(page_id));
+      tuple_idx_ = 0;
+    }
+    auto &[meta, page_tuple] = tuples_[tuple_idx_++];
+    if (meta.is_deleted_) {
+      continue;
+    }
+    *rid = page_tuple.GetRid();
+    *tuple = std::move(page_tuple);
+    if (filter_predicate == nullptr) {
+      return true;
+    }
+    auto value = filter_predicate->Evaluate(tuple, GetOutputSchema());
+    if (!value.IsNull() && value.GetAs<bool>()) {
+      return true;
+    }
+  }
+}
+
+auto BitmapHeapScanExecutor::ScanIndex(const BitmapIndexScan &index_scan) const -> RidBitmap {
+  auto *index_info = exec_ctx_->GetCatalog()->GetIndex(index_scan.index_oid_);
+  const auto *key_schema = index_info->index_->GetKeySchema();
+  RidBitmap bitmap;
+  // no key range scans the whole index
+  auto key_ranges = index_scan.key_ranges_.empty() ? std::vector<IndexKeyRange>(1) : index_scan.key_ranges_;
+
+  auto matched = VisitBPlusTreeIndex(index_info->index_.get(), [&](auto &tree) {
+    using CursorType = decltype(tree.ScanKeyRange(nullptr, true, nullptr, true));
+    typename CursorType::BatchType batch;
+    for (const auto &range : key_ranges) {
+      auto lo = IndexScanExecutor::KeyTuple({}, range.lo_, !range.lo_inclusive_, key_schema);
+      auto hi = IndexScanExecutor::KeyTuple({}, range.hi_, range.hi_inclusive_, key_schema);
+      auto cursor = tree.ScanKeyRange(lo.has_value() ? &*lo : nullptr, range.lo_inclusive_,
+                                      hi.has_value() ? &*hi : nullptr, range.hi_inclusive_);
+      while (cursor.NextBatch(&batch)) {
+        for (const auto &entry : batch) {
+          bitmap.Insert(entry.second);
+        }
+      }
+    }
+  });
+  if (matched) {
+    return bitmap;
+  }
+
+  // other indexes only answer point lookups
+  std::vector<RID> rids;
+  for (const auto &range : key_ranges) {
+    if (!range.IsPoint()) {
+      throw NotImplementedException("bitmap index scan of a key range only supports B+ tree indexes");
+    }
+    rids.clear();
+    index_info->index_->ScanKey(*IndexScanExecutor::KeyTuple({}, range.lo_, false, key_schema), &rids,
+                                exec_ctx_->GetTransaction());
+    for (const auto &rid : rids) {
+      bitmap.Insert(rid);
+    }
+  }
+  return bitmap;
+}
+
+}  // namespace bustub
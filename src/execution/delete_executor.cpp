@@ -12,6 +12,7 @@
 
 #include <memory>
 
+#include "common/exception.h"
 #include "execution/executors/delete_executor.h"
 
 namespace bustub {
@@ -22,6 +23,10 @@ DeleteExecutor::DeleteExecutor(ExecutorContext *exec_ctx, const DeletePlanNode *
 
 void DeleteExecutor::Init() {
   table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  if (table_info_->read_only_) {
+    throw NotImplementedException(
+        fmt::format("can not delete from table {}, a learned index makes it read-only", table_info_->name_));
+  }
   index_info_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
   child_executor_->Init();
 }
@@ -51,8 +56,7 @@ auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     if (0 != len) {
       int i = 0;
       while (i < len) {
-        index_info_[i]->index_->DeleteEntry(child_tuple.KeyFromTuple(table_info_->schema_, index_info_[i]->key_schema_,
-                                                                     index_info_[i]->index_->GetKeyAttrs()),
+        index_info_[i]->index_->DeleteEntry(index_info_[i]->index_->EntryFromTuple(child_tuple, table_info_->schema_),
                                             rid_t, exec_ctx_->GetTransaction());
         ++i;
       }
@@ -14,21 +14,24 @@ void FilterExecutor::Init() {
 }
 
 auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  auto filter_expr = plan_->GetPredicate();
-  std::cout << "throght filer_executer" << '\n';
-  while (true) {
-    // Get the next tuple
-    const auto status = child_executor_->Next(tuple, rid);
-
-    if (!status) {
-      return false;
-    }
+  TupleView view;
+  if (!NextView(&view, rid)) {
+    return false;
+  }
+  *tuple = view.ToTuple();
+  return true;
+}
 
-    auto value = filter_expr->Evaluate(tuple, child_executor_->GetOutputSchema());
+auto FilterExecutor::NextView(TupleView *view, RID *rid) -> bool {
+  const auto &filter_expr = plan_->GetPredicate();
+  // the tuples the filter discards are never copied
+  while (child_executor_->NextView(view, rid)) {
+    auto value = filter_expr->EvaluateView(*view, child_executor_->GetOutputSchema());
     if (!value.IsNull() && value.GetAs<bool>()) {
       return true;
     }
   }
+  return false;
 }
 
 }  // namespace bustub
@@ -10,8 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
+#include <algorithm>
 #include <memory>
+#include <optional>
+#include <vector>
 #include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
@@ -20,22 +24,167 @@ IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanP
 void IndexScanExecutor::Init() {
   index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
   table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
-  auto tree = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get());
-  itr_ = std::make_unique<BPlusTreeIndexIteratorForTwoIntegerColumn>(tree->GetBeginIterator());
+  rids_.clear();
+  tuples_.clear();
+  rid_idx_ = 0;
+
+  // the key tuples of the scanned ranges in scan order, a skip scan sets them for each value of the skipped columns
+  key_bounds_.clear();
+  if (plan_->skip_columns_ == 0) {
+    SetKeyBounds({});
+  }
+
+  // the key type of the index is picked by the catalog, bind the range cursor of whichever B+ tree it is
+  auto matched = VisitBPlusTreeIndex(index_info_->index_.get(), [this](auto &tree) {
+    using CursorType = decltype(tree.ScanKeyRange(nullptr, true, nullptr, true));
+    next_batch_ = [this, &tree, range_idx = size_t{0}, cursor = std::optional<CursorType>{},
+                   prefix = std::optional<std::vector<Value>>{},
+                   batch = typename CursorType::BatchType{}](std::vector<RID> *rids,
+                                                               std::vector<Tuple> *tuples) mutable {
+      rids->clear();
+      tuples->clear();
+      // move on to the next range when the cursor of the current one is exhausted, and a skip scan to the ranges of
+      // the next value of the skipped columns after the last range
+      while (!cursor.has_value() || !cursor->NextBatch(&batch)) {
+        if (range_idx == key_bounds_.size()) {
+          if (plan_->skip_columns_ == 0 || !NextPrefix(tree, &prefix)) {
+            return false;
+          }
+          SetKeyBounds(*prefix);
+          range_idx = 0;
+        }
+        const auto &bounds = key_bounds_[range_idx++];
+        cursor.emplace(tree.ScanKeyRange(bounds.lo_.has_value() ? &*bounds.lo_ : nullptr, bounds.lo_inclusive_,
+                                         bounds.hi_.has_value() ? &*bounds.hi_ : nullptr, bounds.hi_inclusive_,
+                                         plan_->IsReverse()));
+      }
+      for (const auto &entry : batch) {
+        rids->push_back(entry.second);
+        if (plan_->IsIndexOnly()) {
+          tuples->push_back(TupleFromEntry(tree.EntryValues(entry.first)));
+        }
+      }
+      return true;
+    };
+  });
+  if (matched) {
+    return;
+  }
+
+  // other indexes only answer point lookups
+  auto all_points = !plan_->key_ranges_.empty() &&
+                    std::all_of(plan_->key_ranges_.begin(), plan_->key_ranges_.end(),
+                                [](const IndexKeyRange &range) { return range.IsPoint(); });
+  if (!all_points || plan_->IsIndexOnly() || plan_->skip_columns_ > 0) {
+    throw NotImplementedException("index scan only supports B+ tree indexes");
+  }
+  next_batch_ = [this, range_idx = size_t{0}](std::vector<RID> *rids, std::vector<Tuple> *tuples) mutable {
+    rids->clear();
+    tuples->clear();
+    while (rids->empty() && range_idx < key_bounds_.size()) {
+      index_info_->index_->ScanKey(*key_bounds_[range_idx++].lo_, rids, exec_ctx_->GetTransaction());
+    }
+    return !rids->empty();
+  };
 }
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  // std::cout << "throught indexscan" << '\n';
-  auto tree = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get());
-  if (*itr_ != tree->GetEndIterator()) {
-    *rid = (**itr_).second;
-    *tuple = table_info_->table_->GetTuple(*rid).second;
-    ++(*itr_);
-    // std::cout << "  indexscan_up_tuple_rid: " << rid->ToString();
-    // std::cout << "  indexscan_up_tuple: " << tuple->ToString(&GetOutputSchema()) << '\n';
-    return true;
-  }
-  return false;
+  const auto *filter_predicate = plan_->filter_predicate_.get();
+  while (true) {
+    while (rid_idx_ == rids_.size()) {
+      rid_idx_ = 0;
+      if (!next_batch_(&rids_, &tuples_)) {
+        return false;
+      }
+    }
+    *rid = rids_[rid_idx_];
+    *tuple = plan_->IsIndexOnly() ? std::move(tuples_[rid_idx_]) : table_info_->table_->GetTuple(*rid).second;
+    rid_idx_++;
+    if (filter_predicate == nullptr) {
+      return true;
+    }
+    auto value = filter_predicate->Evaluate(tuple, GetOutputSchema());
+    if (!value.IsNull() && value.GetAs<bool>()) {
+      return true;
+    }
+  }
+}
+
+void IndexScanExecutor::SetKeyBounds(const std::vector<Value> &prefix) {
+  const auto *key_schema = index_info_->index_->GetKeySchema();
+  // no key range scans the whole index
+  auto key_ranges = plan_->key_ranges_.empty() ? std::vector<IndexKeyRange>(1) : plan_->key_ranges_;
+  key_bounds_.clear();
+  for (const auto &range : key_ranges) {
+    key_bounds_.push_back({KeyTuple(prefix, range.lo_, !range.lo_inclusive_, key_schema), range.lo_inclusive_,
+                           KeyTuple(prefix, range.hi_, range.hi_inclusive_, key_schema), range.hi_inclusive_});
+  }
+  if (plan_->IsReverse()) {
+    std::reverse(key_bounds_.begin(), key_bounds_.end());
+  }
+}
+
+template <typename TreeType>
+auto IndexScanExecutor::NextPrefix(TreeType &tree, std::optional<std::vector<Value>> *prefix) const -> bool {
+  const auto *key_schema = index_info_->index_->GetKeySchema();
+  // seek past every key starting with the current prefix: above the largest of them in a forward scan, below the
+  // smallest in a reverse one, whose other key columns are NULL since NULL sorts before every value
+  std::optional<Tuple> bound;
+  if (prefix->has_value() && plan_->IsReverse()) {
+    std::vector<Value> nulls;
+    for (auto i = static_cast<uint32_t>((*prefix)->size()); i < key_schema->GetColumnCount(); i++) {
+      nulls.push_back(ValueFactory::GetNullValueByType(key_schema->GetColumn(i).GetType()));
+    }
+    bound = KeyTuple(**prefix, nulls, false, key_schema);
+  } else if (prefix->has_value()) {
+    bound = KeyTuple(**prefix, {}, true, key_schema);
+  }
+  const auto *bound_ptr = bound.has_value() ? &*bound : nullptr;
+  auto cursor = plan_->IsReverse() ? tree.ScanKeyRange(nullptr, true, bound_ptr, false, true)
+                                   : tree.ScanKeyRange(bound_ptr, false, nullptr, true);
+  typename decltype(cursor)::BatchType batch;
+  do {
+    if (!cursor.NextBatch(&batch)) {
+      return false;
+    }
+  } while (batch.empty());
+  auto values = tree.EntryValues(batch.front().first);
+  values.resize(plan_->skip_columns_);
+  *prefix = std::move(values);
+  return true;
+}
+
+auto IndexScanExecutor::KeyTuple(const std::vector<Value> &prefix, const std::vector<Value> &values, bool pad_max,
+                                 const Schema *key_schema) -> std::optional<Tuple> {
+  if (prefix.empty() && values.empty()) {
+    return std::nullopt;
+  }
+  std::vector<Value> key_values;
+  key_values.reserve(key_schema->GetColumnCount());
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    auto type = key_schema->GetColumn(i).GetType();
+    if (i >= prefix.size() + values.size()) {
+      key_values.push_back(pad_max ? Type::GetMaxValue(type) : Type::GetMinValue(type));
+      continue;
+    }
+    const auto &value = i < prefix.size() ? prefix[i] : values[i - prefix.size()];
+    key_values.push_back(value.GetTypeId() == type ? value : value.CastAs(type));
+  }
+  return Tuple(key_values, key_schema);
+}
+
+auto IndexScanExecutor::TupleFromEntry(const std::vector<Value> &entry_values) const -> Tuple {
+  const auto &schema = GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (const auto &column : schema.GetColumns()) {
+    values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+  }
+  const auto &entry_attrs = index_info_->index_->GetMetadata()->GetEntryAttrs();
+  for (size_t i = 0; i < entry_values.size(); i++) {
+    values[entry_attrs[i]] = entry_values[i];
+  }
+  return {values, &schema};
 }
 
 }  // namespace bustub
@@ -11,11 +11,13 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "catalog/column.h"
 #include "catalog/schema.h"
 #include "common/config.h"
+#include "common/exception.h"
 #include "execution/executors/insert_executor.h"
 #include "storage/table/tuple.h"
 #include "type/type.h"
@@ -30,6 +32,10 @@ InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *
 
 void InsertExecutor::Init() {
   table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  if (table_info_->read_only_) {
+    throw NotImplementedException(
+        fmt::format("can not insert into table {}, a learned index makes it read-only", table_info_->name_));
+  }
   index_info_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
   child_executor_->Init();
 }
@@ -52,22 +58,28 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   }
   TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
   not_first_call_ = true;
+  // index entries are buffered and inserted in batches, so each index sorts them and descends once per leaf
+  int len = index_info_.size();
+  std::vector<std::vector<std::pair<Tuple, RID>>> index_entries(len);
+  auto flush_index_entries = [&]() {
+    for (int i = 0; i < len; ++i) {
+      index_info_[i]->index_->InsertEntries(index_entries[i], exec_ctx_->GetTransaction());
+      index_entries[i].clear();
+    }
+  };
   do {
     rid_t = table_info_->table_->InsertTuple(meta, child_tuple).value();
     // std::cout << "  insert_child_tuple_rid: " << rid_t.ToString();
     // std::cout << "  insert_child_tuple: " << child_tuple.ToString(&table_info_->schema_) << '\n';
-    int len = index_info_.size();
-    if (0 != len) {
-      int i = 0;
-      while (i < len) {
-        index_info_[i]->index_->InsertEntry(child_tuple.KeyFromTuple(table_info_->schema_, index_info_[i]->key_schema_,
-                                                                     index_info_[i]->index_->GetKeyAttrs()),
-                                            rid_t, exec_ctx_->GetTransaction());
-        ++i;
-      }
+    for (int i = 0; i < len; ++i) {
+      index_entries[i].emplace_back(index_info_[i]->index_->EntryFromTuple(child_tuple, table_info_->schema_), rid_t);
     }
     ++s;
+    if (0 == s % INDEX_INSERT_BATCH_SIZE) {
+      flush_index_entries();
+    }
   } while (child_executor_->Next(&child_tuple, &rid_t));
+  flush_index_entries();
   Schema scm{std::vector{Column{"v1", TypeId::INTEGER}}};
   std::vector<Value> values;
   values.push_back(ValueFactory::GetIntegerValue(s));
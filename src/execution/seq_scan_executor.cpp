@@ -24,26 +24,45 @@ SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNod
 void SeqScanExecutor::Init() {
   itr_ =
       std::make_unique<TableIterator>(exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->table_->MakeIterator());
+  viewed_ = false;
   exec_ctx_->GetLockManager()->LockTable(exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_SHARED, plan_->GetTableOid());
 }
 
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  // std::cout << "throught seqscan_executor" << '\n';
-  exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(),LockManager::LockMode::SHARED,plan_->GetTableOid(),itr_->GetRID());
-  while (!itr_->IsEnd() && itr_->GetTuple().first.is_deleted_) {
-    ++(*itr_);
-  exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(),LockManager::LockMode::SHARED,plan_->GetTableOid(),itr_->GetRID());
-  }
-  if (itr_->IsEnd()) {
+  TupleView view;
+  if (!NextView(&view, rid)) {
     return false;
   }
-  *tuple = std::move(itr_->GetTuple().second);
-  *rid = itr_->GetRID();
-  // std::cout << "  seqscan_up_tuple_rid: " << rid->ToString();
-  // std::cout << "  seqscan_up_tuple: " <<
-  // tuple->ToString(&exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->schema_) << '\n';
-  ++(*itr_);
+  *tuple = view.ToTuple();
   return true;
 }
 
+auto SeqScanExecutor::NextView(TupleView *view, RID *rid) -> bool {
+  // the view points into the page the iterator keeps pinned, so the iterator stays on its tuple until now
+  if (viewed_) {
+    ++(*itr_);
+    viewed_ = false;
+  }
+  const auto &predicate = plan_->filter_predicate_;
+  for (; !itr_->IsEnd(); ++(*itr_)) {
+    exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(), LockManager::LockMode::SHARED,
+                                         plan_->GetTableOid(), itr_->GetRID());
+    auto [meta, tuple_view] = itr_->GetTupleView();
+    if (meta.is_deleted_) {
+      continue;
+    }
+    if (predicate != nullptr) {
+      auto value = predicate->EvaluateView(tuple_view, GetOutputSchema());
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        continue;
+      }
+    }
+    *view = tuple_view;
+    *rid = itr_->GetRID();
+    viewed_ = true;
+    return true;
+  }
+  return false;
+}
+
 }  // namespace bustub
@@ -10,8 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "common/exception.h"
 #include "execution/executors/update_executor.h"
 
 namespace bustub {
@@ -24,6 +26,10 @@ UpdateExecutor::UpdateExecutor(ExecutorContext *exec_ctx, const UpdatePlanNode *
 
 void UpdateExecutor::Init() {
   table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
+  if (table_info_->read_only_) {
+    throw NotImplementedException(
+        fmt::format("can not update table {}, a learned index makes it read-only", table_info_->name_));
+  }
   index_info_ = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
   child_executor_->Init();
     exec_ctx_->GetLockManager()->LockTable(exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_EXCLUSIVE, plan_->TableOid());
@@ -47,7 +53,12 @@ auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
   }
   TupleMeta meta{INVALID_TXN_ID, INVALID_TXN_ID, false};
   not_first_call_ = true;
+  // read every tuple to update first, an index scan of the table would return the updated tuples again
+  std::vector<std::pair<Tuple, RID>> child_tuples;
   do {
+    child_tuples.emplace_back(std::move(child_tuple), rid_t);
+  } while (child_executor_->Next(&child_tuple, &rid_t));
+  for (auto &[child_tuple, rid_t] : child_tuples) {
 
     exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(),LockManager::LockMode::EXCLUSIVE,plan_->TableOid(),rid_t);
     auto pair = table_info_->table_->GetTuple(rid_t);
@@ -57,8 +68,7 @@ auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     if (0 != len) {
       int i = 0;
       while (i < len) {
-        index_info_[i]->index_->DeleteEntry(child_tuple.KeyFromTuple(table_info_->schema_, index_info_[i]->key_schema_,
-                                                                     index_info_[i]->index_->GetKeyAttrs()),
+        index_info_[i]->index_->DeleteEntry(index_info_[i]->index_->EntryFromTuple(child_tuple, table_info_->schema_),
                                             rid_t, exec_ctx_->GetTransaction());
         ++i;
       }
@@ -80,14 +90,13 @@ auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     if (0 != len) {
       int i = 0;
       while (i < len) {
-        index_info_[i]->index_->InsertEntry(new_tuple.KeyFromTuple(table_info_->schema_, index_info_[i]->key_schema_,
-                                                                   index_info_[i]->index_->GetKeyAttrs()),
+        index_info_[i]->index_->InsertEntry(index_info_[i]->index_->EntryFromTuple(new_tuple, table_info_->schema_),
                                             rid_t, exec_ctx_->GetTransaction());
         ++i;
       }
     }
     ++s;
-  } while (child_executor_->Next(&child_tuple, &rid_t));
+  }
   Schema scm{std::vector{Column{"v1", TypeId::INTEGER}}};
   std::vector<Value> values;
   values.push_back(ValueFactory::GetIntegerValue(s));
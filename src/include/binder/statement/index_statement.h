@@ -15,13 +15,16 @@
 #include "binder/expressions/bound_column_ref.h"
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "catalog/column.h"
+#include "catalog/index_type.h"
 
 namespace bustub {
 
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols, bool is_unique,
+                          std::vector<std::unique_ptr<BoundColumnRef>> include_cols = {},
+                          IndexType index_type = IndexType::BPlusTreeIndex);
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +35,15 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Whether the index is a unique index, an index created without UNIQUE allows duplicate keys */
+  bool is_unique_;
+
+  /** Columns stored in the index entries besides the key, given by `WITH (include = 'col, ...')` */
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols_;
+
+  /** The data structure of the index, given by `USING btree` or `USING hash` */
+  IndexType index_type_;
+
   auto ToString() const -> std::string override;
 };
 
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
@@ -104,6 +105,38 @@ class BufferPoolManager {
    */
   auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
 
+  /**
+   * @brief Whether a page is in the buffer pool, so that fetching it would not read it from disk. The answer may be
+   * stale by the time the caller acts on it.
+   *
+   * @param page_id id of the page
+   * @return true if the page is in the page table
+   */
+  auto IsPageResident(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Read a page in the buffer pool without pinning it and without taking any latch. The frame of the page is
+   * looked up in a table of hints, and read is called on its data between reading the version of the page latch and
+   * validating it, so the data read may be torn and must only be used once this returns true. A frame is write
+   * latched whenever it is given to another page, which fails the validation of a read that raced with it.
+   *
+   * @param page_id id of the page
+   * @param read called with the data of the page, at most once
+   * @return false if the page was not found without the latch, or was write latched, read is not called or its
+   * result must be dropped then
+   */
+  template <class Func>
+  auto ReadResidentOptimistic(page_id_t page_id, Func &&read) -> bool {
+    frame_id_t frame_id = frame_hints_[page_id & hint_mask_].load();
+    Page *page = pages_ + frame_id;
+    auto version = page->ReadVersion();
+    if ((version & 1) != 0 || frame_page_ids_[frame_id].load() != page_id) {
+      return false;
+    }
+    read(static_cast<const char *>(page->GetData()));
+    return page->ValidateVersion(version);
+  }
+
   /**
    * TODO(P1): Add implementation
    *
@@ -192,6 +225,30 @@ class BufferPoolManager {
   std::list<frame_id_t> free_list_;
   /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
   std::mutex latch_;
+  /**
+   * The page id held by each frame, and the frame a page id was last given, by the page id modulo a power of two above
+   * twice the pool size. Both are written under latch_ and read without it by ReadResidentOptimistic.
+   */
+  std::unique_ptr<std::atomic<page_id_t>[]> frame_page_ids_;
+  std::unique_ptr<std::atomic<frame_id_t>[]> frame_hints_;
+  size_t hint_mask_{0};
+
+  /**
+   * @brief Give a frame to page_id, with the frame write latched while replace changes its data so that optimistic
+   * readers of the page that held it fail. Caller should acquire the latch before calling this function.
+   */
+  template <class Func>
+  void SetFramePage(frame_id_t frame_id, page_id_t page_id, Func &&replace) {
+    Page *page = pages_ + frame_id;
+    page->WLatch();
+    frame_page_ids_[frame_id].store(page_id);
+    replace(page);
+    page->page_id_ = page_id;
+    page->WUnlatch();
+    if (page_id != INVALID_PAGE_ID) {
+      frame_hints_[page_id & hint_mask_].store(frame_id);
+    }
+  }
 
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -19,11 +20,15 @@
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "catalog/index_type.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/learned_index.h"
+#include "storage/index/lsm_tree_index.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -56,6 +61,8 @@ struct TableInfo {
   std::unique_ptr<TableHeap> table_;
   /** The table OID */
   const table_oid_t oid_;
+  /** Whether the table rejects inserts, updates and deletes, set by creating a learned index on it */
+  bool read_only_{false};
 };
 
 /**
@@ -70,15 +77,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure of the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +100,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure of the index, only a B+ tree index can be scanned in key order */
+  const IndexType index_type_;
 };
 
 /**
@@ -202,18 +213,7 @@ class Catalog {
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
                    HashFunction<KeyType> hash_function) -> IndexInfo * {
-    // Reject the creation request for nonexistent table
-    if (table_names_.find(table_name) == table_names_.end()) {
-      return NULL_INDEX_INFO;
-    }
-
-    // If the table exists, an entry for the table should already be present in index_names_
-    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
-
-    // Determine if the requested index already exists for this table
-    auto &table_indexes = index_names_.find(table_name)->second;
-    if (table_indexes.find(index_name) != table_indexes.end()) {
-      // The requested index already exists for this table
+    if (!CanCreateIndex(index_name, table_name)) {
       return NULL_INDEX_INFO;
     }
 
@@ -228,26 +228,97 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, the keys are sorted and loaded bottom-up
     auto *table_meta = GetTable(table_name);
+    std::vector<std::pair<KeyType, RID>> entries;
     for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
       auto [meta, tuple] = iter.GetTuple();
-      index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+      if (meta.is_deleted_) {
+        continue;
+      }
+      KeyType index_key;
+      index_key.SetFromKey(tuple.KeyFromTuple(schema, key_schema, key_attrs), index->GetKeySchema());
+      entries.emplace_back(index_key, tuple.GetRid());
     }
+    index->BulkLoad(std::move(entries), txn);
 
-    // Get the next OID for the new index
-    const auto index_oid = next_index_oid_.fetch_add(1);
-
-    // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
-    auto *tmp = index_info.get();
+    return AddIndex(key_schema, index_name, std::move(index), table_name, keysize);
+  }
 
-    // Update internal tracking
-    indexes_.emplace(index_oid, std::move(index_info));
-    table_indexes.emplace(index_name, index_oid);
+  /**
+   * Create a new index with the key type picked from the key schema: native integer keys for one INTEGER, one BIGINT
+   * or two INTEGER columns, variable-length keys for key schemas with VARCHAR columns, and the smallest fitting
+   * NormalizedKey for every other key shape. A covering index, with included columns, always gets variable-length
+   * keys, which store the included columns after the key. A hash or LSM index always gets a NormalizedKey, whose bytes
+   * are equal exactly when the keys are.
+   * @param txn The transaction in which the table is being created
+   * @param index_name The name of the new index
+   * @param table_name The name of the table
+   * @param schema The schema of the table
+   * @param key_schema The schema of the key
+   * @param key_attrs Key attributes
+   * @param is_unique Whether the index is unique, a non-unique index keeps every entry of a duplicate key
+   * @param include_attrs Table columns stored in the index entries besides the key, see IndexMetadata
+   * @param index_type The data structure of the index
+   * @return A (non-owning) pointer to the metadata of the new table
+   */
+  auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
+                   const Schema &key_schema, const std::vector<uint32_t> &key_attrs, bool is_unique = true,
+                   const std::vector<uint32_t> &include_attrs = {},
+                   IndexType index_type = IndexType::BPlusTreeIndex) -> IndexInfo * {
+    if (index_type != IndexType::BPlusTreeIndex) {
+      if (!include_attrs.empty()) {
+        throw NotImplementedException("only a B+ tree index can include columns");
+      }
+      return CreateNormalizedKeyIndex(txn, index_name, table_name, schema, key_schema, key_attrs, is_unique,
+                                      index_type);
+    }
+    if (!include_attrs.empty()) {
+      return CreateVarlenIndex(txn, index_name, table_name, schema, key_schema, key_attrs, is_unique, include_attrs);
+    }
+    const auto &columns = key_schema.GetColumns();
+    auto all_columns_are = [&columns](TypeId type) {
+      return std::all_of(columns.begin(), columns.end(), [type](const Column &col) { return col.GetType() == type; });
+    };
+    if (columns.size() == 1 && all_columns_are(TypeId::INTEGER)) {
+      return CreateIndexOfKey<Int32KeyType, Int32ComparatorType>(txn, index_name, table_name, schema, key_schema,
+                                                                 key_attrs, is_unique);
+    }
+    if (columns.size() == 1 && all_columns_are(TypeId::BIGINT)) {
+      return CreateIndexOfKey<Int64KeyType, Int64ComparatorType>(txn, index_name, table_name, schema, key_schema,
+                                                                 key_attrs, is_unique);
+    }
+    if (columns.size() == 2 && all_columns_are(TypeId::INTEGER)) {
+      return CreateIndexOfKey<TwoInt32KeyType, TwoInt32ComparatorType>(txn, index_name, table_name, schema, key_schema,
+                                                                       key_attrs, is_unique);
+    }
+    if (std::any_of(columns.begin(), columns.end(),
+                    [](const Column &col) { return col.GetType() == TypeId::VARCHAR; })) {
+      return CreateVarlenIndex(txn, index_name, table_name, schema, key_schema, key_attrs, is_unique);
+    }
 
-    return tmp;
+    // tag byte + value bytes for each column
+    size_t keysize = 0;
+    for (const auto &col : columns) {
+      keysize += 1 + col.GetLength();
+    }
+    if (keysize <= 8) {
+      return CreateIndexOfKey<NormalizedKey<8>, NormalizedComparator<8>>(txn, index_name, table_name, schema,
+                                                                         key_schema, key_attrs, is_unique);
+    }
+    if (keysize <= 16) {
+      return CreateIndexOfKey<NormalizedKey<16>, NormalizedComparator<16>>(txn, index_name, table_name, schema,
+                                                                           key_schema, key_attrs, is_unique);
+    }
+    if (keysize <= 32) {
+      return CreateIndexOfKey<NormalizedKey<32>, NormalizedComparator<32>>(txn, index_name, table_name, schema,
+                                                                           key_schema, key_attrs, is_unique);
+    }
+    if (keysize <= 64) {
+      return CreateIndexOfKey<NormalizedKey<64>, NormalizedComparator<64>>(txn, index_name, table_name, schema,
+                                                                           key_schema, key_attrs, is_unique);
+    }
+    throw NotImplementedException("index key is larger than 64 bytes");
   }
 
   /**
@@ -298,7 +369,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -342,6 +413,162 @@ class Catalog {
   }
 
  private:
+  /**
+   * Create a new index of the given key shape, the key is wrapped into a NonUniqueKey if the index is not unique so
+   * that the RID of each entry breaks ties between duplicate keys.
+   */
+  template <class KeyType, class KeyComparator>
+  auto CreateIndexOfKey(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                        const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                        bool is_unique) -> IndexInfo * {
+    if (is_unique) {
+      return CreateIndex<KeyType, RID, KeyComparator>(txn, index_name, table_name, schema, key_schema, key_attrs,
+                                                      sizeof(KeyType), HashFunction<KeyType>{});
+    }
+    using NonUniqueKeyType = NonUniqueKey<KeyType>;
+    return CreateIndex<NonUniqueKeyType, RID, NonUniqueComparator<KeyType, KeyComparator>>(
+        txn, index_name, table_name, schema, key_schema, key_attrs, sizeof(NonUniqueKeyType),
+        HashFunction<NonUniqueKeyType>{});
+  }
+
+  /**
+   * Create a new hash, LSM or learned index over the smallest NormalizedKey that fits the key schema, a VARCHAR column
+   * takes up to its length plus the tag and terminator bytes. A hash or LSM index is filled by inserting the tuples of
+   * the table one by one, a learned index is built from all of them at once and makes the table read-only.
+   */
+  auto CreateNormalizedKeyIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                                const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                                bool is_unique, IndexType index_type) -> IndexInfo * {
+    size_t keysize = 0;
+    for (const auto &col : key_schema.GetColumns()) {
+      keysize += 1 + col.GetLength() + (col.GetType() == TypeId::VARCHAR ? 2 : 0);
+    }
+    if (keysize <= 8) {
+      return CreateNormalizedKeyIndexOfKey<NormalizedKey<8>, NormalizedComparator<8>>(
+          txn, index_name, table_name, schema, key_schema, key_attrs, is_unique, index_type);
+    }
+    if (keysize <= 16) {
+      return CreateNormalizedKeyIndexOfKey<NormalizedKey<16>, NormalizedComparator<16>>(
+          txn, index_name, table_name, schema, key_schema, key_attrs, is_unique, index_type);
+    }
+    if (keysize <= 32) {
+      return CreateNormalizedKeyIndexOfKey<NormalizedKey<32>, NormalizedComparator<32>>(
+          txn, index_name, table_name, schema, key_schema, key_attrs, is_unique, index_type);
+    }
+    if (keysize <= 64) {
+      return CreateNormalizedKeyIndexOfKey<NormalizedKey<64>, NormalizedComparator<64>>(
+          txn, index_name, table_name, schema, key_schema, key_attrs, is_unique, index_type);
+    }
+    throw NotImplementedException("hash, LSM or learned index key is larger than 64 bytes");
+  }
+
+  template <class KeyType, class KeyComparator>
+  auto CreateNormalizedKeyIndexOfKey(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                                     const Schema &schema, const Schema &key_schema,
+                                     const std::vector<uint32_t> &key_attrs, bool is_unique, IndexType index_type)
+      -> IndexInfo * {
+    if (!CanCreateIndex(index_name, table_name)) {
+      return NULL_INDEX_INFO;
+    }
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto *table_meta = GetTable(table_name);
+    if (index_type == IndexType::LearnedIndex) {
+      auto index = std::make_unique<LearnedIndex<KeyType, RID, KeyComparator>>(std::move(meta), bpm_);
+      std::vector<std::pair<KeyType, RID>> entries;
+      for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+        auto [meta, tuple] = iter.GetTuple();
+        if (meta.is_deleted_) {
+          continue;
+        }
+        KeyType key;
+        key.SetFromKey(index->EntryFromTuple(tuple, schema), &key_schema);
+        entries.emplace_back(key, tuple.GetRid());
+      }
+      index->Build(std::move(entries), is_unique);
+      table_meta->read_only_ = true;
+      return AddIndex(key_schema, index_name, std::move(index), table_name, sizeof(KeyType), index_type);
+    }
+
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::LsmTreeIndex) {
+      index = std::make_unique<LsmTreeIndex<KeyType, RID, KeyComparator>>(std::move(meta), bpm_,
+                                                                          HashFunction<KeyType>{}, is_unique);
+    } else {
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, RID, KeyComparator>>(
+          std::move(meta), bpm_, HashFunction<KeyType>{}, is_unique);
+    }
+
+    // Populate the index with all tuples in table heap
+    for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+      auto [meta, tuple] = iter.GetTuple();
+      if (meta.is_deleted_) {
+        continue;
+      }
+      index->InsertEntry(index->EntryFromTuple(tuple, schema), tuple.GetRid(), txn);
+    }
+
+    return AddIndex(key_schema, index_name, std::move(index), table_name, sizeof(KeyType), index_type);
+  }
+
+  /**
+   * Create a new B+ tree index over variable-length keys, filled by inserting the tuples of the table one by one.
+   */
+  auto CreateVarlenIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                         const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                         bool is_unique, const std::vector<uint32_t> &include_attrs = {}) -> IndexInfo * {
+    if (!CanCreateIndex(index_name, table_name)) {
+      return NULL_INDEX_INFO;
+    }
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, include_attrs);
+    auto index = std::make_unique<VarlenBPlusTreeIndex>(std::move(meta), bpm_, is_unique);
+
+    // Populate the index with all tuples in table heap
+    auto *table_meta = GetTable(table_name);
+    for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+      auto [meta, tuple] = iter.GetTuple();
+      if (meta.is_deleted_) {
+        continue;
+      }
+      index->InsertEntry(index->EntryFromTuple(tuple, schema), tuple.GetRid(), txn);
+    }
+
+    return AddIndex(key_schema, index_name, std::move(index), table_name, VARLEN_KEY_MAX_SIZE);
+  }
+
+  /** @return false if the table does not exist or already has an index with the name */
+  auto CanCreateIndex(const std::string &index_name, const std::string &table_name) -> bool {
+    // Reject the creation request for nonexistent table
+    if (table_names_.find(table_name) == table_names_.end()) {
+      return false;
+    }
+
+    // If the table exists, an entry for the table should already be present in index_names_
+    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
+
+    // Determine if the requested index already exists for this table
+    auto &table_indexes = index_names_.find(table_name)->second;
+    return table_indexes.find(index_name) == table_indexes.end();
+  }
+
+  /** Register a new, populated index of the table and return its metadata */
+  auto AddIndex(const Schema &key_schema, const std::string &index_name, std::unique_ptr<Index> &&index,
+                const std::string &table_name, size_t keysize, IndexType index_type = IndexType::BPlusTreeIndex)
+      -> IndexInfo * {
+    // Get the next OID for the new index
+    const auto index_oid = next_index_oid_.fetch_add(1);
+
+    // Construct index information; IndexInfo takes ownership of the Index itself
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
+    auto *tmp = index_info.get();
+
+    // Update internal tracking
+    indexes_.emplace(index_oid, std::move(index_info));
+    index_names_.find(table_name)->second.emplace(index_name, index_oid);
+
+    return tmp;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
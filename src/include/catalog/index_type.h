@@ -0,0 +1,18 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_type.h
+//
+// Identification: src/include/catalog/index_type.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+namespace bustub {
+
+/** The data structure of an index, picked with `CREATE INDEX ... USING` */
+enum class IndexType { BPlusTreeIndex, HashTableIndex, LsmTreeIndex, LearnedIndex };
+
+}  // namespace bustub
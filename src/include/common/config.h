@@ -27,6 +27,15 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** True if B+ tree readers should read pages optimistically instead of taking read latches. */
+extern std::atomic<bool> enable_optimistic_index_read;
+
+/** True if non-unique B+ tree indexes should buffer the changes of leaves that are not in the buffer pool. */
+extern std::atomic<bool> enable_index_change_buffer;
+
+/** True if B+ trees created from now on should keep a Bloom filter of their keys to answer lookups of absent keys. */
+extern std::atomic<bool> enable_index_bloom_filter;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
@@ -36,6 +45,19 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;  // fraction of each b+ tree page filled by bulk loading
+static constexpr double UNDERFLOW_FILL_FACTOR = 0.5;  // fraction of a b+ tree page below which a delete rebalances it
+static constexpr int BULK_LOAD_MIN_RUN_SIZE = 4096;  // min entries sorted by one thread when bulk loading
+static constexpr int INDEX_INSERT_BATCH_SIZE = 1024;  // rows inserted into the indexes of a table at once
+static constexpr int VARLEN_KEY_MAX_SIZE = BUSTUB_PAGE_SIZE / 8;  // max bytes of a variable-length index key
+static constexpr int LSM_MEMTABLE_SIZE = 4096;  // entries buffered by an lsm index before they are flushed to a run
+static constexpr int LSM_MAX_IMMUTABLE_MEMTABLES = 2;  // full lsm memtables waiting for a flush before writes block
+static constexpr int LSM_COMPACTION_RATIO = 2;  // an lsm run is merged with the newer runs up to this times their size
+static constexpr int BLOOM_FILTER_BITS_PER_KEY = 10;  // bits of a bloom filter per key, about 1% false positives
+static constexpr int INDEX_BLOOM_FILTER_MIN_KEYS = 1024;  // keys the bloom filter of an empty b+ tree is sized for
+static constexpr int HYPERLOGLOG_PRECISION_BITS = 12;  // log2 of the registers of a distinct count, about 1.6% error
+static constexpr int CHANGE_BUFFER_MAX_SIZE = 4096;  // changes buffered by an index before they are merged
+static constexpr int LEARNED_INDEX_MAX_ERROR = 32;  // max distance of a learned index prediction to the key
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>  // NOLINT
 #include <shared_mutex>
 
@@ -21,18 +23,32 @@ namespace bustub {
 
 /**
  * Reader-Writer latch backed by std::mutex.
+ *
+ * The latch also keeps a version for optimistic readers: it is odd while a
+ * writer holds the latch and is bumped again when the writer releases it.
+ * An optimistic reader reads the version, reads the protected data without
+ * taking the latch, then validates that the version did not change, so it
+ * never writes to the latch.
  */
 class ReaderWriterLatch {
  public:
   /**
    * Acquire a write latch.
    */
-  void WLock() { mutex_.lock(); }
+  void WLock() {
+    mutex_.lock();
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    // the writes under the latch must not become visible before the version is odd
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /**
    * Release a write latch.
    */
-  void WUnlock() { mutex_.unlock(); }
+  void WUnlock() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    mutex_.unlock();
+  }
 
   /**
    * Acquire a read latch.
@@ -44,8 +60,24 @@ class ReaderWriterLatch {
    */
   void RUnlock() { mutex_.unlock_shared(); }
 
+  /**
+   * Start an optimistic read.
+   * @return the version to validate the read against, odd if a writer holds the latch
+   */
+  auto ReadVersion() const -> uint64_t { return version_.load(std::memory_order_acquire); }
+
+  /**
+   * Finish an optimistic read.
+   * @return true if no writer held the latch since version was read, the data read in between is consistent
+   */
+  auto Validate(uint64_t version) const -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (version & 1) == 0 && version_.load(std::memory_order_relaxed) == version;
+  }
+
  private:
   std::shared_mutex mutex_;
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <string>
 #include <vector>
@@ -40,9 +41,11 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param unique_keys whether Insert rejects a key that is already in the table with another value
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                   bool unique_keys = false);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -50,7 +53,8 @@ class DiskExtendibleHashTable {
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the pair (or the key, with unique keys) is already in the table
+   * @throws Exception if the bucket of the key is full and the directory cannot grow any further
    */
   auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
 
@@ -129,12 +133,20 @@ class DiskExtendibleHashTable {
   auto FetchDirectoryPage() -> HashTableDirectoryPage *;
 
   /**
-   * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
+   * Allocates a new, empty bucket page.
    *
-   * @param bucket_page_id the page_id to fetch
-   * @return a pointer to a bucket page
+   * @return the page_id of the bucket page
    */
-  auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
+  auto NewBucketPage() -> page_id_t;
+
+  /**
+   * Inserts a key-value pair into the bucket, under the write latch of the bucket.
+   *
+   * @return true if inserted, false if the pair (or the key, with unique keys) is already in the bucket, none if the
+   * bucket is full
+   */
+  auto InsertIntoBucket(HASH_TABLE_BUCKET_TYPE *bucket, const KeyType &key, const ValueType &value)
+      -> std::optional<bool>;
 
   /**
    * Performs insertion with an optional bucket splitting.
@@ -169,6 +181,7 @@ class DiskExtendibleHashTable {
   // Readers includes inserts and removes, writers are splits and merges
   ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
+  bool unique_keys_;
 };
 
 }  // namespace bustub
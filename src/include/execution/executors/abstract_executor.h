@@ -47,6 +47,23 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next tuple from this executor as a view, valid until the next call to Next or NextView.
+   * A scan returns a view of the tuple in its page, an executor that produces new tuples a view of the tuple Next
+   * produced. A parent that only reads the values of the tuples of its child calls NextView, so that a row is copied
+   * once it leaves the pipeline and not at every executor it goes through.
+   * @param[out] view The view of the next tuple produced by this executor
+   * @param[out] rid The next tuple RID produced by this executor
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  virtual auto NextView(TupleView *view, RID *rid) -> bool {
+    if (!Next(&view_tuple_, rid)) {
+      return false;
+    }
+    *view = view_tuple_.GetView();
+    return true;
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
@@ -56,5 +73,9 @@ class AbstractExecutor {
  protected:
   /** The executor context in which the executor runs */
   ExecutorContext *exec_ctx_;
+
+ private:
+  /** The tuple viewed by the last call to NextView, for an executor that does not read tuples in place */
+  Tuple view_tuple_;
 };
 }  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bitmap_heap_scan_executor.h
+//
+// Identification: src/include/execution/executors/bitmap_heap_scan_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/rid.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
+#include "storage/table/rid_bitmap.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * BitmapHeapScanExecutor reads the tuples whose RIDs are returned by the index scans of the plan, one page at a time
+ * in page order, see BitmapHeapScanPlanNode.
+ */
+class BitmapHeapScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new bitmap heap scan executor.
+   * @param exec_ctx the executor context
+   * @param plan the bitmap heap scan plan to be executed
+   */
+  BitmapHeapScanExecutor(ExecutorContext *exec_ctx, const BitmapHeapScanPlanNode *plan);
+
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
+
+  /** Collect the RIDs of the index scans into the bitmap */
+  void Init() override;
+
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+ private:
+  /** The RIDs of the key ranges of an index scan */
+  auto ScanIndex(const BitmapIndexScan &index_scan) const -> RidBitmap;
+
+  /** The bitmap heap scan plan node to be executed. */
+  const BitmapHeapScanPlanNode *plan_;
+
+  TableInfo *table_info_;
+
+  RidBitmap bitmap_;
+
+  /** The pages of the bitmap in page order, and the position of the next one to read */
+  std::vector<page_id_t> page_ids_;
+  size_t page_idx_{0};
+
+  /** The tuples of the bitmap in the current page, and the position of the next one to emit */
+  std::vector<std::pair<TupleMeta, Tuple>> tuples_;
+  size_t tuple_idx_{0};
+};
+}  // namespace bustub
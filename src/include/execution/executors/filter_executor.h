@@ -48,6 +48,14 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield a view of the next tuple from the filter, valid until the next call to Next or NextView.
+   * @param[out] view The view of the next tuple produced by the filter
+   * @param[out] rid The next tuple RID produced by the filter
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextView(TupleView *view, RID *rid) -> bool override;
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
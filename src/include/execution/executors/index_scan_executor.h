@@ -12,7 +12,9 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 #include "catalog/catalog.h"
@@ -45,6 +47,14 @@ class IndexScanExecutor : public AbstractExecutor {
 
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Tuple of the key schema for a range bound: the values of the skipped key columns, the values of the bound, then the
+   * smallest (or largest if pad_max) value of each remaining key column. None for an empty bound without skipped
+   * columns.
+   */
+  static auto KeyTuple(const std::vector<Value> &prefix, const std::vector<Value> &values, bool pad_max,
+                       const Schema *key_schema) -> std::optional<Tuple>;
+
  private:
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
@@ -53,6 +63,39 @@ class IndexScanExecutor : public AbstractExecutor {
 
   TableInfo *table_info_;
 
-  std::unique_ptr<BPlusTreeIndexIteratorForTwoIntegerColumn> itr_{nullptr};
+  /** Key bounds of a scanned key range, see IndexKeyRange, none for an open side */
+  struct KeyBounds {
+    std::optional<Tuple> lo_;
+    bool lo_inclusive_;
+    std::optional<Tuple> hi_;
+    bool hi_inclusive_;
+  };
+
+  /** Set key_bounds_ to the bounds of the key ranges for the values of the skipped key columns */
+  void SetKeyBounds(const std::vector<Value> &prefix);
+
+  /**
+   * Move prefix to the values of the skipped key columns of the next key in scan order with other values, starting
+   * from the first key if prefix is none. Return false if there is no such key.
+   */
+  template <typename TreeType>
+  auto NextPrefix(TreeType &tree, std::optional<std::vector<Value>> *prefix) const -> bool;
+
+  /** Output tuple of an index-only scan, the columns not stored in the index are NULL */
+  auto TupleFromEntry(const std::vector<Value> &entry_values) const -> Tuple;
+
+  /**
+   * Fetch the RIDs of the next leaf of the scanned range in scan order, and the tuples built from its entries for an
+   * index-only scan, return false at the end of the range
+   */
+  std::function<bool(std::vector<RID> *, std::vector<Tuple> *)> next_batch_;
+
+  /** RIDs (and tuples of an index-only scan) of the current leaf, and the position of the next one to emit */
+  std::vector<RID> rids_;
+  std::vector<Tuple> tuples_;
+
+  /** Key bounds of the scanned ranges in scan order */
+  std::vector<KeyBounds> key_bounds_;
+  size_t rid_idx_{0};
 };
 }  // namespace bustub
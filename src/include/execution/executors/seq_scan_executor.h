@@ -46,6 +46,14 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield a view of the next tuple from the sequential scan, in its page, valid until the next call to Next or NextView.
+   * @param[out] view The view of the next tuple produced by the sequential scan
+   * @param[out] rid The next tuple RID produced by the sequential scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  auto NextView(TupleView *view, RID *rid) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -54,5 +62,8 @@ class SeqScanExecutor : public AbstractExecutor {
   const SeqScanPlanNode *plan_;
 
   std::unique_ptr<TableIterator> itr_;
+
+  /** Whether the iterator is still on the tuple of the last view, it moves on at the next call only */
+  bool viewed_{false};
 };
 }  // namespace bustub
@@ -54,6 +54,9 @@ class AbstractExpression {
   /** @return The value obtained by evaluating the tuple with the given schema */
   virtual auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value = 0;
 
+  /** @return The value obtained by evaluating a view of a tuple with the given schema, without copying the tuple */
+  virtual auto EvaluateView(const TupleView &view, const Schema &schema) const -> Value = 0;
+
   /**
    * Returns the value obtained by evaluating a JOIN.
    * @param left_tuple The left tuple
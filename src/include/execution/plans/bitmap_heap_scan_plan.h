@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bitmap_heap_scan_plan.h
+//
+// Identification: src/include/execution/plans/bitmap_heap_scan_plan.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/util/string_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+
+namespace bustub {
+
+/** The key ranges of one index whose RIDs feed a bitmap heap scan. */
+struct BitmapIndexScan {
+  index_oid_t index_oid_;
+  /** The key ranges to scan, see IndexScanPlanNode::key_ranges_ */
+  std::vector<IndexKeyRange> key_ranges_;
+
+  auto ToString() const -> std::string {
+    return fmt::format("BitmapIndexScan {{ index_oid={}, keys=[{}] }}", index_oid_,
+                       StringUtil::Join(key_ranges_, key_ranges_.size(), ", ",
+                                        [](const IndexKeyRange &range) { return range.ToString(); }));
+  }
+};
+
+/** How the RID bitmaps of the index scans of a bitmap heap scan are combined. */
+enum class BitmapOpType { And, Or };
+
+/**
+ * BitmapHeapScanPlanNode reads the tuples of a table whose RIDs are returned by one or more index scans. The RIDs of
+ * each index scan are collected into a bitmap ordered by page, the bitmaps are intersected (And) or united (Or), and
+ * each page of the result is read once, in page order. The output tuples are in table order, not in key order.
+ */
+class BitmapHeapScanPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new bitmap heap scan plan node.
+   * @param output the output format of this scan plan node
+   * @param table_oid the identifier of the table to be scanned
+   * @param table_name the name of the table to be scanned
+   * @param index_scans the index scans returning the RIDs to read, at least one
+   * @param op_type how the RIDs of the index scans are combined
+   * @param filter_predicate the predicate the output tuples must satisfy, nullptr for none
+   */
+  BitmapHeapScanPlanNode(SchemaRef output, table_oid_t table_oid, std::string table_name,
+                         std::vector<BitmapIndexScan> index_scans, BitmapOpType op_type,
+                         AbstractExpressionRef filter_predicate = nullptr)
+      : AbstractPlanNode(std::move(output), {}),
+        table_oid_(table_oid),
+        table_name_(std::move(table_name)),
+        index_scans_(std::move(index_scans)),
+        op_type_(op_type),
+        filter_predicate_(std::move(filter_predicate)) {}
+
+  auto GetType() const -> PlanType override { return PlanType::BitmapHeapScan; }
+
+  /** @return the identifier of the table that should be scanned */
+  auto GetTableOid() const -> table_oid_t { return table_oid_; }
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(BitmapHeapScanPlanNode);
+
+  /** The table whose tuples should be scanned */
+  table_oid_t table_oid_;
+
+  /** The table name */
+  std::string table_name_;
+
+  /** The index scans returning the RIDs to read */
+  std::vector<BitmapIndexScan> index_scans_;
+
+  /** Intersect or unite the RIDs of the index scans */
+  BitmapOpType op_type_;
+
+  /** The predicate the output tuples must satisfy, including the part answered by the index scans */
+  AbstractExpressionRef filter_predicate_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override {
+    std::string filter;
+    if (filter_predicate_ != nullptr) {
+      filter = fmt::format(", filter={}", filter_predicate_);
+    }
+    std::string op;
+    if (index_scans_.size() > 1) {
+      op = op_type_ == BitmapOpType::And ? ", op=and" : ", op=or";
+    }
+    return fmt::format("BitmapHeapScan {{ table={}{}, index_scans=[{}]{} }}", table_name_, op,
+                       StringUtil::Join(index_scans_, index_scans_.size(), ", ",
+                                        [](const BitmapIndexScan &scan) { return scan.ToString(); }),
+                       filter);
+  }
+};
+
+}  // namespace bustub
@@ -12,14 +12,54 @@
 
 #pragma once
 
+#include <algorithm>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "catalog/catalog.h"
+#include "common/util/string_util.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
+
+/**
+ * A range of index keys scanned by an index scan. Each bound holds one value per key column, an empty bound leaves
+ * that side of the range open. A point lookup is the range with the same inclusive bounds.
+ *
+ * The bounds of a skip scan hold values for the key columns after the skipped ones, and may leave out trailing key
+ * columns: a bound then covers every key starting with its values.
+ */
+struct IndexKeyRange {
+  std::vector<Value> lo_;
+  bool lo_inclusive_{true};
+  std::vector<Value> hi_;
+  bool hi_inclusive_{true};
+
+  auto IsPoint() const -> bool {
+    return !lo_.empty() && lo_inclusive_ && hi_inclusive_ && lo_.size() == hi_.size() &&
+           std::equal(lo_.begin(), lo_.end(), hi_.begin(), [](const Value &lhs, const Value &rhs) {
+             return lhs.CompareEquals(rhs) == CmpBool::CmpTrue;
+           });
+  }
+
+  auto ToString() const -> std::string {
+    auto bound = [](const std::vector<Value> &values, const std::string &open) {
+      if (values.empty()) {
+        return open;
+      }
+      return StringUtil::Join(values, values.size(), ",", [](const Value &value) { return value.ToString(); });
+    };
+    if (IsPoint()) {
+      return bound(lo_, "");
+    }
+    return fmt::format("{}{}..{}{}", lo_inclusive_ ? "[" : "(", bound(lo_, "-inf"), bound(hi_, "+inf"),
+                       hi_inclusive_ ? "]" : ")");
+  }
+};
+
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
  */
@@ -29,25 +69,85 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
    * @param table_oid the identifier of table to be scanned
+   * @param reverse whether to scan the index in descending key order
+   * @param index_only whether the columns read from the scan are all stored in the index entries
+   * @param filter_predicate the predicate the output tuples must satisfy, nullptr for none
+   * @param key_ranges the key ranges scanned in key order, empty to scan the whole index
+   * @param skip_columns the number of leading key columns the key ranges skip over
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, bool reverse = false, bool index_only = false,
+                    AbstractExpressionRef filter_predicate = nullptr, std::vector<IndexKeyRange> key_ranges = {},
+                    uint32_t skip_columns = 0)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        reverse_(reverse),
+        index_only_(index_only),
+        filter_predicate_(std::move(filter_predicate)),
+        key_ranges_(std::move(key_ranges)),
+        skip_columns_(skip_columns) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
   /** @return the identifier of the table that should be scanned */
   auto GetIndexOid() const -> index_oid_t { return index_oid_; }
 
+  /** @return whether the index is scanned in descending key order */
+  auto IsReverse() const -> bool { return reverse_; }
+
+  /** @return whether the output tuples are built from the index entries without reading the table */
+  auto IsIndexOnly() const -> bool { return index_only_; }
+
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(IndexScanPlanNode);
 
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** Scan the index in descending key order. */
+  bool reverse_;
+
+  /**
+   * Build the output tuples from the index entries alone. Only the columns stored in the index (key and included
+   * columns) have their values, the other columns are NULL.
+   */
+  bool index_only_;
+
+  /** The predicate the output tuples must satisfy, including the part answered by the key ranges. */
+  AbstractExpressionRef filter_predicate_;
+
+  /** The key ranges to scan, ascending and disjoint, empty to scan the whole index. */
+  std::vector<IndexKeyRange> key_ranges_;
+
+  /**
+   * Skip scan: the key ranges bound the key columns after the first skip_columns_ ones, and are scanned once for each
+   * distinct value of those leading columns, seeking from one value to the next. Pays off when the leading columns
+   * hold few distinct values.
+   */
+  uint32_t skip_columns_;
+
+  /** The number of tuples the scan is estimated to return, from the statistics of the index, if it keeps them. */
+  std::optional<size_t> estimated_rows_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    std::string ranges;
+    if (!key_ranges_.empty()) {
+      ranges = fmt::format(", keys=[{}]", StringUtil::Join(key_ranges_, key_ranges_.size(), ", ",
+                                                            [](const IndexKeyRange &range) { return range.ToString(); }));
+    }
+    std::string filter;
+    if (filter_predicate_ != nullptr) {
+      filter = fmt::format(", filter={}", filter_predicate_);
+    }
+    std::string skip;
+    if (skip_columns_ > 0) {
+      skip = fmt::format(", skip={}", skip_columns_);
+    }
+    std::string estimate;
+    if (estimated_rows_.has_value()) {
+      estimate = fmt::format(", estimated_rows={}", *estimated_rows_);
+    }
+    return fmt::format("IndexScan {{ index_oid={}{}{}{}{}{}{} }}", index_oid_, skip, ranges, filter,
+                       reverse_ ? ", reverse=true" : "", index_only_ ? ", index_only=true" : "", estimate);
   }
 };
 
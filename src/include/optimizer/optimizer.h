@@ -78,11 +78,23 @@ class Optimizer {
   /** @brief check if the predicate is true::boolean */
   auto IsPredicateTrue(const AbstractExpressionRef &expr) -> bool;
 
+  /**
+   * @brief optimize filter over seq scan as index scan over the key ranges the filter restricts an index key to, or
+   * as bitmap heap scan over the ranges of one or more indexes
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief optimize order by as index scan if there's an index on a table
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief make the scan below a projection (and filter) an index-only scan if the index entries store every column
+   * they read, a sequential scan is only replaced by a covering index
+   */
+  auto OptimizeProjectionAsIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /** @brief check if the index can be matched */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
@@ -93,8 +105,9 @@ class Optimizer {
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
   /**
-   * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
-   * doesn't support statistics for now, so it's the only way for you to get the table size :(
+   * @brief get the estimated cardinality for a table. Useful when join reordering. The entry count of the indexes of
+   * the table is used when an index keeps statistics, see Index::GetStatistics, otherwise the size is guessed from
+   * the table name.
    *
    * @param table_name
    * @return std::optional<size_t>
@@ -3,7 +3,7 @@
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, duplicate keys are indexed as NonUniqueKey with the RID as tie-breaker
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -11,17 +11,25 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <deque>
 #include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "concurrency/transaction.h"
+#include "storage/index/bloom_filter.h"
+#include "storage/index/epoch_manager.h"
+#include "storage/index/hyper_log_log.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_header_page.h"
 #include "storage/page/b_plus_tree_internal_page.h"
@@ -52,6 +60,9 @@ class Context {
 
   std::deque<int> write_index_set_;
 
+  // The pages merged away, freed once no reader that could still reach them is left.
+  std::vector<page_id_t> deleted_pages_;
+
   // You may want to use this when getting value, but not necessary.
   std::deque<ReadPageGuard> read_set_;
 
@@ -67,9 +78,15 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  /**
+   * @param underflow_fill fraction of its max size below which Remove rebalances a page with its siblings, at most
+   * 0.5. A lower fill leaves sparser pages behind but borrows and merges less often, 0 only rebalances empty pages
+   */
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
-                     int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int internal_max_size = INTERNAL_PAGE_SIZE, double underflow_fill = UNDERFLOW_FILL_FACTOR);
+
+  ~BPlusTree() { delete filter_.load(); }
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -77,12 +94,57 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *txn = nullptr) -> bool;
 
+  // Insert a batch of key-value pairs, keys already in the tree or earlier in the batch are skipped.
+  auto InsertBatch(std::vector<MappingType> entries, Transaction *txn = nullptr) -> size_t;
+
+  // Build an empty B+ tree bottom-up from key-value pairs sorted by key, with no duplicate keys.
+  auto BulkLoad(const std::vector<MappingType> &entries, double fill_factor = BULK_LOAD_FILL_FACTOR,
+                Transaction *txn = nullptr) -> bool;
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *txn);
 
+  // Merge adjacent leaves while the merged leaf fits in fill_factor of its max size, return the leaves merged away.
+  auto Compact(double fill_factor = BULK_LOAD_FILL_FACTOR) -> size_t;
+
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
+  // Whether the leaf covering key is in the buffer pool, without reading any page from disk.
+  auto IsLeafResident(const KeyType &key) -> bool;
+
+  /*
+   * With enable_index_bloom_filter set when the tree is created, the tree keeps a Bloom filter of its keys, of the key
+   * without its RID for a non-unique key, so that GetValue of an absent key mostly returns before reading any page.
+   * Inserts add their key to the filter, removes leave it there. The filter is rebuilt from the leaves once it holds
+   * more keys than it was sized for, after BulkLoad, and by RebuildFilter, which a tree opened on existing pages calls.
+   */
+  // Rebuild the Bloom filter from the keys in the tree, sized for twice as many keys.
+  void RebuildFilter();
+
+  // Bytes of memory taken by the Bloom filter, 0 without one.
+  auto GetFilterByteCount() const -> size_t;
+
+  // False positive rate expected of the Bloom filter from the bits it has set, 1 without one.
+  auto GetFilterFalsePositiveRate() const -> double;
+
+  /*
+   * Statistics of the tree for the optimizer. The counts are kept up to date by every insert and remove, the height is
+   * read from the leftmost pages. Removes do not lower the distinct key count of a non-unique tree, which is only
+   * bounded by the entry count until RebuildFilter counts the keys again.
+   */
+  // Number of entries in the tree.
+  auto GetEntryCount() const -> size_t { return entry_count_.load(); }
+
+  // Number of leaf pages in the tree.
+  auto GetLeafPageCount() const -> size_t { return leaf_page_count_.load(); }
+
+  // Number of levels of the tree, 0 if it is empty.
+  auto GetHeight() -> size_t;
+
+  // Estimated number of distinct keys, of the key without its RID for a non-unique key.
+  auto GetDistinctKeyCount() const -> size_t;
+
   // Return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
@@ -93,6 +155,13 @@ class BPlusTree {
 
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  // Reverse index iterator, starting at the last entry
+  auto RBegin() -> INDEXITERATOR_TYPE;
+
+  // Cursor over the entries with keys between lo and hi, an empty bound leaves that side of the range open
+  auto ScanRange(const std::optional<KeyType> &lo, bool lo_inclusive, const std::optional<KeyType> &hi,
+                 bool hi_inclusive, bool reverse = false) -> INDEXRANGECURSOR_TYPE;
+
   // Print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -124,6 +193,68 @@ class BPlusTree {
 
   void PrintTree(page_id_t page_id, const BPlusTreePage *page);
 
+  // A copy of a page taken by a reader, see ReadPage.
+  struct PageCopy {
+    template <class T>
+    auto As() const -> const T * {
+      return reinterpret_cast<const T *>(data_);
+    }
+
+    alignas(std::max_align_t) char data_[BUSTUB_PAGE_SIZE];
+  };
+
+  // The body of Insert, without the Bloom filter.
+  auto InsertIntoTree(const KeyType &key, const ValueType &value, Transaction *txn) -> bool;
+
+  // The hash of key, without its RID for a non-unique key, in the Bloom filter and the distinct key count.
+  static auto KeyHash(const KeyType &key) -> uint64_t;
+
+  // Count an inserted key in the statistics.
+  void CountInsert(uint64_t hash);
+
+  // Count keys added to the Bloom filter, and rebuild it if it holds more keys than it was sized for.
+  void GrowFilter(size_t added);
+
+  // Add the hash of a key to the Bloom filter, with filter_latch_ held shared.
+  void AddToFilterLocked(uint64_t hash);
+
+  // Rebuild the Bloom filter, with filter_rebuild_latch_ held.
+  void RebuildFilterLocked();
+
+  // Copy a page for a reader, optimistically or under its read latch.
+  void ReadPage(page_id_t page_id, PageCopy *page);
+
+  // Copy the header and the entries of a page, see ReadPage.
+  static void CopyPage(const char *data, PageCopy *page);
+
+  // Descend to a leaf reading one page at a time, moving right or restarting on concurrent changes.
+  auto FindLeafRead(const std::optional<KeyType> &key, bool rightmost, PageCopy *leaf, bool before = false)
+      -> page_id_t;
+
+  // The body of Remove, the pages it merges away are left in ctx.
+  void RemoveFromTree(const KeyType &key, Context *ctx);
+
+  // Free a page unlinked from the tree once no reader that could still reach it is left.
+  void RetirePage(page_id_t page_id);
+
+  // Size below which a page underflows and is rebalanced by Remove, see underflow_fill_.
+  auto UnderflowSize(const BPlusTreePage *page) const -> int;
+
+  // Point the prev link of a leaf back to its new left neighbor after a split or merge.
+  void SetLeafPrevPageId(page_id_t page_id, page_id_t prev_page_id);
+
+  /* helper methods to build pages in bulk */
+  // Number of pages to spread count entries over, at most target entries per page and, if max_size allows it, at
+  // least min_size entries per page. Page i gets count / n entries, plus one if i < count % n.
+  static auto PageCount(size_t count, size_t target, size_t min_size, size_t max_size) -> size_t;
+
+  // Build internal levels over the (first key, page id) of each page of a level until a single root is left.
+  auto BuildInternalLevels(std::vector<std::pair<KeyType, page_id_t>> level, size_t target) -> page_id_t;
+
+  // Insert the pages split off the page below the last page of ctx's write set into it, right after the split page.
+  // Internal pages that overflow are split the same way up to the root, and the tree grows if the root overflows.
+  void InsertChildren(Context *ctx, std::vector<std::pair<KeyType, page_id_t>> children, page_id_t split_page_id);
+
   /* helper methods to inert */
   // auto InertLeafPage(InternalPage *ppage, const KeyType &key, const ValueType &value) -> bool;
   /*
@@ -141,7 +272,32 @@ class BPlusTree {
   std::vector<std::string> log;  // NOLINT
   int leaf_max_size_;
   int internal_max_size_;
+  double underflow_fill_;
   page_id_t header_page_id_;
+  // Every operation stays in an epoch while it reads pages, so that the pages merged away are only freed once no
+  // reader may still follow a page id it read before the merge.
+  mutable EpochManager epoch_manager_;
+  // Held shared by inserts while they add their key to the filter and to the tree, and exclusively by a rebuild to
+  // start recording the keys inserted while it scans the leaves, and to publish the new filter, so that the new filter
+  // holds every key of the one it replaces. Lookups do not take it.
+  std::shared_mutex filter_latch_;
+  // Held for the whole of a rebuild, one rebuild at a time.
+  std::mutex filter_rebuild_latch_;
+  // The current Bloom filter, or nullptr without one. A lookup reads it in an epoch, so a replaced filter is retired
+  // to epoch_manager_ and freed once no lookup may still read it.
+  std::atomic<BloomFilter *> filter_{nullptr};
+  // Whether a rebuild is scanning the leaves, guarded by filter_latch_, and the hashes of the keys inserted since it
+  // started, guarded by filter_pending_latch_ too since inserts add to it with filter_latch_ held shared.
+  bool filter_rebuilding_{false};
+  std::mutex filter_pending_latch_;
+  std::vector<uint64_t> filter_pending_;
+  // The keys the current filter was sized for, and the keys added to it so far.
+  std::atomic<size_t> filter_capacity_{0};
+  std::atomic<size_t> filter_keys_{0};
+  // See GetEntryCount, GetLeafPageCount and GetDistinctKeyCount, only a non-unique tree counts distinct keys.
+  std::atomic<size_t> entry_count_{0};
+  std::atomic<size_t> leaf_page_count_{0};
+  std::unique_ptr<HyperLogLog> distinct_keys_;
 };
 
 /**
@@ -13,12 +13,16 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/index.h"
+#include "storage/index/index_change_buffer.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
 
 namespace bustub {
 
@@ -31,21 +35,75 @@ class BPlusTreeIndex : public Index {
 
   auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
 
+  auto InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) -> size_t override;
+
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Build the empty index bottom-up from the keys of a populated table. The entries are sorted in parallel, and of
+   * several entries with the same key only the first one is kept, same as inserting them one by one, unless the index
+   * is non-unique.
+   * @return false if the index is not empty
+   */
+  auto BulkLoad(std::vector<std::pair<KeyType, RID>> entries, Transaction *transaction,
+                double fill_factor = BULK_LOAD_FILL_FACTOR) -> bool;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  auto GetReverseBeginIterator() -> INDEXITERATOR_TYPE;
+
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
+  /**
+   * Scan the entries with keys between lo and hi, one leaf per batch.
+   * @param lo lower bound of the range, none for a range unbounded below
+   * @param lo_inclusive whether entries equal to lo are part of the range
+   * @param hi upper bound of the range, none for a range unbounded above
+   * @param hi_inclusive whether entries equal to hi are part of the range
+   * @param reverse whether to scan from hi down to lo
+   */
+  auto ScanRange(const std::optional<KeyType> &lo, bool lo_inclusive, const std::optional<KeyType> &hi,
+                 bool hi_inclusive, bool reverse = false) -> INDEXRANGECURSOR_TYPE;
+
+  /**
+   * Scan the entries with keys between the key tuples lo and hi (of the key schema), see ScanRange. A nullptr bound
+   * leaves that side of the range open. The bounds take every entry of their key in a non-unique index into account.
+   */
+  auto ScanKeyRange(const Tuple *lo, bool lo_inclusive, const Tuple *hi, bool hi_inclusive, bool reverse = false)
+      -> INDEXRANGECURSOR_TYPE;
+
+  /** @return the values of the key columns of a key returned by ScanRange, the index has no included columns */
+  auto EntryValues(const KeyType &entry) const -> std::vector<Value>;
+
+  /** Merge the changes deferred by a non-unique index into the tree, e.g. when the index is idle. */
+  void MergeChangeBuffer();
+
+  /** @return the number of changes deferred by a non-unique index, see IndexChangeBuffer */
+  auto GetChangeBufferSize() const -> size_t { return change_buffer_.GetSize(); }
+
+  /** @return the statistics of the tree, changes deferred by the change buffer are not counted yet */
+  auto GetStatistics() -> std::optional<IndexStatistics> override;
+
  protected:
+  // index key of a tuple key, the rid is part of the key of a non-unique index
+  auto MakeKey(const Tuple &key, RID rid) const -> KeyType;
+
+  // buffer the change of a key of a non-unique index if its leaf is not resident, return false if it was not buffered
+  auto BufferChange(const KeyType &key, RID rid, bool is_insert) -> bool;
+
+  // merge the deferred changes of the keys a read between lo and hi is about to see
+  void MergeChanges(const std::optional<KeyType> &lo, const std::optional<KeyType> &hi);
+
   // comparator for key
   KeyComparator comparator_;
   // container
   std::shared_ptr<BPlusTree<KeyType, ValueType, KeyComparator>> container_;
+  // changes of a non-unique index deferred until their leaf is read
+  IndexChangeBuffer<KeyType, ValueType, KeyComparator> change_buffer_;
 };
 
 /** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
@@ -59,4 +117,74 @@ using BPlusTreeIndexIteratorForTwoIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/** Native integer key shapes picked by Catalog::CreateIndex: one INTEGER, one BIGINT or two INTEGER columns. */
+
+using Int32KeyType = IntegerKey<int32_t, 1>;
+using Int32ComparatorType = IntegerKeyComparator<int32_t, 1>;
+using BPlusTreeIndexForInt32Column = BPlusTreeIndex<Int32KeyType, RID, Int32ComparatorType>;
+using Int64KeyType = IntegerKey<int64_t, 1>;
+using Int64ComparatorType = IntegerKeyComparator<int64_t, 1>;
+using BPlusTreeIndexForInt64Column = BPlusTreeIndex<Int64KeyType, RID, Int64ComparatorType>;
+using TwoInt32KeyType = IntegerKey<int32_t, 2>;
+using TwoInt32ComparatorType = IntegerKeyComparator<int32_t, 2>;
+using BPlusTreeIndexForTwoInt32Column = BPlusTreeIndex<TwoInt32KeyType, RID, TwoInt32ComparatorType>;
+
+template <class KeyType, class KeyComparator, class Func>
+auto VisitBPlusTreeIndexAs(Index *index, Func &func) -> bool {
+  auto *tree = dynamic_cast<BPlusTreeIndex<KeyType, RID, KeyComparator> *>(index);
+  if (tree == nullptr) {
+    return false;
+  }
+  func(*tree);
+  return true;
+}
+
+template <class KeyType, class KeyComparator, class Func>
+auto VisitNonUniqueBPlusTreeIndexAs(Index *index, Func &func) -> bool {
+  return VisitBPlusTreeIndexAs<NonUniqueKey<KeyType>, NonUniqueComparator<KeyType, KeyComparator>>(index, func);
+}
+
+template <class Func>
+auto VisitNonUniqueBPlusTreeIndex(Index *index, Func &func) -> bool {
+  return VisitNonUniqueBPlusTreeIndexAs<Int32KeyType, Int32ComparatorType>(index, func) ||
+         VisitNonUniqueBPlusTreeIndexAs<Int64KeyType, Int64ComparatorType>(index, func) ||
+         VisitNonUniqueBPlusTreeIndexAs<TwoInt32KeyType, TwoInt32ComparatorType>(index, func) ||
+         VisitNonUniqueBPlusTreeIndexAs<NormalizedKey<8>, NormalizedComparator<8>>(index, func) ||
+         VisitNonUniqueBPlusTreeIndexAs<NormalizedKey<16>, NormalizedComparator<16>>(index, func) ||
+         VisitNonUniqueBPlusTreeIndexAs<NormalizedKey<32>, NormalizedComparator<32>>(index, func) ||
+         VisitNonUniqueBPlusTreeIndexAs<NormalizedKey<64>, NormalizedComparator<64>>(index, func);
+}
+
+template <class Func>
+auto VisitVarlenBPlusTreeIndex(Index *index, Func &func) -> bool {
+  auto *tree = dynamic_cast<VarlenBPlusTreeIndex *>(index);
+  if (tree == nullptr) {
+    return false;
+  }
+  func(*tree);
+  return true;
+}
+
+/**
+ * Call func with the concrete BPlusTreeIndex (or VarlenBPlusTreeIndex) behind index, so that callers which are not
+ * templated on the key type (e.g. executors) can use the typed B+ tree API.
+ * @return false if index is not a B+ tree index with RID values
+ */
+template <class Func>
+auto VisitBPlusTreeIndex(Index *index, Func &&func) -> bool {
+  return VisitBPlusTreeIndexAs<Int32KeyType, Int32ComparatorType>(index, func) ||
+         VisitBPlusTreeIndexAs<Int64KeyType, Int64ComparatorType>(index, func) ||
+         VisitBPlusTreeIndexAs<TwoInt32KeyType, TwoInt32ComparatorType>(index, func) ||
+         VisitBPlusTreeIndexAs<GenericKey<4>, GenericComparator<4>>(index, func) ||
+         VisitBPlusTreeIndexAs<GenericKey<8>, GenericComparator<8>>(index, func) ||
+         VisitBPlusTreeIndexAs<GenericKey<16>, GenericComparator<16>>(index, func) ||
+         VisitBPlusTreeIndexAs<GenericKey<32>, GenericComparator<32>>(index, func) ||
+         VisitBPlusTreeIndexAs<GenericKey<64>, GenericComparator<64>>(index, func) ||
+         VisitBPlusTreeIndexAs<NormalizedKey<8>, NormalizedComparator<8>>(index, func) ||
+         VisitBPlusTreeIndexAs<NormalizedKey<16>, NormalizedComparator<16>>(index, func) ||
+         VisitBPlusTreeIndexAs<NormalizedKey<32>, NormalizedComparator<32>>(index, func) ||
+         VisitBPlusTreeIndexAs<NormalizedKey<64>, NormalizedComparator<64>>(index, func) ||
+         VisitNonUniqueBPlusTreeIndex(index, func) || VisitVarlenBPlusTreeIndex(index, func);
+}
+
 }  // namespace bustub
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/storage/index/bloom_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * BloomFilter is a set of key hashes that answers whether it may contain a hash, with false positives but no false
+ * negatives. It is sized for a number of keys up front, each key sets a few bits picked by double hashing of its 64-bit
+ * hash, so callers hash the key once with the hash function of their index. Inserts and lookups may run concurrently.
+ */
+class BloomFilter {
+ public:
+  /**
+   * @param num_keys the number of keys the filter is sized for, more keys raise the false positive rate
+   * @param bits_per_key the bits of the filter per key
+   */
+  explicit BloomFilter(size_t num_keys, size_t bits_per_key = BLOOM_FILTER_BITS_PER_KEY);
+
+  /** Add the hash of a key to the filter. */
+  void Insert(uint64_t hash);
+
+  /** @return false if the hash was never inserted, true if it may have been */
+  auto MayContain(uint64_t hash) const -> bool;
+
+  /** @return the number of bits of the filter */
+  auto GetBitCount() const -> size_t { return num_bits_; }
+
+  /** @return the bytes of memory taken by the bits of the filter */
+  auto GetByteCount() const -> size_t { return bits_.size() * sizeof(uint64_t); }
+
+  /** @return the false positive rate expected from the fraction of bits set, which grows with every insert */
+  auto GetFalsePositiveRate() const -> double;
+
+ private:
+  static constexpr uint64_t WORD_BITS = 64;
+
+  size_t num_bits_;
+  /** The number of bits each key sets, about bits_per_key * ln 2 */
+  size_t num_probes_;
+  std::vector<std::atomic<uint64_t>> bits_;
+};
+
+}  // namespace bustub
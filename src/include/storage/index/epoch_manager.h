@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.h
+//
+// Identification: src/include/storage/index/epoch_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * EpochManager defers freeing what a writer unlinked from a structure that readers walk without latches, such as the
+ * pages of a B+ tree merged away, until no reader that could still reach it is left.
+ *
+ * A reader enters an epoch with Enter and holds the returned guard for as long as it may follow a pointer it read
+ * without a latch. A writer retires what it unlinked, tagged with the current epoch, and it is freed once every reader
+ * that entered at or before that epoch has left. A reader takes one of a fixed number of slots, so entering and
+ * leaving do not share a latch; readers that find no free slot are counted together and hold back every free.
+ */
+class EpochManager {
+ public:
+  /** Keeps its reader in the epoch it entered until dropped. A copy is one more reader in the same epoch. */
+  class Guard {
+   public:
+    Guard() = default;
+    Guard(const Guard &that);
+    Guard(Guard &&that) noexcept;
+    auto operator=(const Guard &that) -> Guard &;
+    auto operator=(Guard &&that) noexcept -> Guard &;
+    ~Guard() { Drop(); }
+
+    /** Leave the epoch, see EpochManager::Leave. */
+    void Drop();
+
+   private:
+    friend class EpochManager;
+    Guard(EpochManager *manager, uint64_t epoch, size_t slot) : manager_(manager), epoch_(epoch), slot_(slot) {}
+
+    EpochManager *manager_{nullptr};
+    uint64_t epoch_{0};
+    size_t slot_{0};
+  };
+
+  EpochManager() = default;
+  /** Free everything still retired, no reader may be left. */
+  ~EpochManager();
+
+  DISALLOW_COPY_AND_MOVE(EpochManager);
+
+  /** Enter the current epoch. */
+  auto Enter() -> Guard;
+
+  /**
+   * Retire something that is no longer reachable by readers entering from now on. free is called once every reader
+   * that entered before has left, and called again later for as long as it returns false, e.g. while a page is pinned.
+   */
+  void Retire(std::function<bool()> free);
+
+  /** @return the number of retired things not freed yet */
+  auto GetRetiredCount() const -> size_t { return retired_count_.load(); }
+
+ private:
+  static constexpr size_t SLOT_COUNT = 64;
+
+  // The epoch a reader in the slot entered, 0 for a free slot. Slots are a cache line apart.
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch_{0};
+  };
+
+  // Take a slot for a reader in epoch, the overflow count if there is none.
+  auto Join(uint64_t epoch) -> Guard;
+
+  // Give back the slot of a reader, and free what it may have held back.
+  void Leave(size_t slot);
+
+  // Free what every reader left in the slots entered after, with latch_ held.
+  void Reclaim();
+
+  std::atomic<uint64_t> epoch_{1};
+  std::array<Slot, SLOT_COUNT> slots_;
+  std::atomic<size_t> overflow_{0};
+  // Guards retired_, the epoch each retired thing was retired in and the call freeing it.
+  std::mutex latch_;
+  std::vector<std::pair<uint64_t, std::function<bool()>>> retired_;
+  std::atomic<size_t> retired_count_{0};
+};
+
+}  // namespace bustub
@@ -25,11 +25,18 @@ namespace bustub {
 
 #define HASH_TABLE_INDEX_TYPE ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * An index over a DiskExtendibleHashTable. It only answers point lookups (ScanKey), in one directory and one bucket
+ * page read, and cannot be scanned in key order.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class ExtendibleHashTableIndex : public Index {
  public:
+  /**
+   * @param is_unique whether the index is unique, a non-unique index keeps every entry of a duplicate key
+   */
   ExtendibleHashTableIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
-                           const HashFunction<KeyType> &hash_fn);
+                           const HashFunction<KeyType> &hash_fn, bool is_unique = true);
 
   ~ExtendibleHashTableIndex() override = default;
 
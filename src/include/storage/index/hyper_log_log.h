@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hyper_log_log.h
+//
+// Identification: src/include/storage/index/hyper_log_log.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * HyperLogLog estimates the number of distinct hashes added to it in a fixed amount of memory, off by about
+ * 1.04 / sqrt(2^precision_bits). The first precision_bits of a hash pick a register, which keeps the longest run of
+ * leading zeros seen in the rest of the hash. Hashes can not be removed. Adds and estimates may run concurrently.
+ */
+class HyperLogLog {
+ public:
+  /** @param precision_bits log2 of the number of registers, from 4 to 16 */
+  explicit HyperLogLog(int precision_bits = HYPERLOGLOG_PRECISION_BITS);
+
+  /** Add the hash of a key. */
+  void Add(uint64_t hash);
+
+  /** @return the estimated number of distinct hashes added */
+  auto Estimate() const -> size_t;
+
+  /** Forget every hash. */
+  void Clear();
+
+ private:
+  int precision_bits_;
+  std::vector<std::atomic<uint8_t>> registers_;
+};
+
+}  // namespace bustub
@@ -13,11 +13,13 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "fmt/format.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -43,11 +45,15 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param include_attrs The base table columns stored in the entries of a covering index besides the key
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
+                std::vector<uint32_t> key_attrs, const std::vector<uint32_t> &include_attrs = {})
       : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), include_attrs.begin(), include_attrs.end());
+    entry_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, entry_attrs_));
   }
 
   ~IndexMetadata() = default;
@@ -72,6 +78,17 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return The base table columns of an index entry: the key columns, then the included columns */
+  inline auto GetEntryAttrs() const -> const std::vector<uint32_t> & { return entry_attrs_; }
+
+  /** @return A schema object pointer that represents the columns of an index entry */
+  inline auto GetEntrySchema() const -> Schema * { return entry_schema_.get(); }
+
+  /** @return The number of columns stored in the entries of a covering index besides the key */
+  inline auto GetIncludeColumnCount() const -> std::uint32_t {
+    return static_cast<uint32_t>(entry_attrs_.size() - key_attrs_.size());
+  }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -94,6 +111,35 @@ class IndexMetadata {
   const std::vector<uint32_t> key_attrs_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
+  /** The mapping relation between entry schema and tuple schema, key columns first */
+  std::vector<uint32_t> entry_attrs_;
+  /** The schema of an index entry, the key followed by the included columns */
+  std::shared_ptr<Schema> entry_schema_;
+};
+
+/**
+ * Statistics of the entries of an index, kept up to date by the index as entries are inserted and deleted, for the
+ * optimizer to estimate how many rows a lookup returns.
+ */
+struct IndexStatistics {
+  /** The number of entries */
+  size_t entry_count_;
+  /** The number of levels of pages from the root to the leaves */
+  size_t height_;
+  /** The number of leaf pages */
+  size_t leaf_page_count_;
+  /** The estimated number of distinct keys */
+  size_t distinct_keys_;
+
+  /** @return the estimated number of entries of a key */
+  auto EntriesPerKey() const -> size_t {
+    return distinct_keys_ == 0 ? 0 : (entry_count_ + distinct_keys_ - 1) / distinct_keys_;
+  }
+
+  auto ToString() const -> std::string {
+    return fmt::format("entries={}, height={}, leaf_pages={}, distinct_keys={}", entry_count_, height_,
+                       leaf_page_count_, distinct_keys_);
+  }
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -139,6 +185,14 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /**
+   * @return The entry tuple of a table tuple, the tuple passed to InsertEntry and DeleteEntry: the key columns,
+   * followed by the included columns of a covering index
+   */
+  auto EntryFromTuple(const Tuple &tuple, const Schema &schema) const -> Tuple {
+    return tuple.KeyFromTuple(schema, *metadata_->GetEntrySchema(), metadata_->GetEntryAttrs());
+  }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -153,17 +207,32 @@ class Index {
 
   /**
    * Insert an entry into the index.
-   * @param key The index key
+   * @param key The index key, followed by the included columns of a covering index, see EntryFromTuple
    * @param rid The RID associated with the key
    * @param transaction The transaction context
    * @returns whether insertion is successful
    */
   virtual auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool = 0;
 
+  /**
+   * Insert a batch of entries into the index. Entries whose key is already in the index or earlier
+   * in the batch are skipped, same as calling InsertEntry for each of them in order.
+   * @param entries The index keys and their RIDs
+   * @param transaction The transaction context
+   * @returns the number of entries inserted
+   */
+  virtual auto InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) -> size_t {
+    size_t inserted = 0;
+    for (const auto &[key, rid] : entries) {
+      inserted += InsertEntry(key, rid, transaction) ? 1 : 0;
+    }
+    return inserted;
+  }
+
   /**
    * Delete an index entry by key.
    * @param key The index key
-   * @param rid The RID associated with the key (unused)
+   * @param rid The RID associated with the key (only used by indexes that allow duplicate keys)
    * @param transaction The transaction context
    */
   virtual void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
@@ -176,6 +245,9 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /** @return the statistics of the index, none if the index does not keep them */
+  virtual auto GetStatistics() -> std::optional<IndexStatistics> { return std::nullopt; }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
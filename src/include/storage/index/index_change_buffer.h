@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_change_buffer.h
+//
+// Identification: src/include/storage/index/index_change_buffer.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <utility>
+
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/stl_comparator_wrapper.h"
+
+namespace bustub {
+
+#define INDEX_CHANGE_BUFFER_TYPE IndexChangeBuffer<KeyType, ValueType, KeyComparator>
+
+/**
+ * Inserts and removes of a non-unique B+ tree whose leaf is not in the buffer pool, deferred so that they do not read
+ * the leaf from disk. The buffer keeps the latest change of each key, the keys of a non-unique tree carry the RID so
+ * every entry has its own key. A unique tree can not buffer inserts, they read the leaf to check the key.
+ *
+ * The changes are merged into the tree in key order, with one InsertBatch, when a reader is about to read their keys,
+ * when the buffer is full, or on MergeAll. The buffer lives in memory, the B+ tree is not recovered on restart either.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class IndexChangeBuffer {
+  using Tree = BPlusTree<KeyType, ValueType, KeyComparator>;
+
+ public:
+  explicit IndexChangeBuffer(const KeyComparator &comparator)
+      : changes_(StlComparatorWrapper<KeyType, KeyComparator>(comparator)) {}
+
+  /**
+   * Buffer an insert (or a remove) of a key if its leaf is not resident, or if the key already has a buffered change,
+   * which the change must replace.
+   * @return false if the caller must apply the change to the tree itself
+   */
+  auto Buffer(const KeyType &key, const ValueType &value, bool is_insert, bool leaf_resident) -> bool;
+
+  /** Merge the changes of the keys between lo and hi, both included, an empty bound leaves the range open. */
+  void Merge(Tree *tree, const std::optional<KeyType> &lo, const std::optional<KeyType> &hi);
+
+  /** Merge every buffered change. */
+  void MergeAll(Tree *tree) { Merge(tree, std::nullopt, std::nullopt); }
+
+  /** @return the number of buffered changes */
+  auto GetSize() const -> size_t { return size_.load(); }
+
+ private:
+  std::mutex latch_;
+  /** The latest change of each key: its value, and whether it is an insert */
+  std::map<KeyType, std::pair<ValueType, bool>, StlComparatorWrapper<KeyType, KeyComparator>> changes_;
+  /** The size of changes_, read by Merge without the latch to skip an empty buffer */
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace bustub
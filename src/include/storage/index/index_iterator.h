@@ -13,19 +13,93 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <functional>
+#include <optional>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
+#include "storage/index/epoch_manager.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
+#define INDEXRANGECURSOR_TYPE IndexRangeCursor<KeyType, ValueType, KeyComparator>
 
+/**
+ * Cursor over the entries of a B+ tree within a key range, returned by BPlusTree::ScanRange.
+ * Each call to NextBatch pins and latches one leaf, copies all of its entries within the range
+ * into the batch and unpins it again, so a range scan never reads the leaves past its end.
+ * A reverse cursor walks the leaves through their prev links and yields entries in reverse key order.
+ *
+ * No latch is held from one leaf to the next, so the cursor resumes from the fence key of the last leaf it read
+ * rather than from a position in the next one: only the entries past that key are returned from the next leaf, and
+ * a next leaf that was merged away, or that no longer covers the key after a split, is found again by a descent from
+ * the root. The cursor stays in an epoch of the tree until it reaches its end, so the leaves it may still step to are
+ * not freed.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class IndexRangeCursor {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  using BatchType = std::vector<MappingType>;
+  // Descend to the leaf covering key, or the first one of the scan for an empty key. With before set, the leaf
+  // covering the keys just below key instead. Returns INVALID_PAGE_ID for an empty tree.
+  using SeekFunction = std::function<page_id_t(const std::optional<KeyType> &key, bool before)>;
+
+  // start at the start key and stop at the bound: the lower and upper bounds of a forward cursor, the upper and lower
+  // bounds of a reverse one, none if a key is empty
+  IndexRangeCursor(std::optional<KeyType> start, bool start_inclusive, std::optional<KeyType> bound,
+                   bool bound_inclusive, bool reverse, const KeyComparator &comparator, BufferPoolManager *bpm,
+                   SeekFunction seek, EpochManager::Guard epoch);
+
+  /**
+   * Replace the content of batch by the entries of the next leaf within the range.
+   * @return false if there are no entries left, batch is empty then
+   */
+  auto NextBatch(std::vector<MappingType> *batch) -> bool;
+
+  auto IsEnd() const -> bool { return end_; }
+
+  // The page id of the leaf the last batch was read from.
+  auto GetPageId() const -> page_id_t { return leaf_page_id_; }
+
+ private:
+  // Whether leaf is still the leaf holding the entries right past from_ in scan order.
+  auto Covers(const LeafPage *leaf) const -> bool;
+
+  // Index of the first entry of leaf above key if past_key, at or above key otherwise.
+  auto IndexAfter(const LeafPage *leaf, const KeyType &key, bool past_key) const -> int;
+
+  // The entries left are past from_ in scan order, and from_ itself if from_inclusive_.
+  std::optional<KeyType> from_;
+  bool from_inclusive_;
+  std::optional<KeyType> bound_;
+  bool bound_inclusive_;
+  bool reverse_;
+  // The leaf expected to hold the next entries, INVALID_PAGE_ID to seek it from the root.
+  page_id_t page_id_{INVALID_PAGE_ID};
+  page_id_t leaf_page_id_{INVALID_PAGE_ID};
+  bool end_{false};
+  KeyComparator comparator_;
+  BufferPoolManager *bpm_;
+  SeekFunction seek_;
+  EpochManager::Guard epoch_;
+};
+
+/**
+ * Iterator over the entries of a B+ tree in key order, or in reverse key order, on top of an IndexRangeCursor: the
+ * entries of the current leaf are copied while the leaf is latched, so the iterator holds neither a latch nor a pin
+ * between two steps.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *page, int index, BufferPoolManager *bpm);
+  // the end iterator
+  IndexIterator() = default;
+  explicit IndexIterator(INDEXRANGECURSOR_TYPE cursor);
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -35,16 +109,20 @@ class IndexIterator {
   auto operator++() -> IndexIterator &;
 
   auto operator==(const IndexIterator &itr) const -> bool {
-    return static_cast<bool>(page_ == itr.page_ && index_ == itr.index_);
+    return static_cast<bool>(page_id_ == itr.page_id_ && index_ == itr.index_);
   }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { return page_ != itr.page_ || index_ != itr.index_; }
+  auto operator!=(const IndexIterator &itr) const -> bool { return page_id_ != itr.page_id_ || index_ != itr.index_; }
 
  private:
-  // add your own private member variables here
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *page_{nullptr};
+  // Load the next batch of the cursor, or turn into the end iterator.
+  void Load();
+
+  std::optional<INDEXRANGECURSOR_TYPE> cursor_;
+  // copy of the entries of the current leaf, in scan order
+  std::vector<MappingType> entries_;
+  page_id_t page_id_{INVALID_PAGE_ID};
   int index_{BUSTUB_PAGE_SIZE};
-  BufferPoolManager *bpm_{nullptr};
 };
 
 }  // namespace bustub
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// integer_key.h
+//
+// Identification: src/include/storage/index/integer_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+
+#include "storage/table/tuple.h"
+#include "type/value.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * Integer key is an index key for the common fixed-width key shapes: one or more
+ * integer columns of the same type, stored natively instead of as a serialized tuple.
+ *
+ * The NULL sentinels of BusTub integer types are the minimum values of the native
+ * types, so NULL sorts before any other value, same as GenericKey.
+ */
+template <typename IntType, size_t ColumnCount>
+class IntegerKey {
+  static_assert(std::is_same_v<IntType, int32_t> || std::is_same_v<IntType, int64_t>,
+                "integer key only supports INTEGER and BIGINT columns");
+
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    for (size_t i = 0; i < ColumnCount; i++) {
+      memcpy(&data_[i], tuple.GetData() + key_schema->GetColumn(i).GetOffset(), sizeof(IntType));
+    }
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    memset(data_, 0, sizeof(data_));
+    data_[0] = static_cast<IntType>(key);
+  }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+    if constexpr (std::is_same_v<IntType, int32_t>) {
+      return ValueFactory::GetIntegerValue(data_[column_idx]);
+    } else {
+      return ValueFactory::GetBigIntValue(data_[column_idx]);
+    }
+  }
+
+  // NOTE: for test purpose only
+  inline auto ToString() const -> int64_t { return data_[0]; }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const IntegerKey &key) -> std::ostream & {
+    os << key.ToString();
+    return os;
+  }
+
+  IntType data_[ColumnCount];
+};
+
+/**
+ * Function object returns the lexicographic order of two integer keys, used for trees
+ */
+template <typename IntType, size_t ColumnCount>
+class IntegerKeyComparator {
+ public:
+  constexpr auto operator()(const IntegerKey<IntType, ColumnCount> &lhs,
+                            const IntegerKey<IntType, ColumnCount> &rhs) const -> int {
+    for (size_t i = 0; i < ColumnCount; i++) {
+      if (lhs.data_[i] < rhs.data_[i]) {
+        return -1;
+      }
+      if (rhs.data_[i] < lhs.data_[i]) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  IntegerKeyComparator(const IntegerKeyComparator &other) = default;
+
+  // constructor, the key shape is fixed at compile time so the key schema is not needed
+  explicit IntegerKeyComparator(Schema *key_schema) {}
+};
+
+}  // namespace bustub
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// learned_index.h
+//
+// Identification: src/include/storage/index/learned_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "storage/index/index.h"
+#include "storage/index/learned_leaf_array.h"
+
+namespace bustub {
+
+#define LEARNED_INDEX_TYPE LearnedIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * A read-only index over a LearnedLeafArray, for tables loaded once and then only read: a lookup predicts the
+ * position of the key instead of descending internal pages. It is built from the table when it is created, and the
+ * catalog makes the table read-only. It only answers point lookups (ScanKey).
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LearnedIndex : public Index {
+ public:
+  LearnedIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  ~LearnedIndex() override = default;
+
+  /**
+   * Build the empty index from the keys of a table. Of several entries with the same key only the first one is kept
+   * if the index is unique.
+   */
+  void Build(std::vector<std::pair<KeyType, RID>> entries, bool is_unique);
+
+  /** @throw NotImplementedException, a learned index is read-only */
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  /** @throw NotImplementedException, a learned index is read-only */
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  /** @return the leaf array behind the index */
+  auto GetContainer() -> LearnedLeafArray<KeyType, ValueType, KeyComparator> * { return &container_; }
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  LearnedLeafArray<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// learned_leaf_array.h
+//
+// Identification: src/include/storage/index/learned_leaf_array.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define LEARNED_LEAF_ARRAY_TYPE LearnedLeafArray<KeyType, ValueType, KeyComparator>
+
+/**
+ * A read-only array of (key, value) entries sorted by key, which may repeat keys, with a learned model in place of
+ * the internal levels of a B+ tree.
+ *
+ * The entries fill leaf pages one after the other, so the position of an entry tells its page and slot. The model is
+ * piecewise linear: each segment maps the PrefixBits of a key to the position of its first entry, off by at most
+ * max_error, and the segments are fitted greedily in one pass over the entries. A lookup picks the segment of the key
+ * by binary search over the first prefix of each segment, which the array keeps in memory, predicts the position and
+ * binary searches the 2 * max_error entries around it. Keys sharing a prefix, or prefixes that are not ordered like
+ * their keys, may put an entry further away; the search then widens its bounds exponentially, so lookups are always
+ * correct and only slower.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LearnedLeafArray {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  LearnedLeafArray(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                   int max_error = LEARNED_INDEX_MAX_ERROR, int leaf_max_size = LEAF_PAGE_SIZE);
+
+  /** Write the entries, sorted by key, to the leaf pages and fit the model. The array must be empty. */
+  void Build(const std::vector<std::pair<KeyType, ValueType>> &entries);
+
+  /**
+   * Collect the values of a key.
+   * @return true if the key has at least one value
+   */
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /** @return the number of entries */
+  auto GetSize() const -> size_t { return size_; }
+
+  /** @return the number of leaf pages */
+  auto GetLeafPageCount() const -> size_t { return page_ids_.size(); }
+
+  /** @return the number of linear segments of the model */
+  auto GetSegmentCount() const -> size_t { return segments_.size(); }
+
+  /** @return the bytes of memory taken by the model and the page directory, besides the leaf pages */
+  auto GetModelBytes() const -> size_t {
+    return segments_.size() * sizeof(Segment) + page_ids_.size() * sizeof(page_id_t);
+  }
+
+ private:
+  /** A linear piece of the model, predicting first_pos_ + slope_ * (prefix - first_prefix_) */
+  struct Segment {
+    uint64_t first_prefix_;
+    double slope_;
+    size_t first_pos_;
+  };
+
+  /** Reads entries by position, keeping the last leaf read pinned */
+  class LeafReader;
+
+  /** @return the predicted position of the first entry of key */
+  auto Predict(uint64_t prefix) const -> size_t;
+
+  /** @return the position of the first entry whose key is not less than key, size_ if there is none */
+  auto LowerBound(const KeyType &key, LeafReader *reader) const -> size_t;
+
+  std::string index_name_;
+  BufferPoolManager *bpm_;
+  KeyComparator comparator_;
+  int max_error_;
+  int leaf_max_size_;
+  size_t size_{0};
+  /** The leaf pages in key order, leaf i holds the entries from position i * leaf_max_size_ */
+  std::vector<page_id_t> page_ids_;
+  /** The segments of the model, ordered by their first prefix */
+  std::vector<Segment> segments_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree.h
+//
+// Identification: src/include/storage/index/lsm_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/hash/hash_function.h"
+#include "storage/index/bloom_filter.h"
+#include "storage/page/lsm_run_page.h"
+
+namespace bustub {
+
+#define LSM_TREE_TYPE LsmTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * A write-optimized log-structured merge tree of (key, value) entries, which may repeat keys.
+ *
+ * Inserts and removes only touch the memtable, an in-memory sorted map, a remove writes a tombstone. A full memtable
+ * becomes immutable and a background thread writes it to the buffer pool as a sorted run of pages, so writes never
+ * read or rewrite index pages. The same thread then merges the newest runs into one while the next older run is at
+ * most LSM_COMPACTION_RATIO times their size, so there are about log(entries / memtable size) runs. A merge keeps the
+ * newest entry of each (key, value) and drops tombstones once it reaches the oldest run.
+ *
+ * A lookup reads the memtable, the immutable memtables and the runs from newest to oldest. Each run keeps the first
+ * key of each of its pages in memory to read only the pages of the key, and a Bloom filter of its keys to skip the
+ * run entirely when it does not hold the key.
+ *
+ * Values are ordered by RID::Get, so ValueType is RID. The runs are not persistent, like the catalog.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LsmTree {
+  using Entry = LsmEntry<KeyType, ValueType>;
+  using RunPage = LsmRunPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /**
+   * @param unique_keys whether a key holds at most one value, an insert of a key that has a value fails
+   * @param memtable_size the number of entries of the memtable that makes it full
+   */
+  LsmTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+          const HashFunction<KeyType> &hash_fn, bool unique_keys = false, size_t memtable_size = LSM_MEMTABLE_SIZE);
+
+  /** Stops the background thread, the entries of the memtables that were not flushed yet are lost */
+  ~LsmTree();
+
+  /**
+   * Insert a key-value pair, without reading the runs unless the keys are unique.
+   * @return false if the keys are unique and the key already has a value
+   */
+  auto Insert(const KeyType &key, const ValueType &value) -> bool;
+
+  /** Remove a key-value pair by writing a tombstone for it. */
+  void Remove(const KeyType &key, const ValueType &value);
+
+  /**
+   * Collect the values of a key.
+   * @return true if the key has at least one value
+   */
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /** Write the memtable to a run and wait until every immutable memtable is flushed and the runs are compacted. */
+  void Flush();
+
+  /** @return the number of sorted runs */
+  auto GetRunCount() -> size_t;
+
+ private:
+  /** Orders the entries of a memtable by key, then by value, and compares them with a bare key by key only */
+  struct EntryLess {
+    using is_transparent = void;
+    KeyComparator comparator_;
+    auto operator()(const std::pair<KeyType, ValueType> &lhs, const std::pair<KeyType, ValueType> &rhs) const -> bool {
+      auto res = comparator_(lhs.first, rhs.first);
+      return res != 0 ? res < 0 : lhs.second.Get() < rhs.second.Get();
+    }
+    auto operator()(const std::pair<KeyType, ValueType> &lhs, const KeyType &rhs) const -> bool {
+      return comparator_(lhs.first, rhs) < 0;
+    }
+    auto operator()(const KeyType &lhs, const std::pair<KeyType, ValueType> &rhs) const -> bool {
+      return comparator_(lhs, rhs.first) < 0;
+    }
+  };
+
+  /** A memtable maps each (key, value) to whether it is a tombstone */
+  using Memtable = std::map<std::pair<KeyType, ValueType>, bool, EntryLess>;
+
+  /** An immutable sorted run of entries */
+  struct Run {
+    explicit Run(size_t max_entries) : filter_(max_entries) {}
+    /** The pages of the run in order, and the key of the first entry of each */
+    std::vector<page_id_t> page_ids_;
+    std::vector<KeyType> first_keys_;
+    size_t size_{0};
+    BloomFilter filter_;
+  };
+
+  /** Reads the entries of a run in order, one page at a time */
+  class RunCursor;
+
+  /** Move the memtable to the immutable memtables if it is full, or if force and it is not empty */
+  void MaybeFreeze(std::unique_lock<std::shared_mutex> *lock, bool force = false);
+
+  /** Flush the immutable memtables and compact the runs until the tree is destroyed */
+  void BackgroundLoop();
+
+  /** Merge the newest runs when the next older one is not much larger, the latch is released while writing */
+  void CompactRuns(std::unique_lock<std::shared_mutex> *lock);
+
+  /** Write a run, next(entry) fills the next entry in order and returns false after the last one */
+  template <typename Next>
+  auto WriteRun(size_t max_entries, Next &&next) -> std::shared_ptr<const Run>;
+
+  /** Collect the values of a key from the memtables and runs, the caller holds the latch */
+  auto GetValueLocked(const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /** Visit the entries of a key in a run, in order, until visit returns true */
+  template <typename Visit>
+  auto ScanRun(const Run &run, const KeyType &key, Visit &&visit) -> bool;
+
+  std::string index_name_;
+  BufferPoolManager *bpm_;
+  KeyComparator comparator_;
+  HashFunction<KeyType> hash_fn_;
+  bool unique_keys_;
+  size_t memtable_size_;
+
+  /** Guards the memtables and the list of runs */
+  std::shared_mutex latch_;
+  /** Wakes the background thread when a memtable is frozen, and the writers and Flush when it made progress */
+  std::condition_variable_any cv_;
+  Memtable memtable_;
+  /** Full memtables waiting to be flushed, the newest first */
+  std::deque<std::shared_ptr<const Memtable>> immutables_;
+  /** The sorted runs, the newest first */
+  std::deque<std::shared_ptr<const Run>> runs_;
+  /** Whether the background thread is flushing or compacting */
+  bool background_busy_{false};
+  bool stop_{false};
+  std::thread background_thread_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree_index.h
+//
+// Identification: src/include/storage/index/lsm_tree_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "container/hash/hash_function.h"
+#include "storage/index/index.h"
+#include "storage/index/lsm_tree.h"
+
+namespace bustub {
+
+#define LSM_TREE_INDEX_TYPE LsmTreeIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * An index over an LsmTree, for tables taking a high rate of inserts: an insert or delete only writes to the memtable,
+ * and the tree writes sorted runs sequentially in the background. It only answers point lookups (ScanKey).
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LsmTreeIndex : public Index {
+ public:
+  /**
+   * @param is_unique whether the index is unique, an insert into a unique index reads the tree to check the key
+   */
+  LsmTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+               const HashFunction<KeyType> &hash_fn, bool is_unique = true);
+
+  ~LsmTreeIndex() override = default;
+
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  LsmTree<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// non_unique_key.h
+//
+// Identification: src/include/storage/index/non_unique_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Non-unique key is the index key of a secondary index that allows duplicate keys.
+ *
+ * The RID of the entry is appended to the key as a tie-breaker, so that every
+ * entry of the B+ tree still has a distinct key and entries with the same key
+ * are ordered by RID. A lookup for all entries of a key scans the range between
+ * the key with the smallest and the largest RID, see BPlusTree::GetValue.
+ */
+template <class KeyType>
+class NonUniqueKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    key_.SetFromKey(tuple, key_schema);
+    rid_ = RID();
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    key_.SetFromInteger(key);
+    rid_ = RID();
+  }
+
+  inline void SetRid(RID rid) { rid_ = rid; }
+
+  // the same key with the smallest RID, sorts before every entry of the key
+  inline auto LowerBound() const -> NonUniqueKey {
+    NonUniqueKey bound = *this;
+    bound.rid_ = RID(std::numeric_limits<int64_t>::min());
+    return bound;
+  }
+
+  // the same key with the largest RID, sorts after every entry of the key
+  inline auto UpperBound() const -> NonUniqueKey {
+    NonUniqueKey bound = *this;
+    bound.rid_ = RID(std::numeric_limits<int64_t>::max());
+    return bound;
+  }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value { return key_.ToValue(schema, column_idx); }
+
+  // NOTE: for test purpose only
+  inline auto ToString() const { return key_.ToString(); }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const NonUniqueKey &key) -> std::ostream & {
+    os << key.key_;
+    return os;
+  }
+
+  KeyType key_;
+  RID rid_;
+};
+
+/**
+ * Function object returns the order of two non-unique keys: by key first, then by RID, used for trees
+ */
+template <class KeyType, class KeyComparator>
+class NonUniqueComparator {
+ public:
+  inline auto operator()(const NonUniqueKey<KeyType> &lhs, const NonUniqueKey<KeyType> &rhs) const -> int {
+    int res = comparator_(lhs.key_, rhs.key_);
+    if (res != 0) {
+      return res;
+    }
+    auto lhs_rid = lhs.rid_.Get();
+    auto rhs_rid = rhs.rid_.Get();
+    return lhs_rid < rhs_rid ? -1 : (rhs_rid < lhs_rid ? 1 : 0);
+  }
+
+  NonUniqueComparator(const NonUniqueComparator &other) = default;
+
+  // constructor
+  explicit NonUniqueComparator(Schema *key_schema) : comparator_(key_schema) {}
+
+ private:
+  KeyComparator comparator_;
+};
+
+/** True if KeyType is a non-unique key, i.e. entries carry their RID in the key */
+template <class KeyType>
+struct IsNonUniqueKey : std::false_type {};
+
+template <class KeyType>
+struct IsNonUniqueKey<NonUniqueKey<KeyType>> : std::true_type {};
+
+template <class KeyType>
+inline constexpr bool IS_NON_UNIQUE_KEY = IsNonUniqueKey<KeyType>::value;
+
+}  // namespace bustub
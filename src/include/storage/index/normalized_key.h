@@ -0,0 +1,242 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key.h
+//
+// Identification: src/include/storage/index/normalized_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include "common/exception.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * Order-preserving encoding of index key columns into bytes, so that comparing
+ * two encoded keys is a single memcmp. Shared by the fixed-size NormalizedKey
+ * and the variable-length VarlenKey, see NormalizedKey for the encoding.
+ */
+class NormalizedKeyCodec {
+ public:
+  // append the encoding of value to data at offset, throws if it does not fit in capacity bytes
+  static inline void EncodeValue(const Value &value, char *data, size_t capacity, size_t *offset) {
+    if (value.IsNull()) {
+      AppendByte(0x00, data, capacity, offset);
+      return;
+    }
+    AppendByte(0x01, data, capacity, offset);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendBigEndian(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, 1, data, capacity, offset);
+        break;
+      case TypeId::SMALLINT:
+        AppendBigEndian(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, 2, data, capacity, offset);
+        break;
+      case TypeId::INTEGER:
+        AppendBigEndian(static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4, data, capacity, offset);
+        break;
+      case TypeId::BIGINT:
+        AppendBigEndian(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (1ULL << 63), 8, data, capacity, offset);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(value.GetAs<uint64_t>(), 8, data, capacity, offset);
+        break;
+      case TypeId::DECIMAL: {
+        auto d = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        bits = (bits & (1ULL << 63)) != 0 ? ~bits : bits ^ (1ULL << 63);
+        AppendBigEndian(bits, 8, data, capacity, offset);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        const char *str = value.GetData();
+        uint32_t len = value.GetLength() - 1;
+        for (uint32_t i = 0; i < len; i++) {
+          AppendByte(static_cast<uint8_t>(str[i]), data, capacity, offset);
+          if (str[i] == '\0') {
+            AppendByte(0xFF, data, capacity, offset);
+          }
+        }
+        AppendByte(0x00, data, capacity, offset);
+        AppendByte(0x00, data, capacity, offset);
+        break;
+      }
+      default:
+        throw NotImplementedException("unsupported type in normalized key");
+    }
+  }
+
+  // decode the value of the given type at offset of the size bytes of data
+  static inline auto DecodeValue(TypeId type, const char *data, size_t size, size_t *offset) -> Value {
+    if (data[(*offset)++] == 0x00) {
+      return ValueFactory::GetNullValueByType(type);
+    }
+    switch (type) {
+      case TypeId::BOOLEAN:
+        return ValueFactory::GetBooleanValue(static_cast<int8_t>(ReadBigEndian(1, data, offset) ^ 0x80U));
+      case TypeId::TINYINT:
+        return ValueFactory::GetTinyIntValue(static_cast<int8_t>(ReadBigEndian(1, data, offset) ^ 0x80U));
+      case TypeId::SMALLINT:
+        return ValueFactory::GetSmallIntValue(static_cast<int16_t>(ReadBigEndian(2, data, offset) ^ 0x8000U));
+      case TypeId::INTEGER:
+        return ValueFactory::GetIntegerValue(static_cast<int32_t>(ReadBigEndian(4, data, offset) ^ 0x80000000U));
+      case TypeId::BIGINT:
+        return ValueFactory::GetBigIntValue(static_cast<int64_t>(ReadBigEndian(8, data, offset) ^ (1ULL << 63)));
+      case TypeId::TIMESTAMP:
+        return ValueFactory::GetTimestampValue(static_cast<int64_t>(ReadBigEndian(8, data, offset)));
+      case TypeId::DECIMAL: {
+        auto bits = ReadBigEndian(8, data, offset);
+        bits = (bits & (1ULL << 63)) != 0 ? bits ^ (1ULL << 63) : ~bits;
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        return ValueFactory::GetDecimalValue(d);
+      }
+      case TypeId::VARCHAR: {
+        std::string str;
+        while (*offset + 1 < size) {
+          char c = data[(*offset)++];
+          if (c == '\0') {
+            if (data[(*offset)++] == '\0') {
+              break;
+            }
+            // escaped 0x00
+          }
+          str.push_back(c);
+        }
+        return ValueFactory::GetVarcharValue(str);
+      }
+      default:
+        throw NotImplementedException("unsupported type in normalized key");
+    }
+  }
+
+ private:
+  static inline void Append(const void *src, size_t len, char *data, size_t capacity, size_t *offset) {
+    if (*offset + len > capacity) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "index key does not fit in the normalized key");
+    }
+    memcpy(data + *offset, src, len);
+    *offset += len;
+  }
+
+  static inline void AppendByte(uint8_t byte, char *data, size_t capacity, size_t *offset) {
+    Append(&byte, 1, data, capacity, offset);
+  }
+
+  static inline void AppendBigEndian(uint64_t bits, size_t width, char *data, size_t capacity, size_t *offset) {
+    for (size_t i = 0; i < width; i++) {
+      AppendByte(static_cast<uint8_t>(bits >> (8 * (width - 1 - i))), data, capacity, offset);
+    }
+  }
+
+  static inline auto ReadBigEndian(size_t width, const char *data, size_t *offset) -> uint64_t {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < width; i++) {
+      bits = (bits << 8) | static_cast<uint8_t>(data[*offset + i]);
+    }
+    *offset += width;
+    return bits;
+  }
+};
+
+/**
+ * Normalized key is a memcmp-comparable index key.
+ *
+ * Instead of keeping the serialized tuple like GenericKey, SetFromKey encodes
+ * every key column into an order-preserving byte string, so that comparing two
+ * keys is a single memcmp and does not need to deserialize any Value.
+ *
+ * Column encoding (columns are concatenated in key schema order):
+ *  - every column starts with a 1-byte tag: 0x00 for NULL (NULL sorts first), 0x01 otherwise
+ *  - BOOLEAN / TINYINT / SMALLINT / INTEGER / BIGINT: big-endian with the sign bit flipped
+ *  - TIMESTAMP: big-endian
+ *  - DECIMAL: big-endian IEEE 754, sign bit flipped for positive values, all bits flipped for negative values
+ *  - VARCHAR: 0x00 is escaped as 0x00 0xFF, the string is terminated by 0x00 0x00
+ * The unused tail of the key is zero-filled.
+ */
+template <size_t KeySize>
+class NormalizedKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    memset(data_, 0, KeySize);
+    size_t offset = 0;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      NormalizedKeyCodec::EncodeValue(tuple.GetValue(key_schema, i), data_, KeySize, &offset);
+    }
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    memset(data_, 0, KeySize);
+    size_t offset = 0;
+    NormalizedKeyCodec::EncodeValue(ValueFactory::GetBigIntValue(key), data_, KeySize, &offset);
+  }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < column_idx; i++) {
+      NormalizedKeyCodec::DecodeValue(schema->GetColumn(i).GetType(), data_, KeySize, &offset);
+    }
+    return NormalizedKeyCodec::DecodeValue(schema->GetColumn(column_idx).GetType(), data_, KeySize, &offset);
+  }
+
+  // the 8 bytes after the tag of the first column as a big-endian integer, zero-filled past the end of the key. Keys
+  // with the same first tag are ordered like their prefixes, which the model of a learned index is fitted on.
+  inline auto PrefixBits() const -> uint64_t {
+    uint64_t bits = 0;
+    for (size_t i = 1; i <= sizeof(uint64_t); i++) {
+      bits = (bits << 8) | (i < KeySize ? static_cast<uint8_t>(data_[i]) : 0);
+    }
+    return bits;
+  }
+
+  // NOTE: for test purpose only
+  // decode the first column as a BIGINT, see SetFromInteger
+  inline auto ToString() const -> int64_t {
+    size_t offset = 0;
+    Value value = NormalizedKeyCodec::DecodeValue(TypeId::BIGINT, data_, KeySize, &offset);
+    return value.IsNull() ? 0 : value.GetAs<int64_t>();
+  }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const NormalizedKey &key) -> std::ostream & {
+    os << key.ToString();
+    return os;
+  }
+
+  // actual location of data, extends past the end.
+  char data_[KeySize];
+};
+
+/**
+ * Function object returns the memcmp order of two normalized keys, used for trees
+ */
+template <size_t KeySize>
+class NormalizedComparator {
+ public:
+  inline auto operator()(const NormalizedKey<KeySize> &lhs, const NormalizedKey<KeySize> &rhs) const -> int {
+    auto res = memcmp(lhs.data_, rhs.data_, KeySize);
+    return res < 0 ? -1 : (res > 0 ? 1 : 0);
+  }
+
+  NormalizedComparator(const NormalizedComparator &other) = default;
+
+  // constructor, the key schema is only kept to share the constructor shape of GenericComparator
+  explicit NormalizedComparator(Schema *key_schema) : key_schema_(key_schema) {}
+
+ private:
+  [[maybe_unused]] Schema *key_schema_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,132 @@
+/**
+ * varlen_b_plus_tree.h
+ *
+ * B+ tree over variable-length keys (VarlenKey), for key schemas with VARCHAR
+ * columns that do not fit the fixed-size keys of BPlusTree.
+ * (1) Keys are unique, a non-unique index appends the RID to the key
+ * (2) Pages are slotted pages (BPlusTreeSlottedPage) split by bytes instead of entry count
+ * (3) Keys of a page share a prefix stored once per page, separators pushed up
+ *     by a leaf split are truncated to the shortest byte string that separates the two leaves
+ * (4) Remove does not merge pages, empty leaves stay linked in the tree
+ * (5) A leaf entry may carry a payload after its key, e.g. the included columns
+ *     of a covering index. Keys must be prefix-free, as VarlenKey encodings are,
+ *     so that the key identifies the entry whatever its payload
+ */
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "concurrency/transaction.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/varlen_key.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+class VarlenBPlusTree;
+
+/**
+ * Cursor over the entries of a VarlenBPlusTree within a key range, see IndexRangeCursor.
+ *
+ * Each call to NextBatch latches one leaf and copies its entries within the range. The cursor keeps
+ * the last key it returned instead of a position, so entries inserted or removed by concurrent
+ * writers between batches never make it return an entry twice.
+ */
+class VarlenRangeCursor {
+ public:
+  using BatchType = std::vector<std::pair<VarlenKey, RID>>;
+
+  VarlenRangeCursor(VarlenBPlusTree *tree, std::optional<std::string> lo, bool lo_inclusive,
+                    std::optional<std::string> hi, bool hi_inclusive, bool reverse);
+
+  /**
+   * Fill batch with the next entries of the range, in key order (or reverse key order). The keys include
+   * the payload of the entries.
+   * @return false if the range is exhausted, batch is empty then
+   */
+  auto NextBatch(BatchType *batch) -> bool;
+
+  auto IsEnd() const -> bool { return done_; }
+
+ private:
+  auto NextForward(BatchType *batch) -> bool;
+  auto NextReverse(BatchType *batch) -> bool;
+  void Emit(const std::string &key, int64_t value, BatchType *batch) const;
+
+  VarlenBPlusTree *tree_;
+  // remaining part of the range, the bound on the side the scan starts from moves past each batch
+  std::optional<std::string> lo_;
+  bool lo_inclusive_;
+  std::optional<std::string> hi_;
+  bool hi_inclusive_;
+  bool reverse_;
+  // next leaf of a forward scan, INVALID_PAGE_ID to descend from the root
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  bool done_{false};
+};
+
+// Main class providing the API for the variable-length key B+ tree.
+class VarlenBPlusTree {
+  friend class VarlenRangeCursor;
+
+ public:
+  explicit VarlenBPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager);
+
+  // Returns true if this B+ tree has no keys and values.
+  auto IsEmpty() const -> bool;
+
+  // Insert a key-value pair into this B+ tree, entries longer than SLOTTED_PAGE_MAX_KEY_SIZE are rejected.
+  auto Insert(const VarlenKey &key, const RID &value, Transaction *txn = nullptr, std::string_view payload = {})
+      -> bool;
+
+  // Remove a key and its value from this B+ tree.
+  void Remove(const VarlenKey &key, Transaction *txn);
+
+  // Return the value associated with a given key
+  auto GetValue(const VarlenKey &key, std::vector<RID> *result, Transaction *txn = nullptr) -> bool;
+
+  // Return the page id of the root node
+  auto GetRootPageId() -> page_id_t;
+
+  // Return the number of levels of the tree, 0 if it is empty
+  auto GetHeight() -> int;
+
+  /**
+   * Cursor over the entries between lo and hi, an empty bound leaves that side of the range open. The bounds are
+   * compared with the key and payload of the entries.
+   */
+  auto ScanRange(const std::optional<VarlenKey> &lo, bool lo_inclusive, const std::optional<VarlenKey> &hi,
+                 bool hi_inclusive, bool reverse = false) -> VarlenRangeCursor;
+
+ private:
+  // which leaf FindLeafRead descends to
+  enum class SearchMode { KEY, BELOW, RIGHTMOST };
+
+  /**
+   * Descend to a leaf with read latch coupling: the leaf that holds key (KEY), the leaf that holds the
+   * largest key smaller than key (BELOW) or the last leaf (RIGHTMOST).
+   * @param low_key set to the smallest key the leaf may hold, none for the first leaf
+   * @return the read guard of the leaf, none if the tree is empty
+   */
+  auto FindLeafRead(std::string_view key, SearchMode mode, std::optional<std::string> *low_key = nullptr)
+      -> std::optional<ReadPageGuard>;
+
+  // Split the entries of an overflowing page at the entry that balances the bytes of both halves.
+  static auto SplitIndex(const std::vector<std::pair<std::string, int64_t>> &entries, bool leaf) -> size_t;
+
+  // Insert the separator and page id of the page split off the last page of ctx's write set into its parent,
+  // splitting internal pages up to the root, and growing the tree if the root splits.
+  void InsertIntoParent(Context *ctx, std::string separator, page_id_t page_id);
+
+  // member variable
+  std::string index_name_;
+  BufferPoolManager *bpm_;
+  page_id_t header_page_id_;
+};
+
+}  // namespace bustub
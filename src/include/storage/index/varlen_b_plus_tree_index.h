@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "storage/index/index.h"
+#include "storage/index/varlen_b_plus_tree.h"
+
+namespace bustub {
+
+/**
+ * B+ tree index over variable-length keys, picked by Catalog::CreateIndex for key schemas with VARCHAR columns.
+ * A non-unique index appends the RID of each entry to its key, see VarlenKey::AppendRid. The included columns of
+ * a covering index are stored after the key (and RID) of each entry, see IndexMetadata.
+ */
+class VarlenBPlusTreeIndex : public Index {
+ public:
+  VarlenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                       bool is_unique = true);
+
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  /**
+   * Scan the entries with keys between lo and hi, one leaf per batch, see BPlusTreeIndex::ScanRange.
+   * The keys returned are whole entries, decode them with EntryValues.
+   */
+  auto ScanRange(const std::optional<VarlenKey> &lo, bool lo_inclusive, const std::optional<VarlenKey> &hi,
+                 bool hi_inclusive, bool reverse = false) -> VarlenRangeCursor;
+
+  /** Scan the entries with keys between the key tuples lo and hi, see BPlusTreeIndex::ScanKeyRange. */
+  auto ScanKeyRange(const Tuple *lo, bool lo_inclusive, const Tuple *hi, bool hi_inclusive, bool reverse = false)
+      -> VarlenRangeCursor;
+
+  /** @return the values of the entry schema columns of an entry returned by ScanRange */
+  auto EntryValues(const VarlenKey &entry) const -> std::vector<Value>;
+
+  auto IsUnique() const -> bool { return is_unique_; }
+
+ protected:
+  // index key of a tuple key, the rid is part of the key of a non-unique index
+  auto MakeKey(const Tuple &key, RID rid) const -> VarlenKey;
+
+  bool is_unique_;
+  // container
+  std::shared_ptr<VarlenBPlusTree> container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_key.h
+//
+// Identification: src/include/storage/index/varlen_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/index/normalized_key.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * Varlen key is the index key of VarlenBPlusTree, used for key schemas with VARCHAR columns.
+ *
+ * The key columns are encoded like NormalizedKey, but the key only takes as many
+ * bytes as the encoding needs instead of a fixed size, up to VARLEN_KEY_MAX_SIZE.
+ * Keys are compared by std::string::compare, which is memcmp order. The encoding
+ * of a whole key schema is prefix-free: no key is a prefix of another key.
+ */
+class VarlenKey {
+ public:
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
+    char buf[VARLEN_KEY_MAX_SIZE];
+    size_t offset = 0;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      NormalizedKeyCodec::EncodeValue(tuple.GetValue(key_schema, i), buf, VARLEN_KEY_MAX_SIZE, &offset);
+    }
+    data_.assign(buf, offset);
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    char buf[VARLEN_KEY_MAX_SIZE];
+    size_t offset = 0;
+    NormalizedKeyCodec::EncodeValue(ValueFactory::GetBigIntValue(key), buf, VARLEN_KEY_MAX_SIZE, &offset);
+    data_.assign(buf, offset);
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromString(const std::string &key) {
+    char buf[VARLEN_KEY_MAX_SIZE];
+    size_t offset = 0;
+    NormalizedKeyCodec::EncodeValue(ValueFactory::GetVarcharValue(key), buf, VARLEN_KEY_MAX_SIZE, &offset);
+    data_.assign(buf, offset);
+  }
+
+  /**
+   * Append rid to the key, the key of an entry of a non-unique index. Big-endian with the sign bit flipped, so keys
+   * with the same columns are ordered by RID.
+   */
+  inline void AppendRid(RID rid) {
+    auto bits = static_cast<uint64_t>(rid.Get()) ^ (1ULL << 63);
+    for (int i = 7; i >= 0; i--) {
+      data_.push_back(static_cast<char>(bits >> (8 * i)));
+    }
+  }
+
+  // upper bound of the keys of a non-unique index with the same columns as this key, see AppendRid
+  inline void AppendMaxRid() { data_.append(RID_SIZE, '\xff'); }
+
+  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < column_idx; i++) {
+      NormalizedKeyCodec::DecodeValue(schema->GetColumn(i).GetType(), data_.data(), data_.size(), &offset);
+    }
+    return NormalizedKeyCodec::DecodeValue(schema->GetColumn(column_idx).GetType(), data_.data(), data_.size(),
+                                           &offset);
+  }
+
+  // NOTE: for test purpose only
+  // decode the first column as a BIGINT, see SetFromInteger
+  inline auto ToString() const -> int64_t {
+    size_t offset = 0;
+    Value value = NormalizedKeyCodec::DecodeValue(TypeId::BIGINT, data_.data(), data_.size(), &offset);
+    return value.IsNull() ? 0 : value.GetAs<int64_t>();
+  }
+
+  // NOTE: for test purpose only
+  friend auto operator<<(std::ostream &os, const VarlenKey &key) -> std::ostream & {
+    os << key.ToString();
+    return os;
+  }
+
+  /** bytes appended by AppendRid */
+  static constexpr size_t RID_SIZE = sizeof(int64_t);
+
+  std::string data_;
+};
+
+}  // namespace bustub
@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <string>
 
@@ -18,7 +19,8 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 12
+// the header including the low and high fence keys, which depend on the key size
+#define INTERNAL_PAGE_HEADER_SIZE sizeof(B_PLUS_TREE_INTERNAL_PAGE_TYPE)
 #define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
@@ -32,6 +34,18 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * Header format (size in byte, 20 bytes in total, followed by the fence keys):
+ *  ---------------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) | FenceFlags (4)
+ *  ---------------------------------------------------------------------------
+ *  -----------------------------------------------
+ * |  LowKey | HighKey
+ *  -----------------------------------------------
+ *
+ * Like leaf pages, every internal page links to its right sibling and keeps
+ * the fence keys LowKey <= K < HighKey of its subtree, so that readers can
+ * recover from a split they raced with by moving right.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -63,6 +77,14 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   // set value
   void SetValueAt(int index, const ValueType &value);
 
+  // right sibling link and fence keys
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetLowKey() const -> std::optional<KeyType>;
+  void SetLowKey(const std::optional<KeyType> &key);
+  auto GetHighKey() const -> std::optional<KeyType>;
+  void SetHighKey(const std::optional<KeyType> &key);
+
   /**
    *
    * @param value the value to search for
@@ -76,6 +98,16 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   auto ValueAt(int index) const -> ValueType;
 
+  /**
+   * Binary search for the child that covers the input key. The first key is
+   * invalid, so the search runs over KeyAt(1) .. KeyAt(size - 1).
+   * @param key the key to search for
+   * @param comparator the key comparator
+   * @return the smallest index i in [1, size] such that key < KeyAt(i) (size if there is none),
+   * so the covering child is ValueAt(i - 1)
+   */
+  auto UpperBound(const KeyType &key, const KeyComparator &comparator) const -> int;
+
   // insert key and value
   auto Insert(int index, const KeyType &key, const ValueType &value) -> int;
   auto SpInsert(BPlusTreeInternalPage &page, int index, const KeyType &key, const ValueType &value, KeyType &upkey)
@@ -109,6 +141,10 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
+  page_id_t next_page_id_;
+  uint32_t fence_flags_;
+  KeyType low_key_;
+  KeyType high_key_;
   // Flexible array member for page data.
   MappingType array_[0];
 };
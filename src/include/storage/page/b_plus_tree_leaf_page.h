@@ -11,6 +11,7 @@
 #pragma once
 
 #include <string>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -19,7 +20,8 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 16
+// the header including the low and high fence keys, which depend on the key size
+#define LEAF_PAGE_HEADER_SIZE sizeof(B_PLUS_TREE_LEAF_PAGE_TYPE)
 #define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
 
 /**
@@ -32,13 +34,21 @@ namespace bustub {
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 16 bytes in total):
+ *  Header format (size in byte, 24 bytes in total, followed by the fence keys):
  *  ---------------------------------------------------------------------
  * | PageType (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
  *  -----------------------------------------------
- * |  NextPageId (4)
+ * |  NextPageId (4) | PrevPageId (4) | FenceFlags (4)
  *  -----------------------------------------------
+ *  -----------------------------------------------
+ * |  LowKey | HighKey
+ *  -----------------------------------------------
+ *
+ * The fence keys bound the keys the page may hold: LowKey <= K < HighKey. A
+ * missing low (high) key means the page is the leftmost (rightmost) of its
+ * level. Readers latch one page at a time, the fences tell them whether the
+ * page they reached still covers their key, see BPlusTree::FindLeafRead.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -57,10 +67,18 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
+  auto GetLowKey() const -> std::optional<KeyType>;
+  void SetLowKey(const std::optional<KeyType> &key);
+  auto GetHighKey() const -> std::optional<KeyType>;
+  void SetHighKey(const std::optional<KeyType> &key);
   auto KeyAt(int index) const -> KeyType;
   auto ValueAt(int index) const -> ValueType;
   auto SetKeyAt(int index, const KeyType &key) -> void;
   auto SetValueAt(int index, const ValueType &value) -> void;
+  // binary search, return the first index whose key is not less than the input key (size if there is none)
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
   auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> int;
   auto SpInsert(BPlusTreeLeafPage &page, int index, const KeyType &key, const ValueType &value) -> int;
   auto Remove(const KeyType &key, const KeyComparator &comparator) -> int;
@@ -93,6 +111,10 @@ class BPlusTreeLeafPage : public BPlusTreePage {
 
  private:
   page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  uint32_t fence_flags_;
+  KeyType low_key_;
+  KeyType high_key_;
   // Flexible array member for page data.
   MappingType array_[0];
 };
@@ -17,6 +17,9 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "storage/index/generic_key.h"
+#include "storage/index/integer_key.h"
+#include "storage/index/non_unique_key.h"
+#include "storage/index/normalized_key.h"
 
 namespace bustub {
 
@@ -27,6 +30,10 @@ namespace bustub {
 // define page type enum
 enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
 
+// fence flags of leaf and internal pages, set when the page has a low / high key
+static constexpr uint32_t LOW_KEY_FENCE = 1;
+static constexpr uint32_t HIGH_KEY_FENCE = 2;
+
 /**
  * Both internal and leaf page are inherited from this page.
  *
@@ -46,6 +53,8 @@ class BPlusTreePage {
   ~BPlusTreePage() = delete;
 
   auto IsLeafPage() const -> bool;
+  // a page unlinked from the tree by a merge is marked invalid, readers that still reach it start over
+  auto IsInvalidPage() const -> bool;
   void SetPageType(IndexPageType page_type);
 
   auto GetSize() const -> int;
@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_slotted_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "storage/index/varlen_key.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define SLOTTED_PAGE_HEADER_SIZE 24
+// longest key a slotted page takes: a varlen key plus the RID of a non-unique index
+#define SLOTTED_PAGE_MAX_KEY_SIZE (VARLEN_KEY_MAX_SIZE + VarlenKey::RID_SIZE)
+
+/**
+ * Slotted page of the variable-length key B+ tree (VarlenBPlusTree), used for
+ * both leaf and internal pages. Keys are byte strings in memcmp order, values
+ * are RIDs in leaf pages and child page ids in internal pages.
+ *
+ * All keys of a page share a prefix, which is stored once at the end of the
+ * page; each cell only stores the rest of its key. Slots grow from the front
+ * of the page and cells from the back:
+ *  ----------------------------------------------------------------------------------
+ * | HEADER | SLOT(0) | SLOT(1) | ... | SLOT(n-1) | free | CELL(n-1) ... CELL(0) | PREFIX |
+ *  ----------------------------------------------------------------------------------
+ * Cells are not moved when entries are inserted or removed, the page is only
+ * compacted when a new cell does not fit in the free space between the slots and the cells.
+ *
+ * Like BPlusTreeInternalPage, the first key of an internal page is invalid and
+ * is not part of the shared prefix; ValueAt(i) covers the keys K with
+ * KeyAt(i) <= K < KeyAt(i+1).
+ *
+ * Header format (size in byte, 24 bytes in total):
+ *  -------------------------------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) | Level (2) | PrefixSize (2) |
+ *  -------------------------------------------------------------------------------------------
+ *  -----------------------------------
+ * | FreeEnd (2) | GarbageSize (2) |
+ *  -----------------------------------
+ * MaxSize is the size of the page in bytes, Level is 0 for leaf pages and the
+ * height of the subtree for internal pages. NextPageId links leaf pages only.
+ */
+class BPlusTreeSlottedPage : public BPlusTreePage {
+ public:
+  // Deleted to disallow initialization
+  BPlusTreeSlottedPage() = delete;
+  BPlusTreeSlottedPage(const BPlusTreeSlottedPage &other) = delete;
+
+  /**
+   * Writes the necessary header information to a newly created page
+   * @param level 0 for a leaf page, the height of the subtree for an internal page
+   */
+  void Init(int level);
+
+  auto GetLevel() const -> int;
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+
+  /** @return the prefix shared by all keys of the page */
+  auto GetPrefix() const -> std::string_view;
+
+  /** @return the key at index, prefix included */
+  auto KeyAt(int index) const -> std::string;
+
+  auto ValueAt(int index) const -> int64_t;
+  void SetValueAt(int index, int64_t value);
+
+  /** @return the memcmp order of the key at index and key, without copying the key out */
+  auto CompareAt(int index, std::string_view key) const -> int;
+
+  /** @return true if the key at index starts with key */
+  auto StartsWithAt(int index, std::string_view key) const -> bool;
+
+  /**
+   * Binary search over the valid keys (all keys of a leaf, all but the first key of an internal page).
+   * @return the first index whose key is >= key, GetSize() if there is none
+   */
+  auto LowerBound(std::string_view key) const -> int;
+
+  /** @return the first index whose key is > key, GetSize() if there is none */
+  auto UpperBound(std::string_view key) const -> int;
+
+  /**
+   * Insert an entry at index, compacting the page or shortening the prefix if needed.
+   * @return false if the entry does not fit, the page is unchanged then
+   */
+  auto Insert(int index, std::string_view key, int64_t value) -> bool;
+
+  void Remove(int index);
+
+  /**
+   * @return true if any entry can be inserted without splitting, even if the page has to drop its prefix for it, so
+   * that a writer does not need to keep the latches of the ancestors of the page
+   */
+  auto IsInsertSafe() const -> bool;
+
+  /** @return all entries of the page, the key of the first entry of an internal page is empty */
+  auto GetEntries() const -> std::vector<std::pair<std::string, int64_t>>;
+
+  /**
+   * Replace the entries of the page, the shared prefix is recomputed from the keys.
+   * @return false if the entries do not fit, the page is unchanged then
+   */
+  auto SetEntries(std::vector<std::pair<std::string, int64_t>>::const_iterator begin,
+                  std::vector<std::pair<std::string, int64_t>>::const_iterator end) -> bool;
+
+  /** @return the size in bytes of an entry with a key of key_size bytes, without prefix compression */
+  static auto EntrySize(size_t key_size) -> size_t;
+
+  /**
+   * @brief For test only, return a string representing all keys in
+   * this page, formatted as "(key1,key2,key3,...)" with the keys in hex
+   *
+   * @return std::string
+   */
+  auto ToString() const -> std::string;
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t size_;
+    char value_[sizeof(int64_t)];
+  };
+
+  // index of the first valid key, internal pages ignore their first key
+  auto FirstKeyIndex() const -> int;
+  auto SuffixAt(int index) const -> std::string_view;
+  // bytes of the cells of live entries
+  auto CellBytes() const -> size_t;
+
+  page_id_t next_page_id_;
+  uint16_t level_;
+  uint16_t prefix_size_;
+  uint16_t free_end_;
+  uint16_t garbage_size_;
+  // Flexible array member for page data.
+  Slot slots_[0];
+};
+
+}  // namespace bustub
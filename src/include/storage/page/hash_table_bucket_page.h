@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -24,15 +25,23 @@ namespace bustub {
  * Store indexed key and and value together within bucket page. Supports
  * non-unique keys.
  *
- * Bucket page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ * Bucket page format:
+ *  --------------------------------------------------------------------------------------------
+ * | CTRL(1) | ... | CTRL(n) | padding | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  --------------------------------------------------------------------------------------------
  *
  *  Here '+' means concatenation.
- *  The above format omits the space required for the occupied_ and
- *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
+ *  The control byte of a slot is CTRL_EMPTY if the slot was never occupied,
+ *  CTRL_DELETED for a tombstone, and otherwise has its high bit set and keeps
+ *  7 bits of the hash of the key, the fingerprint. A lookup compares the
+ *  control bytes of BUCKET_GROUP_SIZE slots at once with the fingerprint of
+ *  the key (SSE2 where available), and only compares the keys of the slots
+ *  whose fingerprint matches. Pairs are inserted into the first free slot, so
+ *  no pair follows the first never occupied slot and a probe stops at the
+ *  first group that has one.
  *
+ *  The hash passed for a key must be the same on every call, any hash works,
+ *  at the cost of more key comparisons for a poor one.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -43,26 +52,28 @@ class HashTableBucketPage {
   /**
    * Scan the bucket and collect values that have the matching key
    *
+   * @param hash the hash of the key
    * @return true if at least one key matched
    */
-  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
+  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result, uint32_t hash = 0) const -> bool;
 
   /**
-   * Attempts to insert a key and value in the bucket.  Uses the occupied_
-   * and readable_ arrays to keep track of each slot's availability.
+   * Attempts to insert a key and value in the bucket, into the first free slot.
    *
    * @param key key to insert
    * @param value value to insert
+   * @param hash the hash of the key, its fingerprint is kept in the control byte of the slot
    * @return true if inserted, false if duplicate KV pair or bucket is full
    */
-  auto Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Insert(KeyType key, ValueType value, KeyComparator cmp, uint32_t hash = 0) -> bool;
 
   /**
    * Removes a key and value.
    *
+   * @param hash the hash of the key
    * @return true if removed, false if not found
    */
-  auto Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Remove(KeyType key, ValueType value, KeyComparator cmp, uint32_t hash = 0) -> bool;
 
   /**
    * Gets the key at an index in the bucket.
@@ -93,14 +104,6 @@ class HashTableBucketPage {
    */
   auto IsOccupied(uint32_t bucket_idx) const -> bool;
 
-  /**
-   * SetOccupied - Updates the bitmap to indicate that the entry at
-   * bucket_idx is occupied.
-   *
-   * @param bucket_idx the index to update
-   */
-  void SetOccupied(uint32_t bucket_idx);
-
   /**
    * Returns whether or not an index is readable (valid key/value pair)
    *
@@ -109,28 +112,20 @@ class HashTableBucketPage {
    */
   auto IsReadable(uint32_t bucket_idx) const -> bool;
 
-  /**
-   * SetReadable - Updates the bitmap to indicate that the entry at
-   * bucket_idx is readable.
-   *
-   * @param bucket_idx the index to update
-   */
-  void SetReadable(uint32_t bucket_idx);
-
   /**
    * @return the number of readable elements, i.e. current size
    */
-  auto NumReadable() -> uint32_t;
+  auto NumReadable() const -> uint32_t;
 
   /**
    * @return whether the bucket is full
    */
-  auto IsFull() -> bool;
+  auto IsFull() const -> bool;
 
   /**
    * @return whether the bucket is empty
    */
-  auto IsEmpty() -> bool;
+  auto IsEmpty() const -> bool;
 
   /**
    * Prints the bucket's occupancy information
@@ -138,10 +133,23 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
-  //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
-  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
-  // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  static constexpr uint8_t CTRL_EMPTY = 0x00;
+  static constexpr uint8_t CTRL_DELETED = 0x01;
+  static constexpr uint8_t CTRL_FULL = 0x80;
+
+  /** @return the control byte of a slot holding a key with the hash */
+  static auto Fingerprint(uint32_t hash) -> uint8_t { return CTRL_FULL | (hash >> 25); }
+
+  /**
+   * Calls visit(bucket_idx) for each slot whose control byte is ctrl, group by group, until visit returns true or the
+   * group with the first never occupied slot has been visited.
+   * @return whether visit returned true
+   */
+  template <typename Visit>
+  auto ProbeSlots(uint8_t ctrl, Visit &&visit) const -> bool;
+
+  //  For more on BUCKET_ARRAY_SIZE and BUCKET_CTRL_SIZE see storage/page/hash_table_page_defs.h
+  uint8_t ctrl_[BUCKET_CTRL_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
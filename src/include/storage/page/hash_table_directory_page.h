@@ -74,10 +74,11 @@ class HashTableDirectoryPage {
   void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
 
   /**
-   * Gets the split image of an index
+   * Gets the split image of an index, the index that differs from it in the highest bit of its local depth. A bucket
+   * can only be merged with its split image if both have the same local depth.
    *
    * @param bucket_idx the directory index for which to find the split image
-   * @return the directory index of the split image
+   * @return the directory index of the split image, bucket_idx itself at local depth 0
    **/
   auto GetSplitImageIndex(uint32_t bucket_idx) -> uint32_t;
 
@@ -167,7 +168,8 @@ class HashTableDirectoryPage {
    * is helpful for finding the pair, or "split image", of a bucket.
    *
    * @param bucket_idx bucket index to lookup
-   * @return the high bit corresponding to the bucket's local depth
+   * @return the high bit corresponding to the bucket's local depth, the bit that tells apart the indexes of the two
+   * buckets it splits into
    */
   auto GetLocalHighBit(uint32_t bucket_idx) -> uint32_t;
 
@@ -33,12 +33,22 @@
  */
 #define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
 
+/**
+ * BUCKET_GROUP_SIZE is the number of control bytes of a bucket page probed together, one SSE2 register.
+ */
+#define BUCKET_GROUP_SIZE 16
+
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
- * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * Each pair takes one control byte besides the pair itself, and the control array is padded up to a whole number of
+ * BUCKET_GROUP_SIZE groups, which takes at most BUCKET_GROUP_SIZE - 1 more bytes.
+ */
+#define BUCKET_ARRAY_SIZE ((BUSTUB_PAGE_SIZE - BUCKET_GROUP_SIZE + 1) / (sizeof(MappingType) + 1))
+
+/**
+ * BUCKET_CTRL_SIZE is the size of the control array of a bucket page, BUCKET_ARRAY_SIZE rounded up to whole groups.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_CTRL_SIZE ((BUCKET_ARRAY_SIZE + BUCKET_GROUP_SIZE - 1) / BUCKET_GROUP_SIZE * BUCKET_GROUP_SIZE)
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
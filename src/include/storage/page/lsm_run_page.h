@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_run_page.h
+//
+// Identification: src/include/storage/page/lsm_run_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+
+namespace bustub {
+
+#define LSM_RUN_PAGE_TYPE LsmRunPage<KeyType, ValueType, KeyComparator>
+#define LSM_RUN_PAGE_HEADER_SIZE 8
+#define LSM_RUN_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LSM_RUN_PAGE_HEADER_SIZE) / sizeof(LsmEntry<KeyType, ValueType>))
+
+/** An entry of an LSM tree, in a memtable or a run. */
+template <typename KeyType, typename ValueType>
+struct LsmEntry {
+  KeyType key_;
+  ValueType value_;
+  /** A tombstone hides the entry of the same key and value in older memtables and runs */
+  bool deleted_;
+};
+
+/**
+ * A page of a sorted run of an LSM tree. The entries of a run are written once, in (key, value) order, filling one
+ * page after the other, and are never modified; the LSM tree keeps the page ids of the run in order.
+ *
+ * Run page format:
+ *  ----------------------------------------------------------------------
+ * | HEADER | KEY(1) + VALUE(1) + DELETED(1) | ... | KEY(n) + VALUE(n) + DELETED(n)
+ *  ----------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 8 bytes in total):
+ *  -------------------------------
+ * | CurrentSize (4) | Padding (4) |
+ *  -------------------------------
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LsmRunPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  LsmRunPage() = delete;
+  LsmRunPage(const LsmRunPage &other) = delete;
+
+  /** After creating a new run page from buffer pool, must call initialize method to set default values */
+  void Init();
+
+  auto GetSize() const -> int;
+  auto IsFull() const -> bool;
+  auto EntryAt(int index) const -> const LsmEntry<KeyType, ValueType> &;
+
+  /** Append an entry, which must not be ordered before the last one, to a page that is not full */
+  void Append(const LsmEntry<KeyType, ValueType> &entry);
+
+  /** binary search, return the first index whose key is not less than the input key (size if there is none) */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+ private:
+  int size_;
+  int padding_;
+  // Flexible array member for page data.
+  LsmEntry<KeyType, ValueType> array_[1];
+};
+
+}  // namespace bustub
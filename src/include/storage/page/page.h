@@ -63,6 +63,12 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /** @return the version of the page latch to validate an optimistic read against, see ReaderWriterLatch */
+  inline auto ReadVersion() const -> uint64_t { return rwlatch_.ReadVersion(); }
+
+  /** @return true if the page was not write latched since version was read */
+  inline auto ValidateVersion(uint64_t version) const -> bool { return rwlatch_.Validate(version); }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -78,6 +80,21 @@ class BasicPageGuard {
     return reinterpret_cast<T *>(GetDataMut());
   }
 
+  /**
+   * @brief Read the page under its read latch
+   *
+   * The guard only keeps the page pinned, the latch is held for the call to
+   * read alone. A reader can so come back to the page many times with a
+   * single fetch from the buffer pool, without blocking writers in between.
+   */
+  template <class T, class Func>
+  auto ReadLatched(Func &&read) -> decltype(read(std::declval<const T *>())) {
+    page_->RLatch();
+    auto result = read(As<T>());
+    page_->RUnlatch();
+    return result;
+  }
+
  private:
   friend class ReadPageGuard;
   friend class WritePageGuard;
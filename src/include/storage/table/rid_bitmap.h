@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// rid_bitmap.h
+//
+// Identification: src/include/storage/table/rid_bitmap.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * RidBitmap is a set of RIDs of a table heap, kept as one bitset of slots per page and ordered by page id.
+ *
+ * A bitmap heap scan collects the RIDs returned by index scans into a bitmap, combines the bitmaps of
+ * several indexes with IntersectWith / UnionWith, then reads each page of the bitmap once, in page order.
+ */
+class RidBitmap {
+ public:
+  /** Add a RID to the bitmap. */
+  void Insert(const RID &rid);
+
+  /** @return whether the bitmap holds rid */
+  auto Contains(const RID &rid) const -> bool;
+
+  /** Keep the RIDs that are also in other. */
+  void IntersectWith(const RidBitmap &other);
+
+  /** Add the RIDs of other. */
+  void UnionWith(const RidBitmap &other);
+
+  /** @return the number of RIDs in the bitmap */
+  auto Size() const -> size_t;
+
+  /** @return the number of pages holding RIDs of the bitmap */
+  auto GetPageCount() const -> size_t { return pages_.size(); }
+
+  /** @return the pages holding RIDs of the bitmap, in ascending page id order */
+  auto GetPageIds() const -> std::vector<page_id_t>;
+
+  /** @return the slots of the RIDs of the bitmap in page page_id, ascending */
+  auto GetSlots(page_id_t page_id) const -> std::vector<uint32_t>;
+
+ private:
+  static constexpr uint32_t WORD_BITS = 64;
+
+  /** Slot bitsets of the pages, a page is removed once it has no slot left */
+  std::map<page_id_t, std::vector<uint64_t>> pages_;
+};
+
+}  // namespace bustub
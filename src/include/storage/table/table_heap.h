@@ -15,6 +15,7 @@
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -64,6 +65,14 @@ class TableHeap {
    */
   auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read several tuples of the same page, fetching the page once.
+   * @param page_id the page holding the tuples
+   * @param slots the slots of the tuples to read
+   * @return the meta and tuple of each slot, in the order of slots
+   */
+  auto GetTuples(page_id_t page_id, const std::vector<uint32_t> &slots) -> std::vector<std::pair<TupleMeta, Tuple>>;
+
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
    * to ensure atomicity.
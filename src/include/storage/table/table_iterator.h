@@ -19,6 +19,7 @@
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
+#include "storage/page/page_guard.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -27,6 +28,10 @@ class TableHeap;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * The iterator keeps the page of the current tuple pinned, and reads its tuple count and next page id once, when it
+ * gets to the page. Moving within the page and reading its tuples then take no call to the buffer pool, only the page
+ * latch for the duration of each read, so a scan fetches each page once.
  */
 class TableIterator {
   friend class Cursor;
@@ -41,6 +46,9 @@ class TableIterator {
 
   auto GetTuple() -> std::pair<TupleMeta, Tuple>;
 
+  /** @return the meta and a view of the tuple, the view is valid until the iterator moves to another page */
+  auto GetTupleView() -> std::pair<TupleMeta, TupleView>;
+
   auto GetRID() -> RID;
 
   auto IsEnd() -> bool;
@@ -55,6 +63,16 @@ class TableIterator {
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
   RID stop_at_rid_;
+
+  /** Pin the page and read its header, the tuples of a page before the last one do not change in number. */
+  void FetchPage(page_id_t page_id);
+
+  /** The page of rid_, pinned but not latched */
+  BasicPageGuard page_guard_;
+  /** The number of tuples of the pinned page */
+  uint32_t num_tuples_{0};
+  /** The page after the pinned page */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -42,6 +42,8 @@ struct TupleMeta {
 
 static_assert(sizeof(TupleMeta) == TUPLE_META_SIZE);
 
+class TupleView;
+
 /**
  * Tuple format:
  * ---------------------------------------------------------------------
@@ -52,6 +54,7 @@ class Tuple {
   friend class TablePage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -94,7 +97,8 @@ class Tuple {
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
   // Generates a key tuple given schemas and attributes
-  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
+  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
+      -> Tuple;
 
   // Is the column value null ?
   inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
@@ -104,6 +108,9 @@ class Tuple {
 
   auto ToString(const Schema *schema) const -> std::string;
 
+  // Get a view of this tuple, valid as long as the tuple is not changed or destroyed
+  inline auto GetView() const -> TupleView;
+
  private:
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
@@ -112,4 +119,38 @@ class Tuple {
   std::vector<char> data_;
 };
 
+/**
+ * A tuple read in place: the bytes of a tuple held elsewhere, usually in a table page the reader keeps pinned, read
+ * with the same accessors as a Tuple. A view owns nothing and is valid as long as the bytes it points to are. ToTuple
+ * copies it into an owned Tuple once the row must outlive them.
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  TupleView(const char *data, uint32_t length, RID rid) : data_(data), length_(length), rid_(rid) {}
+
+  // return RID of the viewed tuple
+  inline auto GetRid() const -> RID { return rid_; }
+
+  // Get the address of the viewed bytes
+  inline auto GetData() const -> const char * { return data_; }
+
+  // Get length of the tuple, including varchar legth
+  inline auto GetLength() const -> uint32_t { return length_; }
+
+  // Get the value of a specified column, the value of a VARCHAR column is copied out of the viewed bytes
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  // Copy the viewed bytes into an owned tuple
+  auto ToTuple() const -> Tuple;
+
+ private:
+  const char *data_{nullptr};
+  uint32_t length_{0};
+  RID rid_{};
+};
+
+inline auto Tuple::GetView() const -> TupleView { return {data_.data(), static_cast<uint32_t>(data_.size()), rid_}; }
+
 }  // namespace bustub
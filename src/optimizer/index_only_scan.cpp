@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+#include "storage/index/b_plus_tree_index.h"
+
+namespace bustub {
+
+// collect the columns of the child tuple that expr reads
+static void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> *columns) {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      column_value_expr != nullptr) {
+    columns->push_back(column_value_expr->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+// whether the entries of the index store every column in columns, and the index returns its entries
+static auto IndexCovers(const IndexInfo &index, const std::vector<uint32_t> &columns) -> bool {
+  if (!VisitBPlusTreeIndex(index.index_.get(), [](auto &tree) {})) {
+    return false;
+  }
+  const auto &entry_attrs = index.index_->GetMetadata()->GetEntryAttrs();
+  return std::all_of(columns.begin(), columns.end(), [&entry_attrs](uint32_t column) {
+    return std::find(entry_attrs.begin(), entry_attrs.end(), column) != entry_attrs.end();
+  });
+}
+
+auto Optimizer::OptimizeProjectionAsIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeProjectionAsIndexOnlyScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Projection) {
+    return optimized_plan;
+  }
+  const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan);
+
+  // the columns read above the scan, by the projection and a filter between the projection and the scan
+  std::vector<uint32_t> columns;
+  for (const auto &expr : projection.GetExpressions()) {
+    CollectColumns(expr, &columns);
+  }
+  const auto *filter = dynamic_cast<const FilterPlanNode *>(projection.GetChildPlan().get());
+  const auto &scan_plan = filter != nullptr ? filter->GetChildPlan() : projection.GetChildPlan();
+  if (filter != nullptr) {
+    CollectColumns(filter->GetPredicate(), &columns);
+  }
+
+  AbstractPlanNodeRef index_scan;
+  if (scan_plan->GetType() == PlanType::IndexScan) {
+    const auto &index_scan_plan = dynamic_cast<const IndexScanPlanNode &>(*scan_plan);
+    const auto *index = catalog_.GetIndex(index_scan_plan.GetIndexOid());
+    if (index_scan_plan.filter_predicate_ != nullptr) {
+      CollectColumns(index_scan_plan.filter_predicate_, &columns);
+    }
+    if (index_scan_plan.IsIndexOnly() || !IndexCovers(*index, columns)) {
+      return optimized_plan;
+    }
+    auto index_only_scan = std::make_shared<IndexScanPlanNode>(index_scan_plan);
+    index_only_scan->index_only_ = true;
+    index_scan = std::move(index_only_scan);
+  } else if (scan_plan->GetType() == PlanType::BitmapHeapScan) {
+    // the key ranges of a bitmap heap scan over a covering index are read from the index alone
+    const auto &bitmap_scan = dynamic_cast<const BitmapHeapScanPlanNode &>(*scan_plan);
+    if (bitmap_scan.filter_predicate_ != nullptr) {
+      CollectColumns(bitmap_scan.filter_predicate_, &columns);
+    }
+    if (bitmap_scan.op_type_ == BitmapOpType::Or && bitmap_scan.index_scans_.size() > 1) {
+      return optimized_plan;
+    }
+    for (const auto &bitmap_index_scan : bitmap_scan.index_scans_) {
+      if (IndexCovers(*catalog_.GetIndex(bitmap_index_scan.index_oid_), columns)) {
+        index_scan = std::make_shared<IndexScanPlanNode>(scan_plan->output_schema_, bitmap_index_scan.index_oid_,
+                                                         false, true, bitmap_scan.filter_predicate_,
+                                                         bitmap_index_scan.key_ranges_);
+        break;
+      }
+    }
+  } else if (scan_plan->GetType() == PlanType::SeqScan) {
+    // a sequential scan is only replaced by a covering index, which is made for such queries, as the index scan
+    // returns the rows in key order instead of table order
+    const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*scan_plan);
+    if (seq_scan.filter_predicate_ != nullptr) {
+      return optimized_plan;
+    }
+    const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
+    for (const auto *index : catalog_.GetTableIndexes(table_info->name_)) {
+      if (index->index_->GetMetadata()->GetIncludeColumnCount() > 0 && IndexCovers(*index, columns)) {
+        index_scan = std::make_shared<IndexScanPlanNode>(scan_plan->output_schema_, index->index_oid_, false, true);
+        break;
+      }
+    }
+  }
+  if (index_scan == nullptr) {
+    return optimized_plan;
+  }
+
+  if (filter != nullptr) {
+    index_scan = filter->CloneWithChildren({index_scan});
+  }
+  return projection.CloneWithChildren({index_scan});
+}
+
+}  // namespace bustub
@@ -1,5 +1,7 @@
 #include "optimizer/optimizer.h"
+#include <algorithm>
 #include <optional>
+#include "catalog/catalog.h"
 #include "common/util/string_util.h"
 #include "execution/plans/abstract_plan.h"
 
@@ -20,6 +22,16 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
 }
 
 auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::optional<size_t> {
+  // the index statistics count the rows of the table, each index has an entry per row
+  std::optional<size_t> index_rows;
+  for (auto *index_info : catalog_.GetTableIndexes(table_name)) {
+    if (auto stats = index_info->index_->GetStatistics(); stats.has_value()) {
+      index_rows = std::max(index_rows.value_or(0), stats->entry_count_);
+    }
+  }
+  if (index_rows.has_value()) {
+    return index_rows;
+  }
   if (StringUtil::EndsWith(table_name, "_1m")) {
     return std::make_optional(1000000);
   }
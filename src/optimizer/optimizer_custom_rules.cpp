@@ -12,7 +12,9 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   p = OptimizeMergeProjection(p);
   p = OptimizeMergeFilterNLJ(p);
   p = OptimizeNLJAsHashJoin(p);
+  p = OptimizeSeqScanAsIndexScan(p);
   p = OptimizeOrderByAsIndexScan(p);
+  p = OptimizeProjectionAsIndexOnlyScan(p);
   p = OptimizeSortLimitAsTopN(p);
   return p;
 }
@@ -10,6 +10,7 @@
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/index_scan_plan.h"
 #include "execution/plans/nested_loop_join_plan.h"
@@ -32,10 +33,11 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*optimized_plan);
     const auto &order_bys = sort_plan.GetOrderBy();
 
+    // All order types are asc or default, or all are desc, which reads the index backwards
+    bool reverse = !order_bys.empty() && order_bys.front().first == OrderByType::DESC;
     std::vector<uint32_t> order_by_column_ids;
     for (const auto &[order_type, expr] : order_bys) {
-      // Order type is asc or default
-      if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
+      if (order_type == OrderByType::INVALID || (order_type == OrderByType::DESC) != reverse) {
         return optimized_plan;
       }
 
@@ -52,24 +54,77 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Sort with multiple children?? Impossible!");
     const auto &child_plan = optimized_plan->children_[0];
 
-    if (child_plan->GetType() == PlanType::SeqScan) {
-      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+    // A projection between the sort and the scan is kept above the index scan, as long as the order by
+    // columns are plain columns of the scan
+    const auto *projection = dynamic_cast<const ProjectionPlanNode *>(child_plan.get());
+    auto scan_plan = child_plan;
+    if (projection != nullptr) {
+      for (auto &column_id : order_by_column_ids) {
+        const auto *column_value_expr =
+            dynamic_cast<const ColumnValueExpression *>(projection->GetExpressions()[column_id].get());
+        if (column_value_expr == nullptr) {
+          return optimized_plan;
+        }
+        column_id = column_value_expr->GetColIdx();
+      }
+      scan_plan = projection->GetChildPlan();
+    }
+
+    // check index key schema == order by columns
+    auto index_matches = [&order_by_column_ids](const IndexInfo &index, const TableInfo &table_info) {
+      const auto &columns = index.key_schema_.GetColumns();
+      if (index.index_type_ != IndexType::BPlusTreeIndex || columns.size() != order_by_column_ids.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < columns.size(); i++) {
+        if (columns[i].GetName() != table_info.schema_.GetColumn(order_by_column_ids[i]).GetName()) {
+          return false;
+        }
+      }
+      return true;
+    };
+    auto with_projection = [projection](AbstractPlanNodeRef index_scan) -> AbstractPlanNodeRef {
+      if (projection != nullptr) {
+        return projection->CloneWithChildren({std::move(index_scan)});
+      }
+      return index_scan;
+    };
+
+    if (scan_plan->GetType() == PlanType::SeqScan) {
+      const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*scan_plan);
       const auto *table_info = catalog_.GetTable(seq_scan.GetTableOid());
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
-        const auto &columns = index->key_schema_.GetColumns();
-        // check index key schema == order by columns
-        bool valid = true;
-        if (columns.size() == order_by_column_ids.size()) {
-          for (size_t i = 0; i < columns.size(); i++) {
-            if (columns[i].GetName() != table_info->schema_.GetColumn(order_by_column_ids[i]).GetName()) {
-              valid = false;
-              break;
-            }
-          }
-          if (valid) {
-            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
+        if (index_matches(*index, *table_info)) {
+          return with_projection(std::make_shared<IndexScanPlanNode>(scan_plan->output_schema_, index->index_oid_,
+                                                                     reverse, false, seq_scan.filter_predicate_));
+        }
+      }
+    }
+
+    // an index scan of the key ranges of a filter already returns the tuples in key order
+    if (scan_plan->GetType() == PlanType::IndexScan) {
+      const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*scan_plan);
+      const auto *index = catalog_.GetIndex(index_scan.GetIndexOid());
+      if (index_matches(*index, *catalog_.GetTable(index->table_name_))) {
+        auto ordered_scan = std::make_shared<IndexScanPlanNode>(index_scan);
+        ordered_scan->reverse_ = reverse;
+        return with_projection(std::move(ordered_scan));
+      }
+    }
+
+    // so does an index scan of the key ranges a bitmap heap scan intersects
+    if (scan_plan->GetType() == PlanType::BitmapHeapScan) {
+      const auto &bitmap_scan = dynamic_cast<const BitmapHeapScanPlanNode &>(*scan_plan);
+      if (bitmap_scan.op_type_ == BitmapOpType::And || bitmap_scan.index_scans_.size() == 1) {
+        const auto *table_info = catalog_.GetTable(bitmap_scan.GetTableOid());
+        for (const auto &index_scan : bitmap_scan.index_scans_) {
+          if (index_matches(*catalog_.GetIndex(index_scan.index_oid_), *table_info)) {
+            return with_projection(std::make_shared<IndexScanPlanNode>(scan_plan->output_schema_,
+                                                                       index_scan.index_oid_, reverse, false,
+                                                                       bitmap_scan.filter_predicate_,
+                                                                       index_scan.key_ranges_));
           }
         }
       }
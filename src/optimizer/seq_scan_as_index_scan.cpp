@@ -0,0 +1,385 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/bitmap_heap_scan_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/type_id.h"
+
+namespace bustub {
+
+namespace {
+
+/** A conjunct of the form `column op constant`, with op seen from the column. */
+struct ColumnComparison {
+  uint32_t col_idx_;
+  ComparisonType comp_type_;
+  Value value_;
+};
+
+}  // namespace
+
+static auto IsIntegral(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+// the constant as a value of the key column type, none if the index cannot compare it like the predicate does
+static auto AsKeyValue(const Value &value, TypeId column_type) -> std::optional<Value> {
+  if (value.IsNull()) {
+    return std::nullopt;
+  }
+  if (value.GetTypeId() == column_type) {
+    return value;
+  }
+  if (!IsIntegral(value.GetTypeId()) || !IsIntegral(column_type)) {
+    return std::nullopt;
+  }
+  try {
+    return value.CastAs(column_type);
+  } catch (const Exception &e) {
+    // the constant is out of the range of the column
+    return std::nullopt;
+  }
+}
+
+static auto MatchColumnComparison(const AbstractExpressionRef &expr) -> std::optional<ColumnComparison> {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison == nullptr) {
+    return std::nullopt;
+  }
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  auto comp_type = comparison->comp_type_;
+  if (column == nullptr || constant == nullptr) {
+    // constant op column, flip the comparison
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  if (column == nullptr || constant == nullptr || column->GetTupleIdx() != 0) {
+    return std::nullopt;
+  }
+  return ColumnComparison{column->GetColIdx(), comp_type, constant->val_};
+}
+
+static void SplitConjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::And) {
+    SplitConjuncts(logic->GetChildAt(0), conjuncts);
+    SplitConjuncts(logic->GetChildAt(1), conjuncts);
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+// collect the constants of a disjunction `column = c1 OR column = c2 ...`, false if expr is not one
+static auto MatchInList(const AbstractExpressionRef &expr, uint32_t col_idx, TypeId column_type,
+                        std::vector<Value> *values) -> bool {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::Or) {
+    return MatchInList(logic->GetChildAt(0), col_idx, column_type, values) &&
+           MatchInList(logic->GetChildAt(1), col_idx, column_type, values);
+  }
+  auto comparison = MatchColumnComparison(expr);
+  if (!comparison.has_value() || comparison->col_idx_ != col_idx || comparison->comp_type_ != ComparisonType::Equal) {
+    return false;
+  }
+  auto value = AsKeyValue(comparison->value_, column_type);
+  if (!value.has_value()) {
+    // `column = NULL` never holds, the disjunct selects nothing
+    return comparison->value_.IsNull();
+  }
+  values->push_back(*value);
+  return true;
+}
+
+static auto LessThan(const Value &lhs, const Value &rhs) -> bool {
+  return lhs.CompareLessThan(rhs) == CmpBool::CmpTrue;
+}
+
+// the ranges of a single key column holding every tuple satisfying the conjuncts, see MatchKeyRanges
+static auto MatchColumnRanges(const std::vector<AbstractExpressionRef> &conjuncts, uint32_t col_idx,
+                              TypeId column_type) -> std::optional<std::vector<IndexKeyRange>> {
+  std::optional<std::vector<Value>> points;
+  IndexKeyRange range;
+  for (const auto &conjunct : conjuncts) {
+    std::vector<Value> values;
+    if (MatchInList(conjunct, col_idx, column_type, &values)) {
+      if (!points.has_value() || values.size() < points->size()) {
+        points = std::move(values);
+      }
+      continue;
+    }
+    auto comparison = MatchColumnComparison(conjunct);
+    if (!comparison.has_value() || comparison->col_idx_ != col_idx) {
+      continue;
+    }
+    auto value = AsKeyValue(comparison->value_, column_type);
+    if (!value.has_value()) {
+      continue;
+    }
+    auto comp_type = comparison->comp_type_;
+    bool inclusive = comp_type == ComparisonType::LessThanOrEqual || comp_type == ComparisonType::GreaterThanOrEqual;
+    if (comp_type == ComparisonType::GreaterThan || comp_type == ComparisonType::GreaterThanOrEqual) {
+      // keep the largest lower bound, exclusive on a tie
+      if (range.lo_.empty() || LessThan(range.lo_[0], *value) ||
+          (!inclusive && value->CompareEquals(range.lo_[0]) == CmpBool::CmpTrue)) {
+        range.lo_ = {*value};
+        range.lo_inclusive_ = inclusive;
+      }
+    } else if (comp_type == ComparisonType::LessThan || comp_type == ComparisonType::LessThanOrEqual) {
+      // keep the smallest upper bound, exclusive on a tie
+      if (range.hi_.empty() || LessThan(*value, range.hi_[0]) ||
+          (!inclusive && value->CompareEquals(range.hi_[0]) == CmpBool::CmpTrue)) {
+        range.hi_ = {*value};
+        range.hi_inclusive_ = inclusive;
+      }
+    }
+  }
+
+  if (points.has_value() && !points->empty()) {
+    // ascending and without duplicates, so that each key is looked up once and in key order
+    std::sort(points->begin(), points->end(), LessThan);
+    points->erase(std::unique(points->begin(), points->end(),
+                              [](const Value &lhs, const Value &rhs) {
+                                return lhs.CompareEquals(rhs) == CmpBool::CmpTrue;
+                              }),
+                  points->end());
+    std::vector<IndexKeyRange> ranges;
+    for (const auto &point : *points) {
+      ranges.push_back({{point}, true, {point}, true});
+    }
+    return ranges;
+  }
+  if (range.lo_.empty() && range.hi_.empty()) {
+    return std::nullopt;
+  }
+  return std::vector{range};
+}
+
+/*
+ * The key ranges of the index that hold every tuple satisfying the conjuncts,
+ * none if the conjuncts do not restrict the key. Every key column needs an
+ * equality (or a list of them for a single-column key) for point lookups, a
+ * single-column key is also scanned between the tightest bounds given by the
+ * other comparisons, unless the index is a hash index. The scan checks the
+ * whole predicate on each tuple, so the ranges may be wider than the predicate.
+ */
+static auto MatchKeyRanges(const std::vector<AbstractExpressionRef> &conjuncts, const IndexInfo &index)
+    -> std::optional<std::vector<IndexKeyRange>> {
+  const auto &key_attrs = index.index_->GetKeyAttrs();
+  const auto *key_schema = index.index_->GetKeySchema();
+
+  if (key_attrs.size() > 1) {
+    std::vector<Value> key(key_attrs.size());
+    std::vector<bool> matched(key_attrs.size(), false);
+    for (const auto &conjunct : conjuncts) {
+      auto comparison = MatchColumnComparison(conjunct);
+      if (!comparison.has_value() || comparison->comp_type_ != ComparisonType::Equal) {
+        continue;
+      }
+      auto key_idx = std::find(key_attrs.begin(), key_attrs.end(), comparison->col_idx_) - key_attrs.begin();
+      if (key_idx == static_cast<ptrdiff_t>(key_attrs.size())) {
+        continue;
+      }
+      auto value = AsKeyValue(comparison->value_, key_schema->GetColumn(key_idx).GetType());
+      if (value.has_value()) {
+        key[key_idx] = *value;
+        matched[key_idx] = true;
+      }
+    }
+    if (std::find(matched.begin(), matched.end(), false) != matched.end()) {
+      return std::nullopt;
+    }
+    return std::vector{IndexKeyRange{key, true, key, true}};
+  }
+
+  auto ranges = MatchColumnRanges(conjuncts, key_attrs[0], key_schema->GetColumn(0).GetType());
+  // a hash or LSM index only answers point lookups
+  if (ranges.has_value() && index.index_type_ != IndexType::BPlusTreeIndex &&
+      !std::all_of(ranges->begin(), ranges->end(), [](const IndexKeyRange &range) { return range.IsPoint(); })) {
+    return std::nullopt;
+  }
+  return ranges;
+}
+
+/*
+ * The key ranges of a skip scan of the index, which scans the ranges the conjuncts restrict the second key column to
+ * once for each distinct value of the first. The executor pads the bounds with the smallest or largest value of the
+ * key columns they leave out, so only B+ tree keys without VARCHAR columns, whose values are all bounded, are skipped.
+ */
+static auto MatchSkipScanRanges(const std::vector<AbstractExpressionRef> &conjuncts, const IndexInfo &index)
+    -> std::optional<std::vector<IndexKeyRange>> {
+  const auto &key_attrs = index.index_->GetKeyAttrs();
+  const auto *key_schema = index.index_->GetKeySchema();
+  if (key_attrs.size() < 2 || !VisitBPlusTreeIndex(index.index_.get(), [](auto &tree) {})) {
+    return std::nullopt;
+  }
+  for (const auto &column : key_schema->GetColumns()) {
+    if (column.GetType() == TypeId::VARCHAR) {
+      return std::nullopt;
+    }
+  }
+  return MatchColumnRanges(conjuncts, key_attrs[1], key_schema->GetColumn(1).GetType());
+}
+
+// the tuples returned by point lookups of the index, from the entries per distinct key of its statistics
+static auto EstimatePointLookupRows(const IndexInfo &index, size_t points) -> std::optional<size_t> {
+  auto stats = index.index_->GetStatistics();
+  if (!stats.has_value()) {
+    return std::nullopt;
+  }
+  return points * stats->EntriesPerKey();
+}
+
+static void SplitDisjuncts(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *disjuncts) {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get());
+      logic != nullptr && logic->logic_type_ == LogicType::Or) {
+    SplitDisjuncts(logic->GetChildAt(0), disjuncts);
+    SplitDisjuncts(logic->GetChildAt(1), disjuncts);
+    return;
+  }
+  disjuncts->push_back(expr);
+}
+
+// an index scan for each disjunct of expr, none if expr is not a disjunction or an index answers no disjunct
+static auto MatchDisjunction(const AbstractExpressionRef &expr, const std::vector<IndexInfo *> &indexes)
+    -> std::optional<std::vector<BitmapIndexScan>> {
+  std::vector<AbstractExpressionRef> disjuncts;
+  SplitDisjuncts(expr, &disjuncts);
+  if (disjuncts.size() < 2) {
+    return std::nullopt;
+  }
+  std::vector<BitmapIndexScan> index_scans;
+  for (const auto &disjunct : disjuncts) {
+    std::vector<AbstractExpressionRef> conjuncts;
+    SplitConjuncts(disjunct, &conjuncts);
+    std::optional<BitmapIndexScan> best_scan;
+    for (const auto *index : indexes) {
+      auto ranges = MatchKeyRanges(conjuncts, *index);
+      if (ranges.has_value() && (!best_scan.has_value() || ranges->front().IsPoint())) {
+        best_scan = BitmapIndexScan{index->index_oid_, std::move(*ranges)};
+        if (best_scan->key_ranges_.front().IsPoint()) {
+          break;
+        }
+      }
+    }
+    if (!best_scan.has_value()) {
+      return std::nullopt;
+    }
+    index_scans.push_back(std::move(*best_scan));
+  }
+  return index_scans;
+}
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // a filter over a sequential scan, or a sequential scan with a filter predicate merged into it
+  const SeqScanPlanNode *seq_scan = nullptr;
+  AbstractExpressionRef predicate;
+  if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    seq_scan = dynamic_cast<const SeqScanPlanNode *>(filter.GetChildPlan().get());
+    if (seq_scan == nullptr || seq_scan->filter_predicate_ != nullptr) {
+      return optimized_plan;
+    }
+    predicate = filter.GetPredicate();
+  } else if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan.get());
+    predicate = seq_scan->filter_predicate_;
+  }
+  if (predicate == nullptr) {
+    return optimized_plan;
+  }
+
+  std::vector<AbstractExpressionRef> conjuncts;
+  SplitConjuncts(predicate, &conjuncts);
+  const auto indexes = catalog_.GetTableIndexes(seq_scan->table_name_);
+
+  // an index answering point lookups is scanned alone, in key order; of several, the one whose statistics estimate the
+  // fewest tuples, the first one if they do not tell
+  std::vector<BitmapIndexScan> range_scans;
+  std::shared_ptr<IndexScanPlanNode> point_scan;
+  for (const auto *index : indexes) {
+    auto ranges = MatchKeyRanges(conjuncts, *index);
+    if (!ranges.has_value()) {
+      continue;
+    }
+    if (ranges->front().IsPoint()) {
+      auto estimated_rows = EstimatePointLookupRows(*index, ranges->size());
+      if (point_scan == nullptr || (estimated_rows.has_value() && point_scan->estimated_rows_.has_value() &&
+                                    *estimated_rows < *point_scan->estimated_rows_)) {
+        point_scan = std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_, false,
+                                                         false, predicate, std::move(*ranges));
+        point_scan->estimated_rows_ = estimated_rows;
+      }
+      continue;
+    }
+    range_scans.push_back({index->index_oid_, std::move(*ranges)});
+  }
+  if (point_scan != nullptr) {
+    return point_scan;
+  }
+
+  // the RIDs of key ranges are collected into a bitmap first, so that each page of the table is read once and in
+  // page order, the ranges of several indexes are intersected
+  if (!range_scans.empty()) {
+    return std::make_shared<BitmapHeapScanPlanNode>(optimized_plan->output_schema_, seq_scan->table_oid_,
+                                                    seq_scan->table_name_, std::move(range_scans), BitmapOpType::And,
+                                                    predicate);
+  }
+
+  // a disjunction whose every disjunct is answered by an index unites their RIDs
+  for (const auto &conjunct : conjuncts) {
+    auto index_scans = MatchDisjunction(conjunct, indexes);
+    if (index_scans.has_value()) {
+      return std::make_shared<BitmapHeapScanPlanNode>(optimized_plan->output_schema_, seq_scan->table_oid_,
+                                                      seq_scan->table_name_, std::move(*index_scans),
+                                                      BitmapOpType::Or, predicate);
+    }
+  }
+
+  // a multi-column index whose second key column is restricted is skip scanned over the values of the first
+  for (const auto *index : indexes) {
+    auto ranges = MatchSkipScanRanges(conjuncts, *index);
+    if (ranges.has_value()) {
+      return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_, false, false,
+                                                 predicate, std::move(*ranges), 1);
+    }
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
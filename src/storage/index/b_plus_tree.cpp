@@ -8,6 +8,7 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/rid.h"
+#include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/page/b_plus_tree_header_page.h"
 #include "storage/page/b_plus_tree_page.h"
@@ -17,12 +18,14 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size)
+                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size,
+                          double underflow_fill)
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
       comparator_(std::move(comparator)),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size),
+      underflow_fill_(std::clamp(underflow_fill, 0.0, 0.5)),
       header_page_id_(header_page_id) {
   if (leaf_max_size <= 1) {
     std::cout << "\nleaf_max_size <=1\n";
@@ -35,6 +38,13 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
   auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
   root_page->root_page_id_ = INVALID_PAGE_ID;
+  if (enable_index_bloom_filter) {
+    filter_capacity_ = INDEX_BLOOM_FILTER_MIN_KEYS;
+    filter_ = new BloomFilter(filter_capacity_.load());
+  }
+  if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+    distinct_keys_ = std::make_unique<HyperLogLog>();
+  }
 }
 
 /*
@@ -42,6 +52,7 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  auto epoch = epoch_manager_.Enter();
   ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
   auto root_page = guard.As<BPlusTreeHeaderPage>();
   if (INVALID_PAGE_ID == root_page->root_page_id_) {
@@ -55,49 +66,372 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the only value that associated with input key, or every value of the
+ * key for a non-unique key, whatever RID is set in it
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  // Context ctx;
-  // (void)ctx;
-  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
-  auto root_page = guard.As<BPlusTreeHeaderPage>();
-  if (INVALID_PAGE_ID == root_page->root_page_id_) {
+  auto epoch = epoch_manager_.Enter();
+  if (auto *filter = filter_.load(); filter != nullptr && !filter->MayContain(KeyHash(key))) {
     return false;
   }
-  guard = bpm_->FetchPageRead(root_page->root_page_id_);
-  auto ppage = guard.As<InternalPage>();
-  if (0 == ppage->GetSize()) {
+  if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+    // the entries of the key are ordered by RID and may span several leaves
+    auto cursor = ScanRange(key.LowerBound(), true, key.UpperBound(), true);
+    size_t size = result->size();
+    typename INDEXRANGECURSOR_TYPE::BatchType batch;
+    while (cursor.NextBatch(&batch)) {
+      for (const auto &entry : batch) {
+        result->push_back(entry.second);
+      }
+    }
+    return result->size() > size;
+  }
+  PageCopy page;
+  if (INVALID_PAGE_ID == FindLeafRead(key, false, &page)) {
     return false;
   }
-  while (!ppage->IsLeafPage()) {
-    auto cursize = ppage->GetSize();
-    int i = 1;
-    while (i < cursize && 0 <= comparator_(key, ppage->KeyAt(i))) {
-      ++i;
-    }
-    guard = bpm_->FetchPageRead(ppage->ValueAt(i - 1));
-    ppage = guard.As<InternalPage>();
-  }
-  auto ppage_leaf = reinterpret_cast<const LeafPage *>(ppage);
-  auto cursize = ppage_leaf->GetSize();
-  for (int i = 0; i < cursize; ++i) {
-    if (0 == comparator_(key, ppage_leaf->KeyAt(i))) {
-      // std::cout << "GetValue:" << key << '\n';
-      result->push_back(ppage_leaf->ValueAt(i));
+  auto ppage_leaf = page.template As<LeafPage>();
+  int i = ppage_leaf->KeyIndex(key, comparator_);
+  if (i < ppage_leaf->GetSize() && 0 == comparator_(key, ppage_leaf->KeyAt(i))) {
+    result->push_back(ppage_leaf->ValueAt(i));
+    return true;
+  }
+  return false;
+}
+
+/*
+ * Copy page_id into page. Readers never hold a latch once the copy is taken:
+ * with enable_optimistic_index_read a page in the buffer pool is neither
+ * pinned nor latched, the copy is validated against the version of the page
+ * latch instead. A page that is not resident, or that a writer holds, is
+ * copied under the read latch.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReadPage(page_id_t page_id, PageCopy *page) {
+  if (enable_optimistic_index_read &&
+      bpm_->ReadResidentOptimistic(page_id, [page](const char *data) { CopyPage(data, page); })) {
+    return;
+  }
+  auto guard = bpm_->FetchPageRead(page_id);
+  CopyPage(guard.GetData(), page);
+}
+
+/*
+ * Only the header and the entries in use are copied. The size is read from
+ * the copied header, which may be torn by an optimistic read, so the copy is
+ * bounded by the page whatever the size says.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CopyPage(const char *data, PageCopy *page) {
+  constexpr size_t header_size = std::max(sizeof(LeafPage), sizeof(InternalPage));
+  memcpy(page->data_, data, header_size);
+  auto header = page->template As<BPlusTreePage>();
+  auto size = static_cast<size_t>(std::clamp(header->GetSize(), 0, BUSTUB_PAGE_SIZE));
+  size_t used = header->IsLeafPage() ? sizeof(LeafPage) + size * sizeof(MappingType)
+                                     : sizeof(InternalPage) + size * sizeof(std::pair<KeyType, page_id_t>);
+  used = std::min<size_t>(used, BUSTUB_PAGE_SIZE);
+  if (used > header_size) {
+    memcpy(page->data_ + header_size, data + header_size, used - header_size);
+  }
+}
+
+/*
+ * Descend to the leaf covering key (the leftmost leaf for an empty key, or the
+ * rightmost one if rightmost is set), B-link style: every page is read on its
+ * own with ReadPage, no latch is held from one page to the next. A page that
+ * was split after we read the pointer to it is recognized by its high key and
+ * we move right along the sibling links. A page unlinked by a merge, or one
+ * that lost the key to its left sibling through redistribution, can not be
+ * recovered from by moving right, so the descent starts over from the root.
+ * With before set, a page covers the keys just below key instead: the keys
+ * above its low key up to its high key included, so a reverse scan finds the
+ * leaf left of the one whose low key is key.
+ * The caller is in an epoch of the tree, so none of the pages read is freed.
+ * @return : page id of the leaf, its copy is left in leaf, INVALID_PAGE_ID if
+ * the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const std::optional<KeyType> &key, bool rightmost, PageCopy *leaf, bool before)
+    -> page_id_t {
+  // -1: restart from the root, 1: move right, 0: the page covers the key
+  int shift = before ? 1 : 0;
+  auto position = [this, &key, rightmost, shift](const auto *page) {
+    if (page->GetLowKey().has_value() &&
+        (key.has_value() ? comparator_(key.value(), page->GetLowKey().value()) < shift : !rightmost)) {
+      return -1;
+    }
+    if (page->GetHighKey().has_value() &&
+        (key.has_value() ? comparator_(key.value(), page->GetHighKey().value()) >= shift : rightmost)) {
+      return 1;
+    }
+    return 0;
+  };
+
+  PageCopy &page = *leaf;
+  while (true) {
+    ReadPage(header_page_id_, &page);
+    page_id_t page_id = page.template As<BPlusTreeHeaderPage>()->root_page_id_;
+    if (INVALID_PAGE_ID == page_id) {
+      return INVALID_PAGE_ID;
+    }
+    while (true) {
+      ReadPage(page_id, &page);
+      if (page.template As<BPlusTreePage>()->IsInvalidPage()) {
+        break;
+      }
+      if (page.template As<BPlusTreePage>()->IsLeafPage()) {
+        auto ppage_leaf = page.template As<LeafPage>();
+        int pos = position(ppage_leaf);
+        if (pos < 0) {
+          break;
+        }
+        if (pos > 0) {
+          page_id = ppage_leaf->GetNextPageId();
+          continue;
+        }
+        return page_id;
+      }
+      auto inter = page.template As<InternalPage>();
+      int pos = position(inter);
+      if (pos < 0) {
+        break;
+      }
+      if (pos > 0) {
+        page_id = inter->GetNextPageId();
+        continue;
+      }
+      int i = key.has_value() ? inter->UpperBound(key.value(), comparator_) : (rightmost ? inter->GetSize() : 1);
+      if (before && key.has_value() && i > 1 && 0 == comparator_(inter->KeyAt(i - 1), key.value())) {
+        --i;
+      }
+      page_id = inter->ValueAt(i - 1);
+    }
+  }
+}
+
+/*
+ * Whether the leaf covering key is in the buffer pool. The descent only
+ * fetches pages that are resident, so it never reads from disk, and it does
+ * not move right or restart on concurrent changes: the answer is a hint.
+ * @return : false as soon as a page on the path is not resident, true for an
+ * empty tree
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsLeafResident(const KeyType &key) -> bool {
+  auto epoch = epoch_manager_.Enter();
+  page_id_t page_id;
+  {
+    auto guard = bpm_->FetchPageRead(header_page_id_);
+    page_id = guard.template As<BPlusTreeHeaderPage>()->root_page_id_;
+  }
+  while (INVALID_PAGE_ID != page_id) {
+    if (!bpm_->IsPageResident(page_id)) {
+      return false;
+    }
+    auto guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.template As<BPlusTreePage>();
+    if (page->IsInvalidPage() || page->IsLeafPage()) {
       return true;
     }
+    auto inter = guard.template As<InternalPage>();
+    page_id = inter->ValueAt(inter->UpperBound(key, comparator_) - 1);
   }
-  return false;
+  return true;
+}
+
+/*****************************************************************************
+ * BLOOM FILTER
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::KeyHash(const KeyType &key) -> uint64_t {
+  if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+    return HashFunction<decltype(key.key_)>{}.GetHash(key.key_);
+  } else {
+    return HashFunction<KeyType>{}.GetHash(key);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GrowFilter(size_t added) {
+  if (filter_.load() == nullptr) {
+    return;
+  }
+  if (filter_keys_ += added; filter_keys_.load() <= filter_capacity_.load()) {
+    return;
+  }
+  std::unique_lock lock(filter_rebuild_latch_);
+  // another insert may have rebuilt the filter while this one waited for the latch
+  if (filter_keys_.load() > filter_capacity_.load()) {
+    RebuildFilterLocked();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RebuildFilter() {
+  if (filter_.load() == nullptr) {
+    return;
+  }
+  std::unique_lock lock(filter_rebuild_latch_);
+  RebuildFilterLocked();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AddToFilterLocked(uint64_t hash) {
+  filter_.load()->Insert(hash);
+  if (filter_rebuilding_) {
+    std::scoped_lock lock(filter_pending_latch_);
+    filter_pending_.push_back(hash);
+  }
+}
+
+/*
+ * Inserts go on while the leaves are scanned. An insert that added its key
+ * to the old filter before the rebuild started has its key in the leaves by
+ * then, the ones after record it, and the recorded keys are added before the
+ * new filter is published. Lookups go on with the old filter until then, it
+ * is freed once none is left.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RebuildFilterLocked() {
+  {
+    std::unique_lock lock(filter_latch_);
+    filter_rebuilding_ = true;
+  }
+  std::vector<uint64_t> hashes;
+  auto cursor = ScanRange(std::nullopt, true, std::nullopt, true);
+  typename INDEXRANGECURSOR_TYPE::BatchType batch;
+  while (cursor.NextBatch(&batch)) {
+    for (const auto &entry : batch) {
+      hashes.push_back(KeyHash(entry.first));
+    }
+  }
+  auto capacity = std::max<size_t>(hashes.size() * 2, INDEX_BLOOM_FILTER_MIN_KEYS);
+  auto filter = std::make_unique<BloomFilter>(capacity);
+  for (auto hash : hashes) {
+    filter->Insert(hash);
+  }
+
+  std::unique_lock lock(filter_latch_);
+  for (auto hash : filter_pending_) {
+    filter->Insert(hash);
+  }
+  hashes.insert(hashes.end(), filter_pending_.begin(), filter_pending_.end());
+  filter_pending_.clear();
+  filter_rebuilding_ = false;
+  filter_capacity_ = capacity;
+  filter_keys_ = hashes.size();
+  auto *old_filter = filter_.exchange(filter.release());
+  // recounted before inserts go on, an insert that counted its key before the clear has it in hashes
+  if (distinct_keys_ != nullptr) {
+    distinct_keys_->Clear();
+    for (auto hash : hashes) {
+      distinct_keys_->Add(hash);
+    }
+  }
+  lock.unlock();
+  epoch_manager_.Retire([old_filter] {
+    delete old_filter;
+    return true;
+  });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetFilterByteCount() const -> size_t {
+  auto epoch = epoch_manager_.Enter();
+  auto *filter = filter_.load();
+  return filter == nullptr ? 0 : filter->GetByteCount();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetFilterFalsePositiveRate() const -> double {
+  auto epoch = epoch_manager_.Enter();
+  auto *filter = filter_.load();
+  return filter == nullptr ? 1 : filter->GetFalsePositiveRate();
+}
+
+/*****************************************************************************
+ * STATISTICS
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CountInsert(uint64_t hash) {
+  entry_count_++;
+  if (distinct_keys_ != nullptr) {
+    distinct_keys_->Add(hash);
+  }
+}
+
+/*
+ * A reader that reaches a page emptied by a merge starts over, see
+ * FindLeafRead.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetHeight() -> size_t {
+  if (entry_count_.load() == 0) {
+    return 0;
+  }
+  auto epoch = epoch_manager_.Enter();
+  while (true) {
+    page_id_t page_id;
+    {
+      auto guard = bpm_->FetchPageRead(header_page_id_);
+      page_id = guard.template As<BPlusTreeHeaderPage>()->root_page_id_;
+    }
+    size_t height = 0;
+    while (INVALID_PAGE_ID != page_id) {
+      auto guard = bpm_->FetchPageRead(page_id);
+      auto page = guard.template As<BPlusTreePage>();
+      if (page->IsInvalidPage()) {
+        break;
+      }
+      height++;
+      if (page->IsLeafPage()) {
+        return height;
+      }
+      page_id = guard.template As<InternalPage>()->ValueAt(0);
+    }
+    if (INVALID_PAGE_ID == page_id) {
+      return height;
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetDistinctKeyCount() const -> size_t {
+  auto entries = entry_count_.load();
+  if (distinct_keys_ == nullptr) {
+    return entries;
+  }
+  return std::min(distinct_keys_->Estimate(), entries);
 }
 
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
+/*
+ * The key goes into the Bloom filter before the tree, so a lookup never
+ * misses it once the insert returns.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
+  auto hash = KeyHash(key);
+  bool inserted;
+  if (filter_.load() == nullptr) {
+    inserted = InsertIntoTree(key, value, txn);
+  } else {
+    std::shared_lock lock(filter_latch_);
+    AddToFilterLocked(hash);
+    inserted = InsertIntoTree(key, value, txn);
+  }
+  if (inserted) {
+    CountInsert(hash);
+    GrowFilter(1);
+  }
+  return inserted;
+}
+
 /*
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
@@ -106,7 +440,8 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
+auto BPLUSTREE_TYPE::InsertIntoTree(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
+  auto epoch = epoch_manager_.Enter();
   // Declaration of context instance.
   Context ctx;
   (void)ctx;
@@ -120,6 +455,7 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     head_page->root_page_id_ = page_id;
     auto ppage = bguard.AsMut<LeafPage>();
     ppage->Init(leaf_max_size_);
+    leaf_page_count_++;
   }
   ctx.root_page_id_ = head_page->root_page_id_;
 
@@ -128,17 +464,12 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   while (!ppage->IsLeafPage()) {
     // pay attention to lvalue and rvalue
     ctx.write_set_.push_back(std::move(wguard));
-    auto cursize = ppage->GetSize();
-    int i = 1;
-    while (i < cursize && 0 <= comparator_(key, ppage->KeyAt(i))) {
-      ++i;
-    }
+    int i = ppage->UpperBound(key, comparator_);
     ctx.write_index_set_.push_back(i);
     wguard = bpm_->FetchPageWrite(ppage->ValueAt(i - 1));
     ppage = wguard.AsMut<InternalPage>();
   }
   auto ppage_lf = reinterpret_cast<LeafPage *>(ppage);
-  auto cursize = ppage_lf->GetSize();
   /* leaf_page insertion with a simple method*/
 
   // return normal inertion
@@ -173,15 +504,18 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   auto guard_lf1 = bpm_->FetchPageWrite(pid1);
   auto ppage_lf1 = guard_lf1.AsMut<LeafPage>();
   ppage_lf1->Init(leaf_max_size_);
+  leaf_page_count_++;
 
   {
-    int i = 0;
-    while (i < cursize && 0 <= comparator_(key, ppage_lf->KeyAt(i))) {
-      ++i;
-    }
+    int i = ppage_lf->KeyIndex(key, comparator_);
     ppage_lf->SpInsert(*ppage_lf1, i, key, value);
     ppage_lf1->SetNextPageId(ppage_lf->GetNextPageId());
+    ppage_lf1->SetPrevPageId(wguard.PageId());
+    ppage_lf1->SetLowKey(ppage_lf1->KeyAt(0));
+    ppage_lf1->SetHighKey(ppage_lf->GetHighKey());
     ppage_lf->SetNextPageId(pid1);
+    ppage_lf->SetHighKey(ppage_lf1->KeyAt(0));
+    SetLeafPrevPageId(ppage_lf1->GetNextPageId(), pid1);
   }
 
   auto upkey = ppage_lf1->KeyAt(0);
@@ -202,6 +536,11 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     auto ppage_inter = guard_inter.AsMut<InternalPage>();
     ppage_inter->Init(internal_max_size_);
     ppage->SpInsert(*ppage_inter, idx, upkey, pid_rt, upkey);
+    ppage_inter->SetNextPageId(ppage->GetNextPageId());
+    ppage_inter->SetLowKey(upkey);
+    ppage_inter->SetHighKey(ppage->GetHighKey());
+    ppage->SetNextPageId(pid1);
+    ppage->SetHighKey(upkey);
     pid_lf = ctx.write_set_.back().PageId();
     pid_rt = pid1;
     ctx.write_index_set_.pop_back();
@@ -225,6 +564,370 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   return true;
 }
 
+/*
+ * Insert a batch of key & value pairs. The batch is sorted, then for every
+ * leaf the keys falling within its bounds are merged into it in one pass.
+ * A leaf that overflows is split into as many pages as needed at once, and
+ * the new pages are inserted into the parent together.
+ * @return: the number of pairs inserted, pairs with a key already in the
+ * tree or earlier in the batch are skipped, same as Insert
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertBatch(std::vector<MappingType> entries, Transaction *txn) -> size_t {
+  std::stable_sort(entries.begin(), entries.end(), [this](const MappingType &lhs, const MappingType &rhs) {
+    return comparator_(lhs.first, rhs.first) < 0;
+  });
+  std::vector<uint64_t> hashes;
+  for (const auto &entry : entries) {
+    hashes.push_back(KeyHash(entry.first));
+  }
+  std::shared_lock filter_lock(filter_latch_, std::defer_lock);
+  if (filter_.load() != nullptr) {
+    filter_lock.lock();
+    for (auto hash : hashes) {
+      AddToFilterLocked(hash);
+    }
+  }
+
+  auto epoch = epoch_manager_.Enter();
+  size_t inserted = 0;
+  size_t pos = 0;
+  while (pos < entries.size()) {
+    Context ctx;
+    ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+    auto head_page = ctx.header_page_.value().AsMut<BPlusTreeHeaderPage>();
+    if (INVALID_PAGE_ID == head_page->root_page_id_) {
+      page_id_t page_id = INVALID_PAGE_ID;
+      auto bguard = bpm_->NewPageGuarded(&page_id);
+      head_page->root_page_id_ = page_id;
+      bguard.AsMut<LeafPage>()->Init(leaf_max_size_);
+      leaf_page_count_++;
+    }
+    ctx.root_page_id_ = head_page->root_page_id_;
+
+    const KeyType &first = entries[pos].first;
+    auto wguard = bpm_->FetchPageWrite(ctx.root_page_id_);
+    auto ppage = wguard.AsMut<InternalPage>();
+    while (!ppage->IsLeafPage()) {
+      ctx.write_set_.push_back(std::move(wguard));
+      int i = ppage->UpperBound(first, comparator_);
+      ctx.write_index_set_.push_back(i);
+      wguard = bpm_->FetchPageWrite(ppage->ValueAt(i - 1));
+      ppage = wguard.AsMut<InternalPage>();
+    }
+    auto ppage_lf = reinterpret_cast<LeafPage *>(ppage);
+
+    // merge the leaf with the keys of the batch below its high key
+    auto high = ppage_lf->GetHighKey();
+    std::vector<MappingType> merged;
+    int i = 0;
+    for (; pos < entries.size() && (!high.has_value() || comparator_(entries[pos].first, high.value()) < 0); ++pos) {
+      const auto &entry = entries[pos];
+      for (; i < ppage_lf->GetSize() && comparator_(ppage_lf->KeyAt(i), entry.first) < 0; ++i) {
+        merged.emplace_back(ppage_lf->KeyAt(i), ppage_lf->ValueAt(i));
+      }
+      bool duplicate = (i < ppage_lf->GetSize() && 0 == comparator_(ppage_lf->KeyAt(i), entry.first)) ||
+                       (!merged.empty() && 0 == comparator_(merged.back().first, entry.first));
+      if (!duplicate) {
+        merged.push_back(entry);
+        ++inserted;
+      }
+    }
+    for (; i < ppage_lf->GetSize(); ++i) {
+      merged.emplace_back(ppage_lf->KeyAt(i), ppage_lf->ValueAt(i));
+    }
+
+    // write the merged entries back, splitting the leaf if they do not fit
+    size_t count = merged.size();
+    size_t n = count <= static_cast<size_t>(leaf_max_size_)
+                   ? 1
+                   : PageCount(count, leaf_max_size_, leaf_max_size_ / 2, leaf_max_size_);
+
+    // release the header and the pages above the lowest one that takes the n - 1 new leaves without splitting,
+    // same as Insert, they are not written
+    size_t release = 0;
+    bool safe = n == 1;
+    if (safe) {
+      release = ctx.write_set_.size();
+    }
+    for (size_t k = ctx.write_set_.size(); !safe && k > 0; --k) {
+      auto parent = ctx.write_set_[k - 1].AsMut<InternalPage>();
+      if (static_cast<size_t>(parent->GetSize()) + n - 1 <= static_cast<size_t>(parent->GetMaxSize())) {
+        safe = true;
+        release = k - 1;
+      }
+    }
+    if (safe) {
+      ctx.header_page_.reset();
+    }
+    for (; release > 0; --release) {
+      ctx.write_set_.pop_front();
+      ctx.write_index_set_.pop_front();
+    }
+
+    std::vector<std::pair<KeyType, page_id_t>> children;
+    page_id_t next_page_id = ppage_lf->GetNextPageId();
+    page_id_t page_id = wguard.PageId();
+    LeafPage *page = ppage_lf;
+    BasicPageGuard new_guard;
+    size_t offset = 0;
+    for (size_t p = 0; p < n; ++p) {
+      int size = static_cast<int>(count / n + (p < count % n ? 1 : 0));
+      if (p > 0) {
+        page_id_t pid = INVALID_PAGE_ID;
+        auto guard = bpm_->NewPageGuarded(&pid);
+        page->SetNextPageId(pid);
+        page->SetHighKey(merged[offset].first);
+        page = guard.AsMut<LeafPage>();
+        page->Init(leaf_max_size_);
+        leaf_page_count_++;
+        page->SetPrevPageId(page_id);
+        page->SetLowKey(merged[offset].first);
+        page_id = pid;
+        children.emplace_back(merged[offset].first, pid);
+        new_guard = std::move(guard);
+      }
+      for (int j = 0; j < size; ++j) {
+        page->SetKeyAt(j, merged[offset + j].first);
+        page->SetValueAt(j, merged[offset + j].second);
+      }
+      page->SetSize(size);
+      offset += size;
+    }
+    page->SetNextPageId(next_page_id);
+    page->SetHighKey(high);
+    new_guard.Drop();
+    if (n > 1) {
+      SetLeafPrevPageId(next_page_id, page_id);
+    }
+
+    InsertChildren(&ctx, std::move(children), wguard.PageId());
+  }
+  if (filter_lock.owns_lock()) {
+    filter_lock.unlock();
+  }
+  // a key skipped by the batch is already in the tree, so counting it does not change the distinct keys
+  entry_count_ += inserted;
+  if (distinct_keys_ != nullptr) {
+    for (auto hash : hashes) {
+      distinct_keys_->Add(hash);
+    }
+  }
+  GrowFilter(inserted);
+  return inserted;
+}
+
+/*
+ * Build the tree bottom-up from key & value pairs sorted by key. Leaves are
+ * packed left to right up to fill_factor of their max size, then every
+ * internal level is built over the first keys of the level below, until a
+ * single page is left as the root.
+ * @return: false if the tree is not empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &entries, double fill_factor, Transaction *txn) -> bool {
+  auto header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto head_page = header_guard.AsMut<BPlusTreeHeaderPage>();
+  if (INVALID_PAGE_ID != head_page->root_page_id_) {
+    return false;
+  }
+  if (entries.empty()) {
+    return true;
+  }
+
+  auto target_size = [fill_factor](int max_size, int min_size) {
+    auto target = static_cast<int>(max_size * fill_factor);
+    return static_cast<size_t>(std::clamp(target, std::max(min_size, 1), max_size));
+  };
+
+  // first key and page id of every leaf
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  int min_size = leaf_max_size_ / 2;
+  size_t count = entries.size();
+  size_t n = PageCount(count, target_size(leaf_max_size_, min_size), min_size, leaf_max_size_);
+  size_t pos = 0;
+  BasicPageGuard prev_guard;
+  for (size_t i = 0; i < n; ++i) {
+    int size = static_cast<int>(count / n + (i < count % n ? 1 : 0));
+    page_id_t pid = INVALID_PAGE_ID;
+    auto guard = bpm_->NewPageGuarded(&pid);
+    auto leaf = guard.AsMut<LeafPage>();
+    leaf->Init(leaf_max_size_);
+    for (int j = 0; j < size; ++j) {
+      leaf->SetKeyAt(j, entries[pos + j].first);
+      leaf->SetValueAt(j, entries[pos + j].second);
+    }
+    leaf->IncreaseSize(size);
+    if (i > 0) {
+      prev_guard.AsMut<LeafPage>()->SetNextPageId(pid);
+      prev_guard.AsMut<LeafPage>()->SetHighKey(entries[pos].first);
+      leaf->SetPrevPageId(prev_guard.PageId());
+      leaf->SetLowKey(entries[pos].first);
+    }
+    level.emplace_back(entries[pos].first, pid);
+    pos += size;
+    prev_guard = std::move(guard);
+  }
+  prev_guard.Drop();
+
+  head_page->root_page_id_ =
+      BuildInternalLevels(std::move(level), target_size(internal_max_size_, std::max(internal_max_size_ / 2, 2)));
+  header_guard.Drop();
+  entry_count_ += count;
+  leaf_page_count_ += n;
+  if (distinct_keys_ != nullptr) {
+    for (const auto &entry : entries) {
+      distinct_keys_->Add(KeyHash(entry.first));
+    }
+  }
+  RebuildFilter();
+  return true;
+}
+
+/*
+ * A leaf underflows when it holds fewer than underflow_fill_ of its max size
+ * entries, and at least when it is empty. An internal page always has two
+ * children at least. The fill is at most half, so that an underflowing page
+ * and a sibling that can not lend it an entry always fit in one page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::UnderflowSize(const BPlusTreePage *page) const -> int {
+  auto size = static_cast<int>(page->GetMaxSize() * underflow_fill_);
+  return std::max(size, page->IsLeafPage() ? 1 : 2);
+}
+
+/*
+ * Point the prev link of leaf page_id back to prev_page_id, the caller holds
+ * the write latch of the page on its left. Nothing to do for an invalid page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetLeafPrevPageId(page_id_t page_id, page_id_t prev_page_id) {
+  if (INVALID_PAGE_ID == page_id) {
+    return;
+  }
+  auto guard = bpm_->FetchPageWrite(page_id);
+  guard.AsMut<LeafPage>()->SetPrevPageId(prev_page_id);
+}
+
+/*
+ * Deleting a page fails while it is pinned, by a writer that has not let go
+ * of it yet, so it is tried again the next time the epoch manager frees.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RetirePage(page_id_t page_id) {
+  epoch_manager_.Retire([bpm = bpm_, page_id] { return bpm->DeletePage(page_id); });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::PageCount(size_t count, size_t target, size_t min_size, size_t max_size) -> size_t {
+  size_t n = (count + target - 1) / target;
+  while (n > 1 && count / n < min_size && (count + n - 2) / (n - 1) <= max_size) {
+    --n;
+  }
+  return n;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BuildInternalLevels(std::vector<std::pair<KeyType, page_id_t>> level, size_t target)
+    -> page_id_t {
+  size_t min_size = std::max(internal_max_size_ / 2, 2);
+  while (level.size() > 1) {
+    size_t count = level.size();
+    size_t n = PageCount(count, target, min_size, internal_max_size_);
+    size_t pos = 0;
+    std::vector<std::pair<KeyType, page_id_t>> upper;
+    BasicPageGuard prev_guard;
+    for (size_t i = 0; i < n; ++i) {
+      int size = static_cast<int>(count / n + (i < count % n ? 1 : 0));
+      page_id_t pid = INVALID_PAGE_ID;
+      auto guard = bpm_->NewPageGuarded(&pid);
+      auto inter = guard.AsMut<InternalPage>();
+      inter->Init(internal_max_size_);
+      // the first key is invalid, it only keeps the first key of the subtree here
+      for (int j = 0; j < size; ++j) {
+        inter->SetKeyAt(j, level[pos + j].first);
+        inter->SetValueAt(j, level[pos + j].second);
+      }
+      inter->IncreaseSize(size);
+      if (i > 0) {
+        prev_guard.AsMut<InternalPage>()->SetNextPageId(pid);
+        prev_guard.AsMut<InternalPage>()->SetHighKey(level[pos].first);
+        inter->SetLowKey(level[pos].first);
+      }
+      upper.emplace_back(level[pos].first, pid);
+      pos += size;
+      prev_guard = std::move(guard);
+    }
+    prev_guard.Drop();
+    level = std::move(upper);
+  }
+  return level.front().second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertChildren(Context *ctx, std::vector<std::pair<KeyType, page_id_t>> children,
+                                    page_id_t split_page_id) {
+  while (!children.empty() && !ctx->write_set_.empty()) {
+    auto ppage = ctx->write_set_.back().AsMut<InternalPage>();
+    int idx = ctx->write_index_set_.back();
+    std::vector<std::pair<KeyType, page_id_t>> merged;
+    for (int i = 0; i < idx; ++i) {
+      merged.emplace_back(ppage->KeyAt(i), ppage->ValueAt(i));
+    }
+    merged.insert(merged.end(), children.begin(), children.end());
+    for (int i = idx; i < ppage->GetSize(); ++i) {
+      merged.emplace_back(ppage->KeyAt(i), ppage->ValueAt(i));
+    }
+    children.clear();
+
+    size_t count = merged.size();
+    size_t min_size = std::max(internal_max_size_ / 2, 2);
+    size_t n = count <= static_cast<size_t>(internal_max_size_)
+                   ? 1
+                   : PageCount(count, internal_max_size_, min_size, internal_max_size_);
+    auto high = ppage->GetHighKey();
+    page_id_t next_page_id = ppage->GetNextPageId();
+    InternalPage *page = ppage;
+    BasicPageGuard new_guard;
+    size_t offset = 0;
+    for (size_t p = 0; p < n; ++p) {
+      int size = static_cast<int>(count / n + (p < count % n ? 1 : 0));
+      if (p > 0) {
+        page_id_t pid = INVALID_PAGE_ID;
+        auto guard = bpm_->NewPageGuarded(&pid);
+        page->SetNextPageId(pid);
+        page->SetHighKey(merged[offset].first);
+        page = guard.AsMut<InternalPage>();
+        page->Init(internal_max_size_);
+        page->SetLowKey(merged[offset].first);
+        children.emplace_back(merged[offset].first, pid);
+        new_guard = std::move(guard);
+      }
+      for (int j = 0; j < size; ++j) {
+        page->SetKeyAt(j, merged[offset + j].first);
+        page->SetValueAt(j, merged[offset + j].second);
+      }
+      page->SetSize(size);
+      offset += size;
+    }
+    page->SetNextPageId(next_page_id);
+    page->SetHighKey(high);
+    new_guard.Drop();
+
+    split_page_id = ctx->write_set_.back().PageId();
+    ctx->write_set_.pop_back();
+    ctx->write_index_set_.pop_back();
+  }
+  if (children.empty()) {
+    return;
+  }
+
+  // the root was split
+  children.insert(children.begin(), {children.front().first, split_page_id});
+  auto root_page_id = BuildInternalLevels(std::move(children), internal_max_size_);
+  ctx->header_page_.value().AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -233,33 +936,41 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * If current tree is empty, return immediately.
  * If not, User needs to first find the right leaf page as deletion target, then
  * delete entry from leaf page. Remember to deal with redistribute or merge if
- * necessary.
+ * necessary: a page that drops below its underflow size borrows an entry from
+ * a sibling, or is merged with it, see UnderflowSize.
+ * A page emptied by a merge is marked invalid, and only deleted once no
+ * reader that read its page id before the merge is left: until then it may
+ * still reach it, and starts over, see FindLeafRead.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
+  auto epoch = epoch_manager_.Enter();
   // Declaration of context instance.
   Context ctx;
-  (void)ctx;
+  RemoveFromTree(key, &ctx);
+  // the merged pages are unlinked from the tree now, they are freed after the latches still held are released
+  for (auto page_id : ctx.deleted_pages_) {
+    RetirePage(page_id);
+  }
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveFromTree(const KeyType &key, Context *ctx) {
   // std::cout << "Remove:" << key << '\n';
-  ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
-  auto head_page = ctx.header_page_.value().AsMut<BPlusTreeHeaderPage>();
+  ctx->header_page_ = bpm_->FetchPageWrite(header_page_id_);
+  auto head_page = ctx->header_page_.value().AsMut<BPlusTreeHeaderPage>();
   if (INVALID_PAGE_ID == head_page->root_page_id_) {
     return;
   }
-  ctx.root_page_id_ = head_page->root_page_id_;
+  ctx->root_page_id_ = head_page->root_page_id_;
 
   auto wguard = bpm_->FetchPageWrite(head_page->root_page_id_);
   auto ppage = wguard.AsMut<InternalPage>();
   while (!ppage->IsLeafPage()) {
     // pay attention to lvalue and rvalue
-    ctx.write_set_.push_back(std::move(wguard));
-    auto cursize = ppage->GetSize();
-    int i = 1;
-    while (i < cursize && 0 <= comparator_(key, ppage->KeyAt(i))) {
-      ++i;
-    }
-    ctx.write_index_set_.push_back(i);
+    ctx->write_set_.push_back(std::move(wguard));
+    int i = ppage->UpperBound(key, comparator_);
+    ctx->write_index_set_.push_back(i);
     wguard = bpm_->FetchPageWrite(ppage->ValueAt(i - 1));
     ppage = wguard.AsMut<InternalPage>();
   }
@@ -267,33 +978,42 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
 
   // leaf page is root page
   auto pid_tmp_lf = wguard.PageId();
-  if (ctx.IsRootPage(pid_tmp_lf)) {
+  if (ctx->IsRootPage(pid_tmp_lf)) {
+    int size_root = ppage_lf->GetSize();
     ppage_lf->Remove(key, comparator_);
+    if (ppage_lf->GetSize() < size_root) {
+      entry_count_--;
+    }
     if (ppage_lf->GetSize() == 0) {
       bpm_->DeletePage(pid_tmp_lf);
       wguard.Drop();
       head_page->root_page_id_ = pid_tmp_lf;
-      ctx.root_page_id_ = head_page->root_page_id_;
+      ctx->root_page_id_ = head_page->root_page_id_;
     }
     return;
   }
 
   // leaf page is not root page
+  int size_lf = ppage_lf->GetSize();
   int res = ppage_lf->Remove(key, comparator_);
+  if (ppage_lf->GetSize() < size_lf) {
+    entry_count_--;
+  }
   // do not have the member or normal removal
-  if (0 == res) {
+  if (-1 != res && (ppage_lf->GetSize() == size_lf || ppage_lf->GetSize() >= UnderflowSize(ppage_lf))) {
     return;
   }
 
-  while (ctx.write_set_.size() > 1) {
-    auto itr_t = ctx.write_set_.begin() + 1;
+  // release the ancestors of the highest page that stays above its underflow size when it loses a child
+  while (ctx->write_set_.size() > 1) {
+    auto itr_t = ctx->write_set_.begin() + 1;
     auto page_t = itr_t->AsMut<InternalPage>();
-    if (page_t->GetSize() < page_t->GetMinSize()) {
-      if (ctx.IsRootPage(ctx.write_set_.front().PageId())) {
-        ctx.header_page_.reset();
+    if (page_t->GetSize() > UnderflowSize(page_t)) {
+      if (ctx->IsRootPage(ctx->write_set_.front().PageId())) {
+        ctx->header_page_.reset();
       }
-      ctx.write_set_.pop_front();
-      ctx.write_index_set_.pop_front();
+      ctx->write_set_.pop_front();
+      ctx->write_index_set_.pop_front();
       continue;
     }
     break;
@@ -305,14 +1025,14 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
   }
 
   /*redistribute or merge leaf page */
-  // if(ctx.write_set_.empty()){
+  // if(ctx->write_set_.empty()){
   //   //root page
   //   return;
   // }
 
   int idx_del = ~0;
-  int idx_2cur = ctx.write_index_set_.back();
-  auto ppage_p1 = ctx.write_set_.back().AsMut<InternalPage>();
+  int idx_2cur = ctx->write_index_set_.back();
+  auto ppage_p1 = ctx->write_set_.back().AsMut<InternalPage>();
   int size_p1 = ppage_p1->GetSize();
 
   if (idx_2cur == size_p1) {
@@ -320,17 +1040,21 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
     auto wguard_bro1 = bpm_->FetchPageWrite(ppage_p1->ValueAt(idx_2cur - 2));
     auto ppage_bro1 = wguard_bro1.template AsMut<LeafPage>();
     auto size_bro1 = ppage_bro1->GetSize();
-    if (size_bro1 > ppage_bro1->GetMinSize()) {
+    if (size_bro1 > UnderflowSize(ppage_bro1)) {
       auto key_bro1 = ppage_bro1->KeyAt(size_bro1 - 1);
       ppage_lf->Insert(key_bro1, ppage_bro1->ValueAt(size_bro1 - 1), comparator_);
       ppage_p1->SetKeyAt(idx_2cur - 1, key_bro1);
       ppage_bro1->IncreaseSize(-1);
+      ppage_bro1->SetHighKey(key_bro1);
+      ppage_lf->SetLowKey(key_bro1);
       return;
     }
     // merge leaf page
     ppage_bro1->Merge(*ppage_lf);
-    auto pid_tmp = wguard.PageId();
-    bpm_->DeletePage(pid_tmp);
+    SetLeafPrevPageId(ppage_bro1->GetNextPageId(), wguard_bro1.PageId());
+    ppage_lf->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
+    leaf_page_count_--;
+    ctx->deleted_pages_.push_back(wguard.PageId());
     wguard.Drop();
     idx_del = idx_2cur - 1;
   } else if (idx_2cur == 1) {
@@ -338,7 +1062,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
     auto wguard_bro2 = bpm_->FetchPageWrite(ppage_p1->ValueAt(idx_2cur));
     auto ppage_bro2 = wguard_bro2.template AsMut<LeafPage>();
     auto size_bro2 = ppage_bro2->GetSize();
-    if (size_bro2 > ppage_bro2->GetMinSize()) {
+    if (size_bro2 > UnderflowSize(ppage_bro2)) {
       auto key_bro2 = ppage_bro2->KeyAt(0);
       auto value_bro2 = ppage_bro2->ValueAt(0);
       ppage_bro2->Remove(key_bro2, comparator_);
@@ -346,30 +1070,36 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
       ppage_lf->SetValueAt(ppage_lf->GetSize(), value_bro2);
       ppage_lf->IncreaseSize(1);
       ppage_p1->SetKeyAt(idx_2cur, ppage_bro2->KeyAt(0));
+      ppage_lf->SetHighKey(ppage_bro2->KeyAt(0));
+      ppage_bro2->SetLowKey(ppage_bro2->KeyAt(0));
       return;
     }
     // merge leaf page
     ppage_lf->Merge(*ppage_bro2);
-    auto pid_tmp = wguard_bro2.PageId();
-    bpm_->DeletePage(pid_tmp);
+    ppage_bro2->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
+    leaf_page_count_--;
+    ctx->deleted_pages_.push_back(wguard_bro2.PageId());
     wguard_bro2.Drop();
+    SetLeafPrevPageId(ppage_lf->GetNextPageId(), wguard.PageId());
     idx_del = idx_2cur;
   } else {
     // leaf page mid
     auto wguard_bro1 = bpm_->FetchPageWrite(ppage_p1->ValueAt(idx_2cur - 2));
     auto ppage_bro1 = wguard_bro1.template AsMut<LeafPage>();
     auto size_bro1 = ppage_bro1->GetSize();
-    if (size_bro1 > ppage_bro1->GetMinSize()) {
+    if (size_bro1 > UnderflowSize(ppage_bro1)) {
       auto key_bro1 = ppage_bro1->KeyAt(size_bro1 - 1);
       ppage_lf->Insert(key_bro1, ppage_bro1->ValueAt(size_bro1 - 1), comparator_);
       ppage_p1->SetKeyAt(idx_2cur - 1, key_bro1);
       ppage_bro1->IncreaseSize(-1);
+      ppage_bro1->SetHighKey(key_bro1);
+      ppage_lf->SetLowKey(key_bro1);
       return;
     }
     auto wguard_bro2 = bpm_->FetchPageWrite(ppage_p1->ValueAt(idx_2cur));
     auto ppage_bro2 = wguard_bro2.template AsMut<LeafPage>();
     auto size_bro2 = ppage_bro2->GetSize();
-    if (size_bro2 > ppage_bro2->GetMinSize()) {
+    if (size_bro2 > UnderflowSize(ppage_bro2)) {
       auto key_bro2 = ppage_bro2->KeyAt(0);
       auto value_bro2 = ppage_bro2->ValueAt(0);
       ppage_bro2->Remove(key_bro2, comparator_);
@@ -377,43 +1107,48 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
       ppage_lf->SetValueAt(ppage_lf->GetSize(), value_bro2);
       ppage_lf->IncreaseSize(1);
       ppage_p1->SetKeyAt(idx_2cur, ppage_bro2->KeyAt(0));
+      ppage_lf->SetHighKey(ppage_bro2->KeyAt(0));
+      ppage_bro2->SetLowKey(ppage_bro2->KeyAt(0));
       return;
     }
-    // merge leaf page
+    // merge leaf page, the right sibling is still latched here
     ppage_bro1->Merge(*ppage_lf);
-    auto pid_tmp = wguard.PageId();
-    bpm_->DeletePage(pid_tmp);
+    ppage_bro2->SetPrevPageId(wguard_bro1.PageId());
+    ppage_lf->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
+    leaf_page_count_--;
+    ctx->deleted_pages_.push_back(wguard.PageId());
     wguard.Drop();
     idx_del = idx_2cur - 1;
   }
 
-  ctx.write_index_set_.pop_back();
+  ctx->write_index_set_.pop_back();
 
   /* internal page removal */
-  while (!ctx.write_set_.empty()) {
-    ppage = ctx.write_set_.back().AsMut<InternalPage>();
+  while (!ctx->write_set_.empty()) {
+    ppage = ctx->write_set_.back().AsMut<InternalPage>();
 
     // root page
-    if (ctx.IsRootPage(ctx.write_set_.back().PageId())) {
+    if (ctx->IsRootPage(ctx->write_set_.back().PageId())) {
       ppage->Remove(idx_del);
       int size_cur = ppage->GetSize();
       if (1 == size_cur) {
         head_page->root_page_id_ = ppage->ValueAt(0);
-        ctx.root_page_id_ = head_page->root_page_id_;
-        bpm_->DeletePage(ctx.write_set_.back().PageId());
-        ctx.write_set_.back().Drop();
+        ctx->root_page_id_ = head_page->root_page_id_;
+        ppage->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
+        ctx->deleted_pages_.push_back(ctx->write_set_.back().PageId());
+        ctx->write_set_.back().Drop();
       }
       return;
     }
 
     // not root page
-    res = ppage->Remove(idx_del);
-    if (0 == res) {
+    ppage->Remove(idx_del);
+    if (ppage->GetSize() >= UnderflowSize(ppage)) {
       return;
     }
 
-    auto ite_guard_p1 = ctx.write_set_.rbegin() + 1;
-    idx_2cur = ctx.write_index_set_.back();
+    auto ite_guard_p1 = ctx->write_set_.rbegin() + 1;
+    idx_2cur = ctx->write_index_set_.back();
     ppage_p1 = ite_guard_p1->AsMut<InternalPage>();
     size_p1 = ppage_p1->GetSize();
 
@@ -422,39 +1157,43 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
       auto wguard_bro1 = bpm_->FetchPageWrite(ppage_p1->ValueAt(idx_2cur - 2));
       auto ppage_bro1 = wguard_bro1.template AsMut<InternalPage>();
       auto size_bro1 = ppage_bro1->GetSize();
-      if (size_bro1 > ppage_bro1->GetMinSize()) {
+      if (size_bro1 > UnderflowSize(ppage_bro1)) {
         auto key_bro1 = ppage_bro1->KeyAt(size_bro1 - 1);
         auto value_bro1 = ppage_bro1->ValueAt(size_bro1 - 1);
         ppage_bro1->IncreaseSize(-1);
         ppage->Insert(1, ppage_p1->KeyAt(idx_2cur - 1), ppage->ValueAt(0));
         ppage->SetValueAt(0, value_bro1);
         ppage_p1->SetKeyAt(idx_2cur - 1, key_bro1);
+        ppage_bro1->SetHighKey(key_bro1);
+        ppage->SetLowKey(key_bro1);
         return;
       }
       // merge internal page
       ppage_bro1->Merge(*ppage_p1, idx_2cur - 1, *ppage);
-      auto pid_tmp = ctx.write_set_.back().PageId();
-      bpm_->DeletePage(pid_tmp);
-      ctx.write_set_.back().Drop();
+      ppage->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
+      ctx->deleted_pages_.push_back(ctx->write_set_.back().PageId());
+      ctx->write_set_.back().Drop();
       idx_del = idx_2cur - 1;
     } else if (idx_2cur == 1) {
       // page head
       auto wguard_bro2 = bpm_->FetchPageWrite(ppage_p1->ValueAt(idx_2cur));
       auto ppage_bro2 = wguard_bro2.template AsMut<InternalPage>();
       auto size_bro2 = ppage_bro2->GetSize();
-      if (size_bro2 > ppage_bro2->GetMinSize()) {
+      if (size_bro2 > UnderflowSize(ppage_bro2)) {
         ppage->SetKeyAt(ppage->GetSize(), ppage_p1->KeyAt(idx_2cur));
         ppage->SetValueAt(ppage->GetSize(), ppage_bro2->ValueAt(0));
         ppage->IncreaseSize(1);
         ppage_bro2->SetValueAt(0, ppage_bro2->ValueAt(1));
         ppage_p1->SetKeyAt(idx_2cur, ppage_bro2->KeyAt(1));
+        ppage->SetHighKey(ppage_bro2->KeyAt(1));
+        ppage_bro2->SetLowKey(ppage_bro2->KeyAt(1));
         ppage_bro2->Remove(1);
         return;
       }
       // merge internal page
       ppage->Merge(*ppage_p1, idx_2cur, *ppage_bro2);
-      auto pid_tmp = wguard_bro2.PageId();
-      bpm_->DeletePage(pid_tmp);
+      ppage_bro2->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
+      ctx->deleted_pages_.push_back(wguard_bro2.PageId());
       wguard_bro2.Drop();
       idx_del = idx_2cur;
     } else {
@@ -462,36 +1201,113 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
       auto wguard_bro1 = bpm_->FetchPageWrite(ppage_p1->ValueAt(idx_2cur - 2));
       auto ppage_bro1 = wguard_bro1.template AsMut<InternalPage>();
       auto size_bro1 = ppage_bro1->GetSize();
-      if (size_bro1 > ppage_bro1->GetMinSize()) {
+      if (size_bro1 > UnderflowSize(ppage_bro1)) {
         auto key_bro1 = ppage_bro1->KeyAt(size_bro1 - 1);
         auto value_bro1 = ppage_bro1->ValueAt(size_bro1 - 1);
         ppage_bro1->IncreaseSize(-1);
         ppage->Insert(1, ppage_p1->KeyAt(idx_2cur - 1), ppage->ValueAt(0));
         ppage->SetValueAt(0, value_bro1);
         ppage_p1->SetKeyAt(idx_2cur - 1, key_bro1);
+        ppage_bro1->SetHighKey(key_bro1);
+        ppage->SetLowKey(key_bro1);
         return;
       }
       auto wguard_bro2 = bpm_->FetchPageWrite(ppage_p1->ValueAt(idx_2cur));
       auto ppage_bro2 = wguard_bro2.template AsMut<InternalPage>();
       auto size_bro2 = ppage_bro2->GetSize();
-      if (size_bro2 > ppage_bro2->GetMinSize()) {
+      if (size_bro2 > UnderflowSize(ppage_bro2)) {
         ppage->SetKeyAt(ppage->GetSize(), ppage_p1->KeyAt(idx_2cur));
         ppage->SetValueAt(ppage->GetSize(), ppage_bro2->ValueAt(0));
         ppage->IncreaseSize(1);
         ppage_bro2->SetValueAt(0, ppage_bro2->ValueAt(1));
         ppage_p1->SetKeyAt(idx_2cur, ppage_bro2->KeyAt(1));
+        ppage->SetHighKey(ppage_bro2->KeyAt(1));
+        ppage_bro2->SetLowKey(ppage_bro2->KeyAt(1));
         ppage_bro2->Remove(1);
         return;
       }
       // merge internal page
       ppage_bro1->Merge(*ppage_p1, idx_2cur - 1, *ppage);
-      auto pid_tmp = ctx.write_set_.back().PageId();
-      bpm_->DeletePage(pid_tmp);
-      ctx.write_set_.back().Drop();
+      ppage->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
+      ctx->deleted_pages_.push_back(ctx->write_set_.back().PageId());
+      ctx->write_set_.back().Drop();
       idx_del = idx_2cur - 1;
     }
-    ctx.write_set_.pop_back();
-    ctx.write_index_set_.pop_back();
+    ctx->write_set_.pop_back();
+    ctx->write_index_set_.pop_back();
+  }
+}
+
+/*
+ * Merge adjacent leaves under the same parent while the merged leaf holds at
+ * most fill_factor of its max size. Meant to run in the background of a
+ * delete-heavy workload with a low underflow fill, which leaves sparse leaves
+ * behind. The parents are visited left to right, each reached by a descent
+ * with latch coupling and latched while its children are merged, so writers
+ * are only blocked out of one parent at a time. A parent keeps at least its
+ * underflow size (two children for the root), so that nothing above it
+ * changes. Internal pages are not compacted. The leaves merged away are
+ * freed once no reader is left that could still reach them, see Remove.
+ * @return: the number of leaves merged into their left sibling
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Compact(double fill_factor) -> size_t {
+  auto target_size = std::clamp(static_cast<int>(leaf_max_size_ * fill_factor), 1, leaf_max_size_);
+  auto epoch = epoch_manager_.Enter();
+  size_t merged = 0;
+  std::optional<KeyType> key;
+  while (true) {
+    // descend to the lowest internal page covering key, the leftmost one at first
+    WritePageGuard parent_guard;
+    bool is_root = true;
+    {
+      auto header_guard = bpm_->FetchPageRead(header_page_id_);
+      page_id_t root_page_id = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+      if (INVALID_PAGE_ID == root_page_id) {
+        return merged;
+      }
+      parent_guard = bpm_->FetchPageWrite(root_page_id);
+    }
+    if (parent_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      return merged;
+    }
+    while (true) {
+      auto inter = parent_guard.As<InternalPage>();
+      int i = key.has_value() ? inter->UpperBound(key.value(), comparator_) : 1;
+      auto child_guard = bpm_->FetchPageWrite(inter->ValueAt(i - 1));
+      if (child_guard.template As<BPlusTreePage>()->IsLeafPage()) {
+        break;
+      }
+      parent_guard = std::move(child_guard);
+      is_root = false;
+    }
+
+    auto parent = parent_guard.AsMut<InternalPage>();
+    int min_size = is_root ? 2 : UnderflowSize(parent);
+    for (int i = 0; i + 1 < parent->GetSize() && parent->GetSize() > min_size;) {
+      auto left_guard = bpm_->FetchPageWrite(parent->ValueAt(i));
+      auto right_guard = bpm_->FetchPageWrite(parent->ValueAt(i + 1));
+      auto left = left_guard.template AsMut<LeafPage>();
+      auto right = right_guard.template AsMut<LeafPage>();
+      if (left->GetSize() + right->GetSize() > target_size) {
+        ++i;
+        continue;
+      }
+      left->Merge(*right);
+      right->SetPageType(IndexPageType::INVALID_INDEX_PAGE);
+      leaf_page_count_--;
+      page_id_t right_page_id = right_guard.PageId();
+      right_guard.Drop();
+      SetLeafPrevPageId(left->GetNextPageId(), left_guard.PageId());
+      parent->Remove(i + 1);
+      RetirePage(right_page_id);
+      ++merged;
+    }
+
+    key = parent->GetHighKey();
+    if (!key.has_value()) {
+      return merged;
+    }
   }
 }
 
@@ -499,66 +1315,27 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  * INDEX ITERATOR
  *****************************************************************************/
 /*
- * Input parameter is void, find the leftmost leaf page first, then construct
- * index iterator
+ * Input parameter is void, construct an index iterator starting at the first
+ * entry of the leftmost leaf
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  // std::cout << "use tree.Begin()" << '\n';
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto root_page = guard.As<BPlusTreeHeaderPage>();
-  if (INVALID_PAGE_ID == root_page->root_page_id_) {
-    return INDEXITERATOR_TYPE(nullptr, BUSTUB_PAGE_SIZE, bpm_);
-  }
-  guard = bpm_->FetchPageRead(root_page->root_page_id_);
-  auto ppage = guard.As<InternalPage>();
-  if (0 == ppage->GetSize()) {
-    return INDEXITERATOR_TYPE(nullptr, BUSTUB_PAGE_SIZE, bpm_);
-  }
-  while (!ppage->IsLeafPage()) {
-    guard = bpm_->FetchPageRead(ppage->ValueAt(0));
-    ppage = guard.As<InternalPage>();
-  }
-  auto ppage_leaf = reinterpret_cast<const LeafPage *>(ppage);
-  return INDEXITERATOR_TYPE(const_cast<LeafPage *>(ppage_leaf), 0, bpm_);
+  return INDEXITERATOR_TYPE(ScanRange(std::nullopt, true, std::nullopt, true));
 }
 
 /*
- * Input parameter is low key, find the leaf page that contains the input key
- * first, then construct index iterator
- * @return : index iterator
+ * Input parameter is low key, construct an index iterator starting at the
+ * input key
+ * @return : index iterator, the end iterator if the key is not in the tree
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  // std::cout << "use tree.Begin(key), key =" << key << '\n';
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto root_page = guard.As<BPlusTreeHeaderPage>();
-  if (INVALID_PAGE_ID == root_page->root_page_id_) {
-    return INDEXITERATOR_TYPE(nullptr, BUSTUB_PAGE_SIZE, bpm_);
-  }
-  guard = bpm_->FetchPageRead(root_page->root_page_id_);
-  auto ppage = guard.As<InternalPage>();
-  if (0 == ppage->GetSize()) {
-    return INDEXITERATOR_TYPE(nullptr, BUSTUB_PAGE_SIZE, bpm_);
-  }
-  while (!ppage->IsLeafPage()) {
-    auto cursize = ppage->GetSize();
-    int i = 1;
-    while (i < cursize && 0 <= comparator_(key, ppage->KeyAt(i))) {
-      ++i;
-    }
-    guard = bpm_->FetchPageRead(ppage->ValueAt(i - 1));
-    ppage = guard.As<InternalPage>();
+  auto iter = INDEXITERATOR_TYPE(ScanRange(key, true, std::nullopt, true));
+  if (iter.IsEnd() || 0 != comparator_(key, (*iter).first)) {
+    return End();
   }
-  auto ppage_leaf = reinterpret_cast<const LeafPage *>(ppage);
-  auto cursize = ppage_leaf->GetSize();
-  for (int i = 0; i < cursize; ++i) {
-    if (0 == comparator_(key, ppage_leaf->KeyAt(i))) {
-      return INDEXITERATOR_TYPE(const_cast<LeafPage *>(ppage_leaf), i, bpm_);
-    }
-  }
-  return INDEXITERATOR_TYPE(nullptr, BUSTUB_PAGE_SIZE, bpm_);
+  return iter;
 }
 
 /*
@@ -569,7 +1346,39 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
   // std::cout << "use tree.End()" << '\n';
-  return INDEXITERATOR_TYPE(nullptr, BUSTUB_PAGE_SIZE, bpm_);
+  return INDEXITERATOR_TYPE();
+}
+
+/*
+ * Construct a cursor from the first key within the range (the last key for a
+ * reverse scan) to the other end of the range. An empty lo (or hi) leaves the
+ * range unbounded below (or above). The cursor finds its leaves with
+ * FindLeafRead, and stays in an epoch of the tree until it reaches its end.
+ * @return : index range cursor
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::ScanRange(const std::optional<KeyType> &lo, bool lo_inclusive, const std::optional<KeyType> &hi,
+                               bool hi_inclusive, bool reverse) -> INDEXRANGECURSOR_TYPE {
+  auto seek = [this, reverse](const std::optional<KeyType> &key, bool before) {
+    PageCopy page;
+    return FindLeafRead(key, reverse, &page, before);
+  };
+  if (reverse) {
+    return INDEXRANGECURSOR_TYPE(hi, hi_inclusive, lo, lo_inclusive, true, comparator_, bpm_, seek,
+                                 epoch_manager_.Enter());
+  }
+  return INDEXRANGECURSOR_TYPE(lo, lo_inclusive, hi, hi_inclusive, false, comparator_, bpm_, seek,
+                               epoch_manager_.Enter());
+}
+
+/*
+ * Input parameter is void, construct a reverse index iterator starting at the
+ * last entry of the rightmost leaf
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin() -> INDEXITERATOR_TYPE {
+  return INDEXITERATOR_TYPE(ScanRange(std::nullopt, true, std::nullopt, true, true));
 }
 
 /**
@@ -815,4 +1624,39 @@ template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+
+template class BPlusTree<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+
+template class BPlusTree<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+
+template class BPlusTree<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+template class BPlusTree<IntegerKey<int32_t, 1>, RID, IntegerKeyComparator<int32_t, 1>>;
+
+template class BPlusTree<IntegerKey<int64_t, 1>, RID, IntegerKeyComparator<int64_t, 1>>;
+
+template class BPlusTree<IntegerKey<int32_t, 2>, RID, IntegerKeyComparator<int32_t, 2>>;
+
+template class BPlusTree<NonUniqueKey<NormalizedKey<8>>, RID,
+                         NonUniqueComparator<NormalizedKey<8>, NormalizedComparator<8>>>;
+
+template class BPlusTree<NonUniqueKey<NormalizedKey<16>>, RID,
+                         NonUniqueComparator<NormalizedKey<16>, NormalizedComparator<16>>>;
+
+template class BPlusTree<NonUniqueKey<NormalizedKey<32>>, RID,
+                         NonUniqueComparator<NormalizedKey<32>, NormalizedComparator<32>>>;
+
+template class BPlusTree<NonUniqueKey<NormalizedKey<64>>, RID,
+                         NonUniqueComparator<NormalizedKey<64>, NormalizedComparator<64>>>;
+
+template class BPlusTree<NonUniqueKey<IntegerKey<int32_t, 1>>, RID,
+                         NonUniqueComparator<IntegerKey<int32_t, 1>, IntegerKeyComparator<int32_t, 1>>>;
+
+template class BPlusTree<NonUniqueKey<IntegerKey<int64_t, 1>>, RID,
+                         NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>>;
+
+template class BPlusTree<NonUniqueKey<IntegerKey<int32_t, 2>>, RID,
+                         NonUniqueComparator<IntegerKey<int32_t, 2>, IntegerKeyComparator<int32_t, 2>>>;
+
 }  // namespace bustub
@@ -9,6 +9,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <thread>  // NOLINT
+
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -17,7 +20,7 @@ namespace bustub {
  */
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
-    : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
+    : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()), change_buffer_(comparator_) {
   page_id_t header_page_id;
   buffer_pool_manager->NewPage(&header_page_id);
   container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(GetMetadata()->GetName(), header_page_id,
@@ -27,18 +30,39 @@ BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
   // construct insert index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
-
+  auto index_key = MakeKey(key, rid);
+  if (BufferChange(index_key, rid, true)) {
+    return true;
+  }
   return container_->Insert(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+auto BPLUSTREE_INDEX_TYPE::InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction)
+    -> size_t {
+  // construct insert index keys, the entries whose leaf is not resident are buffered instead
+  std::vector<std::pair<KeyType, RID>> index_entries;
+  index_entries.reserve(entries.size());
+  size_t buffered = 0;
+  for (const auto &[key, rid] : entries) {
+    auto index_key = MakeKey(key, rid);
+    if (BufferChange(index_key, rid, true)) {
+      buffered++;
+    } else {
+      index_entries.emplace_back(index_key, rid);
+    }
+  }
+
+  return buffered + container_->InsertBatch(std::move(index_entries), transaction);
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key, the rid picks the entry to delete in a non-unique index
+  auto index_key = MakeKey(key, rid);
+  if (BufferChange(index_key, rid, false)) {
+    return;
+  }
   container_->Remove(index_key, transaction);
 }
 
@@ -46,24 +70,191 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetMetadata()->GetKeySchema());
+  if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+    MergeChanges(index_key.LowerBound(), index_key.UpperBound());
+  }
 
   container_->GetValue(index_key, result, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_->Begin(); }
+auto BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<std::pair<KeyType, RID>> entries, Transaction *transaction,
+                                    double fill_factor) -> bool {
+  if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+    for (auto &[key, rid] : entries) {
+      key.SetRid(rid);
+    }
+  }
+  auto less = [this](const std::pair<KeyType, RID> &lhs, const std::pair<KeyType, RID> &rhs) {
+    return comparator_(lhs.first, rhs.first) < 0;
+  };
+  auto begin = entries.begin();
+  size_t size = entries.size();
+
+  // stable sort one run per thread, then merge the runs pairwise, so entries with the same key keep table order
+  size_t run_count = std::max(std::thread::hardware_concurrency(), 1U);
+  size_t run_size = std::max((size + run_count - 1) / run_count, static_cast<size_t>(BULK_LOAD_MIN_RUN_SIZE));
+  std::vector<std::thread> workers;
+  for (size_t lo = 0; lo < size; lo += run_size) {
+    size_t hi = std::min(lo + run_size, size);
+    workers.emplace_back([begin, lo, hi, &less] { std::stable_sort(begin + lo, begin + hi, less); });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  for (size_t width = run_size; width < size; width *= 2) {
+    for (size_t lo = 0; lo + width < size; lo += 2 * width) {
+      std::inplace_merge(begin + lo, begin + lo + width, begin + std::min(lo + 2 * width, size), less);
+    }
+  }
+
+  entries.erase(std::unique(entries.begin(), entries.end(),
+                            [this](const std::pair<KeyType, RID> &lhs, const std::pair<KeyType, RID> &rhs) {
+                              return comparator_(lhs.first, rhs.first) == 0;
+                            }),
+                entries.end());
+  return container_->BulkLoad(entries, fill_factor, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeKey(const Tuple &key, RID rid) const -> KeyType {
+  KeyType index_key;
+  index_key.SetFromKey(key, GetMetadata()->GetKeySchema());
+  if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+    index_key.SetRid(rid);
+  }
+  return index_key;
+}
+
+/*
+ * A change of a non-unique index is buffered if its leaf is not in the
+ * buffer pool, so that the write does not read the leaf from disk, or if
+ * its key has a buffered change already. A full buffer is merged at once.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BufferChange(const KeyType &key, RID rid, bool is_insert) -> bool {
+  if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+    if (!enable_index_change_buffer || !change_buffer_.Buffer(key, rid, is_insert, container_->IsLeafResident(key))) {
+      return false;
+    }
+    if (change_buffer_.GetSize() >= CHANGE_BUFFER_MAX_SIZE) {
+      change_buffer_.MergeAll(container_.get());
+    }
+    return true;
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::MergeChanges(const std::optional<KeyType> &lo, const std::optional<KeyType> &hi) {
+  if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+    change_buffer_.Merge(container_.get(), lo, hi);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::MergeChangeBuffer() { MergeChanges(std::nullopt, std::nullopt); }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE { return container_->Begin(key); }
+auto BPLUSTREE_INDEX_TYPE::GetStatistics() -> std::optional<IndexStatistics> {
+  return IndexStatistics{container_->GetEntryCount(), container_->GetHeight(), container_->GetLeafPageCount(),
+                         container_->GetDistinctKeyCount()};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE {
+  MergeChanges(std::nullopt, std::nullopt);
+  return container_->Begin();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE {
+  MergeChanges(key, std::nullopt);
+  return container_->Begin(key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() -> INDEXITERATOR_TYPE {
+  MergeChanges(std::nullopt, std::nullopt);
+  return container_->RBegin();
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetEndIterator() -> INDEXITERATOR_TYPE { return container_->End(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::ScanRange(const std::optional<KeyType> &lo, bool lo_inclusive,
+                                     const std::optional<KeyType> &hi, bool hi_inclusive, bool reverse)
+    -> INDEXRANGECURSOR_TYPE {
+  MergeChanges(lo, hi);
+  return container_->ScanRange(lo, lo_inclusive, hi, hi_inclusive, reverse);
+}
+
+/*
+ * The bound keys of a non-unique index carry the smallest or the largest RID,
+ * so that the range starts before (or after) every entry of lo and ends after
+ * (or before) every entry of hi.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::ScanKeyRange(const Tuple *lo, bool lo_inclusive, const Tuple *hi, bool hi_inclusive,
+                                        bool reverse) -> INDEXRANGECURSOR_TYPE {
+  auto make_bound = [this](const Tuple *key, bool lower) -> std::optional<KeyType> {
+    if (key == nullptr) {
+      return std::nullopt;
+    }
+    KeyType index_key;
+    index_key.SetFromKey(*key, GetMetadata()->GetKeySchema());
+    if constexpr (IS_NON_UNIQUE_KEY<KeyType>) {
+      return lower ? index_key.LowerBound() : index_key.UpperBound();
+    }
+    return index_key;
+  };
+  auto lo_key = make_bound(lo, lo_inclusive);
+  auto hi_key = make_bound(hi, !hi_inclusive);
+  MergeChanges(lo_key, hi_key);
+  return container_->ScanRange(lo_key, lo_inclusive, hi_key, hi_inclusive, reverse);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::EntryValues(const KeyType &entry) const -> std::vector<Value> {
+  auto *key_schema = GetMetadata()->GetKeySchema();
+  std::vector<Value> values;
+  values.reserve(key_schema->GetColumnCount());
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    values.push_back(entry.ToValue(key_schema, i));
+  }
+  return values;
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTreeIndex<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class BPlusTreeIndex<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class BPlusTreeIndex<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class BPlusTreeIndex<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+template class BPlusTreeIndex<IntegerKey<int32_t, 1>, RID, IntegerKeyComparator<int32_t, 1>>;
+template class BPlusTreeIndex<IntegerKey<int64_t, 1>, RID, IntegerKeyComparator<int64_t, 1>>;
+template class BPlusTreeIndex<IntegerKey<int32_t, 2>, RID, IntegerKeyComparator<int32_t, 2>>;
+
+template class BPlusTreeIndex<NonUniqueKey<NormalizedKey<8>>, RID,
+                              NonUniqueComparator<NormalizedKey<8>, NormalizedComparator<8>>>;
+template class BPlusTreeIndex<NonUniqueKey<NormalizedKey<16>>, RID,
+                              NonUniqueComparator<NormalizedKey<16>, NormalizedComparator<16>>>;
+template class BPlusTreeIndex<NonUniqueKey<NormalizedKey<32>>, RID,
+                              NonUniqueComparator<NormalizedKey<32>, NormalizedComparator<32>>>;
+template class BPlusTreeIndex<NonUniqueKey<NormalizedKey<64>>, RID,
+                              NonUniqueComparator<NormalizedKey<64>, NormalizedComparator<64>>>;
+template class BPlusTreeIndex<NonUniqueKey<IntegerKey<int32_t, 1>>, RID,
+                              NonUniqueComparator<IntegerKey<int32_t, 1>, IntegerKeyComparator<int32_t, 1>>>;
+template class BPlusTreeIndex<NonUniqueKey<IntegerKey<int64_t, 1>>, RID,
+                              NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>>;
+template class BPlusTreeIndex<NonUniqueKey<IntegerKey<int32_t, 2>>, RID,
+                              NonUniqueComparator<IntegerKey<int32_t, 2>, IntegerKeyComparator<int32_t, 2>>>;
+
 }  // namespace bustub
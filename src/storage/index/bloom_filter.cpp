@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.cpp
+//
+// Identification: src/storage/index/bloom_filter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/bloom_filter.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+
+namespace bustub {
+
+BloomFilter::BloomFilter(size_t num_keys, size_t bits_per_key)
+    : num_bits_(std::max<size_t>(num_keys * bits_per_key, WORD_BITS)),
+      num_probes_(std::clamp<size_t>(bits_per_key * 69 / 100, 1, 30)),
+      bits_((num_bits_ + WORD_BITS - 1) / WORD_BITS) {}
+
+void BloomFilter::Insert(uint64_t hash) {
+  // the probes step by the rotated hash, which is as good as a second hash function
+  auto delta = (hash >> 17) | (hash << 47);
+  for (size_t probe = 0; probe < num_probes_; probe++) {
+    auto bit = hash % num_bits_;
+    bits_[bit / WORD_BITS].fetch_or(uint64_t{1} << (bit % WORD_BITS), std::memory_order_relaxed);
+    hash += delta;
+  }
+}
+
+auto BloomFilter::MayContain(uint64_t hash) const -> bool {
+  auto delta = (hash >> 17) | (hash << 47);
+  for (size_t probe = 0; probe < num_probes_; probe++) {
+    auto bit = hash % num_bits_;
+    if ((bits_[bit / WORD_BITS].load(std::memory_order_relaxed) & (uint64_t{1} << (bit % WORD_BITS))) == 0) {
+      return false;
+    }
+    hash += delta;
+  }
+  return true;
+}
+
+auto BloomFilter::GetFalsePositiveRate() const -> double {
+  size_t set_bits = 0;
+  for (const auto &word : bits_) {
+    set_bits += std::bitset<WORD_BITS>(word.load(std::memory_order_relaxed)).count();
+  }
+  // a key that was never inserted passes if all of its probes hit set bits
+  return std::pow(static_cast<double>(set_bits) / static_cast<double>(num_bits_), static_cast<double>(num_probes_));
+}
+
+}  // namespace bustub
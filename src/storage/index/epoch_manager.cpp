@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.cpp
+//
+// Identification: src/storage/index/epoch_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/epoch_manager.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+EpochManager::Guard::Guard(const Guard &that) {
+  if (that.manager_ != nullptr) {
+    *this = that.manager_->Join(that.epoch_);
+  }
+}
+
+EpochManager::Guard::Guard(Guard &&that) noexcept
+    : manager_(std::exchange(that.manager_, nullptr)), epoch_(that.epoch_), slot_(that.slot_) {}
+
+auto EpochManager::Guard::operator=(const Guard &that) -> Guard & {
+  if (this != &that) {
+    Drop();
+    if (that.manager_ != nullptr) {
+      *this = that.manager_->Join(that.epoch_);
+    }
+  }
+  return *this;
+}
+
+auto EpochManager::Guard::operator=(Guard &&that) noexcept -> Guard & {
+  if (this != &that) {
+    Drop();
+    manager_ = std::exchange(that.manager_, nullptr);
+    epoch_ = that.epoch_;
+    slot_ = that.slot_;
+  }
+  return *this;
+}
+
+void EpochManager::Guard::Drop() {
+  if (manager_ != nullptr) {
+    manager_->Leave(slot_);
+    manager_ = nullptr;
+  }
+}
+
+EpochManager::~EpochManager() {
+  for (auto &[epoch, free] : retired_) {
+    free();
+  }
+}
+
+auto EpochManager::Enter() -> Guard { return Join(epoch_.load()); }
+
+/*
+ * The slot is published before the reader reads anything, so a Reclaim that
+ * misses it runs before the reader starts, after the unlink it frees for.
+ * Joining with an older epoch than the current one only frees later.
+ */
+auto EpochManager::Join(uint64_t epoch) -> Guard {
+  size_t start = std::hash<std::thread::id>{}(std::this_thread::get_id()) % SLOT_COUNT;
+  for (size_t i = 0; i < SLOT_COUNT; i++) {
+    size_t slot = (start + i) % SLOT_COUNT;
+    uint64_t expected = 0;
+    if (slots_[slot].epoch_.load() == 0 && slots_[slot].epoch_.compare_exchange_strong(expected, epoch)) {
+      return {this, epoch, slot};
+    }
+  }
+  overflow_++;
+  return {this, epoch, SLOT_COUNT};
+}
+
+void EpochManager::Leave(size_t slot) {
+  if (slot == SLOT_COUNT) {
+    overflow_--;
+  } else {
+    slots_[slot].epoch_.store(0);
+  }
+  if (retired_count_.load() == 0) {
+    return;
+  }
+  // a reader does not wait for another one freeing, whatever is left is freed by the next reader to leave
+  std::unique_lock lock(latch_, std::try_to_lock);
+  if (lock.owns_lock()) {
+    Reclaim();
+  }
+}
+
+void EpochManager::Retire(std::function<bool()> free) {
+  auto epoch = epoch_.fetch_add(1);
+  std::scoped_lock lock(latch_);
+  retired_.emplace_back(epoch, std::move(free));
+  retired_count_++;
+  Reclaim();
+}
+
+void EpochManager::Reclaim() {
+  if (overflow_.load() > 0) {
+    return;
+  }
+  auto oldest = std::numeric_limits<uint64_t>::max();
+  for (const auto &slot : slots_) {
+    if (auto epoch = slot.epoch_.load(); epoch != 0) {
+      oldest = std::min(oldest, epoch);
+    }
+  }
+  auto freed = std::remove_if(retired_.begin(), retired_.end(),
+                              [oldest](auto &retired) { return retired.first < oldest && retired.second(); });
+  retired_.erase(freed, retired_.end());
+  retired_count_ = retired_.size();
+}
+
+}  // namespace bustub
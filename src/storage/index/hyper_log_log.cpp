@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hyper_log_log.cpp
+//
+// Identification: src/storage/index/hyper_log_log.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/hyper_log_log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bustub {
+
+HyperLogLog::HyperLogLog(int precision_bits)
+    : precision_bits_(std::clamp(precision_bits, 4, 16)), registers_(size_t{1} << precision_bits_) {}
+
+void HyperLogLog::Add(uint64_t hash) {
+  auto index = hash >> (64 - precision_bits_);
+  // the rank of the rest of the hash, a sentinel bit bounds it when the rest is all zeros
+  auto rest = (hash << precision_bits_) | (uint64_t{1} << (precision_bits_ - 1));
+  auto rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+  auto &reg = registers_[index];
+  auto current = reg.load(std::memory_order_relaxed);
+  while (current < rank && !reg.compare_exchange_weak(current, rank, std::memory_order_relaxed)) {
+  }
+}
+
+/*
+ * The harmonic mean of 2^register over the registers, scaled by the bias
+ * correction of Flajolet et al. Small counts, which leave registers empty,
+ * are estimated by linear counting of the empty registers instead.
+ */
+auto HyperLogLog::Estimate() const -> size_t {
+  auto m = static_cast<double>(registers_.size());
+  double sum = 0;
+  size_t zeros = 0;
+  for (const auto &reg : registers_) {
+    auto rank = reg.load(std::memory_order_relaxed);
+    sum += std::ldexp(1.0, -rank);
+    zeros += rank == 0 ? 1 : 0;
+  }
+  auto alpha = 0.7213 / (1 + 1.079 / m);
+  auto estimate = alpha * m * m / sum;
+  if (estimate <= 2.5 * m && zeros > 0) {
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  }
+  return static_cast<size_t>(std::llround(estimate));
+}
+
+void HyperLogLog::Clear() {
+  for (auto &reg : registers_) {
+    reg.store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_change_buffer.cpp
+//
+// Identification: src/storage/index/index_change_buffer.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/index_change_buffer.h"
+
+#include <vector>
+
+#include "storage/index/integer_key.h"
+#include "storage/index/non_unique_key.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto INDEX_CHANGE_BUFFER_TYPE::Buffer(const KeyType &key, const ValueType &value, bool is_insert, bool leaf_resident)
+    -> bool {
+  std::scoped_lock lock(latch_);
+  auto iter = changes_.find(key);
+  if (iter != changes_.end()) {
+    iter->second = {value, is_insert};
+    return true;
+  }
+  if (leaf_resident) {
+    return false;
+  }
+  changes_.emplace(key, std::make_pair(value, is_insert));
+  size_++;
+  return true;
+}
+
+/*
+ * The latch is held until the changes are in the tree, so a reader never
+ * finds the buffer emptied before the tree has the changes, and a writer
+ * never applies a change of a key to the tree before its buffered change.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void INDEX_CHANGE_BUFFER_TYPE::Merge(Tree *tree, const std::optional<KeyType> &lo, const std::optional<KeyType> &hi) {
+  if (size_.load() == 0) {
+    return;
+  }
+  std::scoped_lock lock(latch_);
+  auto first = lo.has_value() ? changes_.lower_bound(lo.value()) : changes_.begin();
+  auto last = hi.has_value() ? changes_.upper_bound(hi.value()) : changes_.end();
+  if (first == last) {
+    return;
+  }
+  // every key has one change, so the removes and the inserts of the range commute
+  std::vector<std::pair<KeyType, ValueType>> inserts;
+  for (auto iter = first; iter != last; ++iter) {
+    if (iter->second.second) {
+      inserts.emplace_back(iter->first, iter->second.first);
+    } else {
+      tree->Remove(iter->first, nullptr);
+    }
+  }
+  if (!inserts.empty()) {
+    tree->InsertBatch(std::move(inserts));
+  }
+  size_ -= std::distance(first, last);
+  changes_.erase(first, last);
+}
+
+template class IndexChangeBuffer<NonUniqueKey<NormalizedKey<8>>, RID,
+                                 NonUniqueComparator<NormalizedKey<8>, NormalizedComparator<8>>>;
+template class IndexChangeBuffer<NonUniqueKey<NormalizedKey<16>>, RID,
+                                 NonUniqueComparator<NormalizedKey<16>, NormalizedComparator<16>>>;
+template class IndexChangeBuffer<NonUniqueKey<NormalizedKey<32>>, RID,
+                                 NonUniqueComparator<NormalizedKey<32>, NormalizedComparator<32>>>;
+template class IndexChangeBuffer<NonUniqueKey<NormalizedKey<64>>, RID,
+                                 NonUniqueComparator<NormalizedKey<64>, NormalizedComparator<64>>>;
+template class IndexChangeBuffer<NonUniqueKey<IntegerKey<int32_t, 1>>, RID,
+                                 NonUniqueComparator<IntegerKey<int32_t, 1>, IntegerKeyComparator<int32_t, 1>>>;
+template class IndexChangeBuffer<NonUniqueKey<IntegerKey<int64_t, 1>>, RID,
+                                 NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>>;
+template class IndexChangeBuffer<NonUniqueKey<IntegerKey<int32_t, 2>>, RID,
+                                 NonUniqueComparator<IntegerKey<int32_t, 2>, IntegerKeyComparator<int32_t, 2>>>;
+
+}  // namespace bustub
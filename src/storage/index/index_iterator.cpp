@@ -1,7 +1,9 @@
 /**
  * index_iterator.cpp
  */
+#include <algorithm>
 #include <cassert>
+#include <utility>
 
 #include "common/config.h"
 #include "storage/index/index_iterator.h"
@@ -13,35 +15,160 @@ namespace bustub {
  * set your own input parameters
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *page, int index,
-                                  BufferPoolManager *bpm)
-    : page_(page), index_(index), bpm_(bpm) {}
+INDEXITERATOR_TYPE::IndexIterator(INDEXRANGECURSOR_TYPE cursor) : cursor_(std::move(cursor)) { Load(); }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { return static_cast<bool>(page_ == nullptr && index_ == BUSTUB_PAGE_SIZE); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool {
+  return static_cast<bool>(page_id_ == INVALID_PAGE_ID && index_ == BUSTUB_PAGE_SIZE);
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return page_->MapAt(index_); }
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { return entries_[index_]; }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  if (index_ + 1 < page_->GetSize()) {
+  if (index_ + 1 < static_cast<int>(entries_.size())) {
     ++index_;
     return *this;
   }
-  if (page_->GetNextPageId() != INVALID_PAGE_ID) {
+  Load();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Load() {
+  if (cursor_.has_value() && cursor_->NextBatch(&entries_)) {
+    page_id_ = cursor_->GetPageId();
     index_ = 0;
-    auto guard = bpm_->FetchPageRead(page_->GetNextPageId());
-    page_ = const_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(
-        guard.template As<const BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>());
-    return *this;
+    return;
   }
-  page_ = nullptr;
+  cursor_.reset();
+  entries_.clear();
+  page_id_ = INVALID_PAGE_ID;
   index_ = BUSTUB_PAGE_SIZE;
-  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXRANGECURSOR_TYPE::IndexRangeCursor(std::optional<KeyType> start, bool start_inclusive,
+                                        std::optional<KeyType> bound, bool bound_inclusive, bool reverse,
+                                        const KeyComparator &comparator, BufferPoolManager *bpm, SeekFunction seek,
+                                        EpochManager::Guard epoch)
+    : from_(std::move(start)),
+      from_inclusive_(start_inclusive),
+      bound_(std::move(bound)),
+      bound_inclusive_(bound_inclusive),
+      reverse_(reverse),
+      comparator_(comparator),
+      bpm_(bpm),
+      seek_(std::move(seek)),
+      epoch_(std::move(epoch)) {}
+
+/*
+ * The leaf holding the entries right past from_ covers from_, it holds the
+ * keys from its low key up to its high key excluded. In a reverse scan past
+ * an excluded from_ it holds the keys just below from_ instead, from_ may be
+ * its high key. With no from_ yet it is the first leaf of the scan.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXRANGECURSOR_TYPE::Covers(const LeafPage *leaf) const -> bool {
+  if (leaf->IsInvalidPage() || !leaf->IsLeafPage()) {
+    return false;
+  }
+  auto low = leaf->GetLowKey();
+  auto high = leaf->GetHighKey();
+  if (!from_.has_value()) {
+    return reverse_ ? !high.has_value() : !low.has_value();
+  }
+  if (reverse_ && !from_inclusive_) {
+    return (!low.has_value() || comparator_(low.value(), from_.value()) < 0) &&
+           (!high.has_value() || comparator_(from_.value(), high.value()) <= 0);
+  }
+  return (!low.has_value() || comparator_(low.value(), from_.value()) <= 0) &&
+         (!high.has_value() || comparator_(from_.value(), high.value()) < 0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXRANGECURSOR_TYPE::IndexAfter(const LeafPage *leaf, const KeyType &key, bool past_key) const -> int {
+  int i = leaf->KeyIndex(key, comparator_);
+  if (past_key && i < leaf->GetSize() && 0 == comparator_(leaf->KeyAt(i), key)) {
+    ++i;
+  }
+  return i;
+}
+
+/*
+ * A leaf split after we read the link to it holds fewer keys, the keys past
+ * it are found by moving on as usual. A reverse scan would miss the keys
+ * split off to the right of it, so it seeks them instead. A leaf merged into
+ * its left sibling is invalid, and its keys are found by a seek too. A merge
+ * into the leaf just read is harmless, the keys it returned are filtered out
+ * by from_.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXRANGECURSOR_TYPE::NextBatch(std::vector<MappingType> *batch) -> bool {
+  batch->clear();
+  while (batch->empty() && !end_) {
+    if (page_id_ == INVALID_PAGE_ID) {
+      page_id_ = seek_(from_, reverse_ && from_.has_value() && !from_inclusive_);
+      if (page_id_ == INVALID_PAGE_ID) {
+        end_ = true;
+        break;
+      }
+    }
+    auto guard = bpm_->FetchPageRead(page_id_);
+    auto page = guard.template As<LeafPage>();
+    if (!Covers(page)) {
+      page_id_ = INVALID_PAGE_ID;
+      continue;
+    }
+    leaf_page_id_ = page_id_;
+
+    // entries [begin, end) of the leaf are within the range and not returned yet
+    int begin = 0;
+    int end = page->GetSize();
+    const auto &lower = reverse_ ? bound_ : from_;
+    const auto &upper = reverse_ ? from_ : bound_;
+    bool lower_inclusive = reverse_ ? bound_inclusive_ : from_inclusive_;
+    bool upper_inclusive = reverse_ ? from_inclusive_ : bound_inclusive_;
+    if (lower.has_value()) {
+      begin = IndexAfter(page, lower.value(), !lower_inclusive);
+    }
+    if (upper.has_value()) {
+      end = IndexAfter(page, upper.value(), upper_inclusive);
+    }
+    if (reverse_) {
+      for (int i = end - 1; i >= begin; --i) {
+        batch->emplace_back(page->KeyAt(i), page->ValueAt(i));
+      }
+    } else {
+      for (int i = begin; i < end; ++i) {
+        batch->emplace_back(page->KeyAt(i), page->ValueAt(i));
+      }
+    }
+
+    // the keys left are at or above the high key, or below the low key in a reverse scan, stop if none is in range
+    auto fence = reverse_ ? page->GetLowKey() : page->GetHighKey();
+    bool last = !fence.has_value();
+    if (!last && bound_.has_value()) {
+      int cmp = comparator_(fence.value(), bound_.value());
+      last = reverse_ ? cmp <= 0 : (cmp > 0 || (cmp == 0 && !bound_inclusive_));
+    }
+    if (last) {
+      end_ = true;
+    } else {
+      from_ = fence;
+      from_inclusive_ = !reverse_;
+      page_id_ = reverse_ ? page->GetPrevPageId() : page->GetNextPageId();
+    }
+  }
+  if (end_) {
+    // no leaf is read past the end, let the tree free the ones merged away
+    epoch_.Drop();
+  }
+  return !batch->empty();
 }
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
@@ -54,4 +181,84 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+
+template class IndexIterator<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+
+template class IndexIterator<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+
+template class IndexIterator<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+template class IndexIterator<IntegerKey<int32_t, 1>, RID, IntegerKeyComparator<int32_t, 1>>;
+
+template class IndexIterator<IntegerKey<int64_t, 1>, RID, IntegerKeyComparator<int64_t, 1>>;
+
+template class IndexIterator<IntegerKey<int32_t, 2>, RID, IntegerKeyComparator<int32_t, 2>>;
+
+template class IndexIterator<NonUniqueKey<NormalizedKey<8>>, RID,
+                             NonUniqueComparator<NormalizedKey<8>, NormalizedComparator<8>>>;
+
+template class IndexIterator<NonUniqueKey<NormalizedKey<16>>, RID,
+                             NonUniqueComparator<NormalizedKey<16>, NormalizedComparator<16>>>;
+
+template class IndexIterator<NonUniqueKey<NormalizedKey<32>>, RID,
+                             NonUniqueComparator<NormalizedKey<32>, NormalizedComparator<32>>>;
+
+template class IndexIterator<NonUniqueKey<NormalizedKey<64>>, RID,
+                             NonUniqueComparator<NormalizedKey<64>, NormalizedComparator<64>>>;
+
+template class IndexIterator<NonUniqueKey<IntegerKey<int32_t, 1>>, RID,
+                             NonUniqueComparator<IntegerKey<int32_t, 1>, IntegerKeyComparator<int32_t, 1>>>;
+
+template class IndexIterator<NonUniqueKey<IntegerKey<int64_t, 1>>, RID,
+                             NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>>;
+
+template class IndexIterator<NonUniqueKey<IntegerKey<int32_t, 2>>, RID,
+                             NonUniqueComparator<IntegerKey<int32_t, 2>, IntegerKeyComparator<int32_t, 2>>>;
+
+template class IndexRangeCursor<GenericKey<4>, RID, GenericComparator<4>>;
+
+template class IndexRangeCursor<GenericKey<8>, RID, GenericComparator<8>>;
+
+template class IndexRangeCursor<GenericKey<16>, RID, GenericComparator<16>>;
+
+template class IndexRangeCursor<GenericKey<32>, RID, GenericComparator<32>>;
+
+template class IndexRangeCursor<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class IndexRangeCursor<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+
+template class IndexRangeCursor<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+
+template class IndexRangeCursor<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+
+template class IndexRangeCursor<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+template class IndexRangeCursor<IntegerKey<int32_t, 1>, RID, IntegerKeyComparator<int32_t, 1>>;
+
+template class IndexRangeCursor<IntegerKey<int64_t, 1>, RID, IntegerKeyComparator<int64_t, 1>>;
+
+template class IndexRangeCursor<IntegerKey<int32_t, 2>, RID, IntegerKeyComparator<int32_t, 2>>;
+
+template class IndexRangeCursor<NonUniqueKey<NormalizedKey<8>>, RID,
+                                NonUniqueComparator<NormalizedKey<8>, NormalizedComparator<8>>>;
+
+template class IndexRangeCursor<NonUniqueKey<NormalizedKey<16>>, RID,
+                                NonUniqueComparator<NormalizedKey<16>, NormalizedComparator<16>>>;
+
+template class IndexRangeCursor<NonUniqueKey<NormalizedKey<32>>, RID,
+                                NonUniqueComparator<NormalizedKey<32>, NormalizedComparator<32>>>;
+
+template class IndexRangeCursor<NonUniqueKey<NormalizedKey<64>>, RID,
+                                NonUniqueComparator<NormalizedKey<64>, NormalizedComparator<64>>>;
+
+template class IndexRangeCursor<NonUniqueKey<IntegerKey<int32_t, 1>>, RID,
+                                NonUniqueComparator<IntegerKey<int32_t, 1>, IntegerKeyComparator<int32_t, 1>>>;
+
+template class IndexRangeCursor<NonUniqueKey<IntegerKey<int64_t, 1>>, RID,
+                                NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>>;
+
+template class IndexRangeCursor<NonUniqueKey<IntegerKey<int32_t, 2>>, RID,
+                                NonUniqueComparator<IntegerKey<int32_t, 2>, IntegerKeyComparator<int32_t, 2>>>;
+
 }  // namespace bustub
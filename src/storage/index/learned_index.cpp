@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// learned_index.cpp
+//
+// Identification: src/storage/index/learned_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/learned_index.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/exception.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LEARNED_INDEX_TYPE::LearnedIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(std::move(metadata)),
+      comparator_(GetMetadata()->GetKeySchema()),
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LEARNED_INDEX_TYPE::Build(std::vector<std::pair<KeyType, RID>> entries, bool is_unique) {
+  auto less = [this](const std::pair<KeyType, RID> &lhs, const std::pair<KeyType, RID> &rhs) {
+    return comparator_(lhs.first, rhs.first) < 0;
+  };
+  // entries with the same key keep table order
+  std::stable_sort(entries.begin(), entries.end(), less);
+  if (is_unique) {
+    entries.erase(std::unique(entries.begin(), entries.end(),
+                              [this](const std::pair<KeyType, RID> &lhs, const std::pair<KeyType, RID> &rhs) {
+                                return comparator_(lhs.first, rhs.first) == 0;
+                              }),
+                  entries.end());
+  }
+  container_.Build(entries);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LEARNED_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  throw NotImplementedException("a learned index is read-only");
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LEARNED_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  throw NotImplementedException("a learned index is read-only");
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LEARNED_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+  container_.GetValue(index_key, result);
+}
+
+template class LearnedIndex<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class LearnedIndex<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class LearnedIndex<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class LearnedIndex<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
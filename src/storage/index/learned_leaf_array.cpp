@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// learned_leaf_array.cpp
+//
+// Identification: src/storage/index/learned_leaf_array.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/learned_leaf_array.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "common/macros.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LEARNED_LEAF_ARRAY_TYPE::LeafReader {
+ public:
+  explicit LeafReader(const LearnedLeafArray *array) : array_(array) {}
+
+  auto KeyAt(size_t pos) -> KeyType { return Load(pos)->KeyAt(static_cast<int>(pos % array_->leaf_max_size_)); }
+
+  auto ValueAt(size_t pos) -> ValueType { return Load(pos)->ValueAt(static_cast<int>(pos % array_->leaf_max_size_)); }
+
+ private:
+  auto Load(size_t pos) -> const LeafPage * {
+    auto leaf = pos / array_->leaf_max_size_;
+    if (leaf != leaf_) {
+      guard_ = array_->bpm_->FetchPageRead(array_->page_ids_[leaf]);
+      leaf_ = leaf;
+    }
+    return guard_.template As<LeafPage>();
+  }
+
+  const LearnedLeafArray *array_;
+  size_t leaf_{std::numeric_limits<size_t>::max()};
+  ReadPageGuard guard_;
+};
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LEARNED_LEAF_ARRAY_TYPE::LearnedLeafArray(std::string name, BufferPoolManager *buffer_pool_manager,
+                                          const KeyComparator &comparator, int max_error, int leaf_max_size)
+    : index_name_(std::move(name)),
+      bpm_(buffer_pool_manager),
+      comparator_(comparator),
+      max_error_(max_error),
+      leaf_max_size_(leaf_max_size) {}
+
+/*****************************************************************************
+ * BUILD
+ *****************************************************************************/
+/*
+ * The model is fitted on the first entry of each prefix larger than every
+ * prefix before it. A segment keeps the range of slopes that predict all of
+ * its points within max_error, a point that empties the range starts the next
+ * segment, and the segment takes the middle of its range.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LEARNED_LEAF_ARRAY_TYPE::Build(const std::vector<std::pair<KeyType, ValueType>> &entries) {
+  BUSTUB_ASSERT(size_ == 0, "a learned leaf array is built once");
+
+  // the leaves are not read before the array is built, so they are written without latches
+  BasicPageGuard guard;
+  LeafPage *leaf = nullptr;
+  for (const auto &[key, value] : entries) {
+    if (leaf == nullptr || leaf->GetSize() == leaf_max_size_) {
+      page_id_t page_id;
+      auto next_guard = bpm_->NewPageGuarded(&page_id);
+      auto *next_leaf = next_guard.template AsMut<LeafPage>();
+      next_leaf->Init(leaf_max_size_);
+      if (leaf != nullptr) {
+        leaf->SetNextPageId(page_id);
+        next_leaf->SetPrevPageId(page_ids_.back());
+      }
+      guard = std::move(next_guard);
+      leaf = next_leaf;
+      page_ids_.push_back(page_id);
+    }
+    leaf->SetKeyAt(leaf->GetSize(), key);
+    leaf->SetValueAt(leaf->GetSize(), value);
+    leaf->IncreaseSize(1);
+  }
+  guard.Drop();
+  size_ = entries.size();
+
+  auto max_error = static_cast<double>(max_error_);
+  Segment segment{0, 0, 0};
+  double slope_lo = 0;
+  double slope_hi = std::numeric_limits<double>::infinity();
+  uint64_t last_prefix = 0;
+  for (size_t pos = 0; pos < size_; pos++) {
+    auto prefix = entries[pos].first.PrefixBits();
+    if (pos == 0) {
+      segment = Segment{prefix, 0, 0};
+      last_prefix = prefix;
+      continue;
+    }
+    if (prefix <= last_prefix) {
+      continue;
+    }
+    last_prefix = prefix;
+    auto dx = static_cast<double>(prefix - segment.first_prefix_);
+    auto dy = static_cast<double>(pos - segment.first_pos_);
+    auto lo = std::max(slope_lo, (dy - max_error) / dx);
+    auto hi = std::min(slope_hi, (dy + max_error) / dx);
+    if (lo <= hi) {
+      slope_lo = lo;
+      slope_hi = hi;
+      continue;
+    }
+    segment.slope_ = std::isinf(slope_hi) ? 0 : (slope_lo + slope_hi) / 2;
+    segments_.push_back(segment);
+    segment = Segment{prefix, 0, pos};
+    slope_lo = 0;
+    slope_hi = std::numeric_limits<double>::infinity();
+  }
+  if (size_ > 0) {
+    segment.slope_ = std::isinf(slope_hi) ? 0 : (slope_lo + slope_hi) / 2;
+    segments_.push_back(segment);
+  }
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LEARNED_LEAF_ARRAY_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result) -> bool {
+  LeafReader reader(this);
+  bool found = false;
+  for (auto pos = LowerBound(key, &reader); pos < size_ && comparator_(reader.KeyAt(pos), key) == 0; pos++) {
+    result->push_back(reader.ValueAt(pos));
+    found = true;
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LEARNED_LEAF_ARRAY_TYPE::Predict(uint64_t prefix) const -> size_t {
+  auto next = std::upper_bound(segments_.begin(), segments_.end(), prefix,
+                               [](uint64_t lhs, const Segment &rhs) { return lhs < rhs.first_prefix_; });
+  if (next == segments_.begin()) {
+    return 0;
+  }
+  const auto &segment = *(next - 1);
+  auto pos = static_cast<double>(segment.first_pos_) +
+             segment.slope_ * static_cast<double>(prefix - segment.first_prefix_);
+  // a key between two segments comes after every point of the first one
+  auto last = next == segments_.end() ? size_ : next->first_pos_;
+  return std::clamp(static_cast<size_t>(pos), segment.first_pos_, last);
+}
+
+/*
+ * The answer lies in [lo, hi] once lo is 0 or the entry before lo is less
+ * than key, and hi is size_ or the entry at hi is not less than key. The
+ * window around the prediction is widened until it does, doubling the step.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LEARNED_LEAF_ARRAY_TYPE::LowerBound(const KeyType &key, LeafReader *reader) const -> size_t {
+  if (size_ == 0) {
+    return 0;
+  }
+  auto max_error = static_cast<size_t>(max_error_);
+  auto pos = Predict(key.PrefixBits());
+  size_t lo = pos > max_error ? pos - max_error : 0;
+  size_t hi = std::min(pos + max_error + 1, size_);
+  size_t step = max_error + 1;
+  while (lo > 0 && comparator_(reader->KeyAt(lo - 1), key) >= 0) {
+    hi = lo - 1;
+    lo = lo > step ? lo - step : 0;
+    step *= 2;
+  }
+  while (hi < size_ && comparator_(reader->KeyAt(hi), key) < 0) {
+    lo = hi + 1;
+    hi = std::min(hi + step, size_);
+    step *= 2;
+  }
+  while (lo < hi) {
+    auto mid = lo + (hi - lo) / 2;
+    if (comparator_(reader->KeyAt(mid), key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template class LearnedLeafArray<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class LearnedLeafArray<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class LearnedLeafArray<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class LearnedLeafArray<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
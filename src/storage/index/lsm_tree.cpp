@@ -0,0 +1,329 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree.cpp
+//
+// Identification: src/storage/index/lsm_tree.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/lsm_tree.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class LSM_TREE_TYPE::RunCursor {
+ public:
+  RunCursor(BufferPoolManager *bpm, std::shared_ptr<const Run> run) : bpm_(bpm), run_(std::move(run)) { Load(); }
+
+  auto IsEnd() const -> bool { return page_idx_ == run_->page_ids_.size(); }
+
+  auto Get() -> const Entry & { return guard_.As<RunPage>()->EntryAt(slot_); }
+
+  void Next() {
+    if (++slot_ == guard_.As<RunPage>()->GetSize()) {
+      page_idx_++;
+      slot_ = 0;
+      Load();
+    }
+  }
+
+ private:
+  void Load() {
+    if (IsEnd()) {
+      guard_.Drop();
+    } else {
+      guard_ = bpm_->FetchPageRead(run_->page_ids_[page_idx_]);
+    }
+  }
+
+  BufferPoolManager *bpm_;
+  std::shared_ptr<const Run> run_;
+  size_t page_idx_{0};
+  int slot_{0};
+  ReadPageGuard guard_;
+};
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::LsmTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                       const HashFunction<KeyType> &hash_fn, bool unique_keys, size_t memtable_size)
+    : index_name_(std::move(name)),
+      bpm_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(hash_fn),
+      unique_keys_(unique_keys),
+      memtable_size_(memtable_size),
+      memtable_(EntryLess{comparator}) {
+  background_thread_ = std::thread(&LsmTree::BackgroundLoop, this);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_TYPE::~LsmTree() {
+  {
+    std::unique_lock lock(latch_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  background_thread_.join();
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_TREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result) -> bool {
+  std::shared_lock lock(latch_);
+  return GetValueLocked(key, result);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_TREE_TYPE::GetValueLocked(const KeyType &key, std::vector<ValueType> *result) -> bool {
+  // the newest entry of a value decides whether the key holds it
+  std::unordered_set<ValueType> seen;
+  bool found = false;
+  auto visit = [&](const ValueType &value, bool deleted) {
+    if (!seen.insert(value).second) {
+      return false;
+    }
+    if (!deleted) {
+      result->push_back(value);
+      found = true;
+    }
+    // a unique key holds at most one value
+    return found && unique_keys_;
+  };
+  auto scan_memtable = [&](const Memtable &memtable) {
+    for (auto iter = memtable.lower_bound(key); iter != memtable.end() && comparator_(iter->first.first, key) == 0;
+         ++iter) {
+      if (visit(iter->first.second, iter->second)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (scan_memtable(memtable_)) {
+    return true;
+  }
+  for (const auto &memtable : immutables_) {
+    if (scan_memtable(*memtable)) {
+      return true;
+    }
+  }
+  auto hash = hash_fn_.GetHash(key);
+  for (const auto &run : runs_) {
+    if (run->filter_.MayContain(hash) && ScanRun(*run, key, visit)) {
+      return true;
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visit>
+auto LSM_TREE_TYPE::ScanRun(const Run &run, const KeyType &key, Visit &&visit) -> bool {
+  // entries of the key may start on the page before the first one starting with a key that is not less than it
+  auto first = std::lower_bound(run.first_keys_.begin(), run.first_keys_.end(), key,
+                                [this](const KeyType &lhs, const KeyType &rhs) { return comparator_(lhs, rhs) < 0; });
+  auto page_idx = static_cast<size_t>(std::max<ptrdiff_t>(first - run.first_keys_.begin() - 1, 0));
+  for (; page_idx < run.page_ids_.size(); page_idx++) {
+    auto guard = bpm_->FetchPageRead(run.page_ids_[page_idx]);
+    const auto *page = guard.template As<RunPage>();
+    for (int slot = page->KeyIndex(key, comparator_); slot < page->GetSize(); slot++) {
+      const auto &entry = page->EntryAt(slot);
+      if (comparator_(entry.key_, key) != 0) {
+        return false;
+      }
+      if (visit(entry.value_, entry.deleted_)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVAL
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_TREE_TYPE::Insert(const KeyType &key, const ValueType &value) -> bool {
+  std::unique_lock lock(latch_);
+  if (unique_keys_) {
+    std::vector<ValueType> values;
+    if (GetValueLocked(key, &values)) {
+      return false;
+    }
+  }
+  memtable_[{key, value}] = false;
+  MaybeFreeze(&lock);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::Remove(const KeyType &key, const ValueType &value) {
+  std::unique_lock lock(latch_);
+  memtable_[{key, value}] = true;
+  MaybeFreeze(&lock);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::MaybeFreeze(std::unique_lock<std::shared_mutex> *lock, bool force) {
+  // writers wait for the background thread while too many memtables are waiting for a flush
+  while (!memtable_.empty() && (force || memtable_.size() >= memtable_size_)) {
+    if (immutables_.size() < LSM_MAX_IMMUTABLE_MEMTABLES) {
+      immutables_.push_front(std::make_shared<const Memtable>(std::move(memtable_)));
+      memtable_ = Memtable(EntryLess{comparator_});
+      cv_.notify_all();
+      return;
+    }
+    cv_.wait(*lock);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::Flush() {
+  std::unique_lock lock(latch_);
+  MaybeFreeze(&lock, true);
+  cv_.wait(lock, [this] { return immutables_.empty() && !background_busy_; });
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_TREE_TYPE::GetRunCount() -> size_t {
+  std::shared_lock lock(latch_);
+  return runs_.size();
+}
+
+/*****************************************************************************
+ * FLUSH AND COMPACTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::BackgroundLoop() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !immutables_.empty(); });
+    if (stop_) {
+      return;
+    }
+    background_busy_ = true;
+
+    // the oldest memtable is newer than every run, readers keep reading it until its run replaces it
+    auto memtable = immutables_.back();
+    lock.unlock();
+    auto iter = memtable->begin();
+    auto run = WriteRun(memtable->size(), [&](Entry *entry) {
+      if (iter == memtable->end()) {
+        return false;
+      }
+      *entry = Entry{iter->first.first, iter->first.second, iter->second};
+      ++iter;
+      return true;
+    });
+    lock.lock();
+    immutables_.pop_back();
+    runs_.push_front(run);
+    cv_.notify_all();
+
+    CompactRuns(&lock);
+    background_busy_ = false;
+    cv_.notify_all();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_TYPE::CompactRuns(std::unique_lock<std::shared_mutex> *lock) {
+  size_t count = 1;
+  size_t total = runs_.front()->size_;
+  while (count < runs_.size() && runs_[count]->size_ <= total * LSM_COMPACTION_RATIO) {
+    total += runs_[count++]->size_;
+  }
+  if (count < 2) {
+    return;
+  }
+  // only this thread changes the runs, the newest count runs stay the same while the latch is released
+  std::vector<std::shared_ptr<const Run>> inputs(runs_.begin(), runs_.begin() + count);
+  bool drop_tombstones = count == runs_.size();
+  lock->unlock();
+
+  std::vector<RunCursor> cursors;
+  cursors.reserve(inputs.size());
+  for (const auto &input : inputs) {
+    cursors.emplace_back(bpm_, input);
+  }
+  auto less = [this](const Entry &lhs, const Entry &rhs) {
+    auto res = comparator_(lhs.key_, rhs.key_);
+    return res != 0 ? res < 0 : lhs.value_.Get() < rhs.value_.Get();
+  };
+  auto merged = WriteRun(total, [&](Entry *entry) {
+    while (true) {
+      // the smallest entry, the newest of equal ones since the cursors are ordered from the newest run
+      RunCursor *smallest = nullptr;
+      for (auto &cursor : cursors) {
+        if (!cursor.IsEnd() && (smallest == nullptr || less(cursor.Get(), smallest->Get()))) {
+          smallest = &cursor;
+        }
+      }
+      if (smallest == nullptr) {
+        return false;
+      }
+      *entry = smallest->Get();
+      for (auto &cursor : cursors) {
+        while (!cursor.IsEnd() && comparator_(cursor.Get().key_, entry->key_) == 0 &&
+               cursor.Get().value_ == entry->value_) {
+          cursor.Next();
+        }
+      }
+      if (!drop_tombstones || !entry->deleted_) {
+        return true;
+      }
+    }
+  });
+  cursors.clear();
+
+  lock->lock();
+  runs_.erase(runs_.begin(), runs_.begin() + count);
+  if (merged->size_ > 0) {
+    runs_.push_front(merged);
+  }
+  // readers hold the latch while reading a run, none of them reads the inputs anymore
+  for (const auto &input : inputs) {
+    for (auto page_id : input->page_ids_) {
+      bpm_->DeletePage(page_id);
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Next>
+auto LSM_TREE_TYPE::WriteRun(size_t max_entries, Next &&next) -> std::shared_ptr<const Run> {
+  auto run = std::make_shared<Run>(max_entries);
+  BasicPageGuard guard;
+  RunPage *page = nullptr;
+  Entry entry;
+  while (next(&entry)) {
+    if (page == nullptr || page->IsFull()) {
+      page_id_t page_id;
+      guard = bpm_->NewPageGuarded(&page_id);
+      page = guard.template AsMut<RunPage>();
+      page->Init();
+      run->page_ids_.push_back(page_id);
+      run->first_keys_.push_back(entry.key_);
+    }
+    page->Append(entry);
+    run->filter_.Insert(hash_fn_.GetHash(entry.key_));
+    run->size_++;
+  }
+  return run;
+}
+
+template class LsmTree<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class LsmTree<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class LsmTree<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class LsmTree<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
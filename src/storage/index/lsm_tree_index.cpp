@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree_index.cpp
+//
+// Identification: src/storage/index/lsm_tree_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/lsm_tree_index.h"
+
+#include <vector>
+
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+LSM_TREE_INDEX_TYPE::LsmTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                                  const HashFunction<KeyType> &hash_fn, bool is_unique)
+    : Index(std::move(metadata)),
+      comparator_(GetMetadata()->GetKeySchema()),
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, hash_fn, is_unique) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_TREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+  return container_.Insert(index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+  container_.Remove(index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_TREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+  container_.GetValue(index_key, result);
+}
+
+template class LsmTreeIndex<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class LsmTreeIndex<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class LsmTreeIndex<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class LsmTreeIndex<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "common/config.h"
+#include "common/exception.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/index/varlen_b_plus_tree.h"
+#include "storage/page/b_plus_tree_header_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+using SlottedEntries = std::vector<std::pair<std::string, int64_t>>;
+
+VarlenBPlusTree::VarlenBPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager)
+    : index_name_(std::move(name)), bpm_(buffer_pool_manager), header_page_id_(header_page_id) {
+  WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
+  auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
+  root_page->root_page_id_ = INVALID_PAGE_ID;
+}
+
+/*
+ * Helper function to decide whether current b+tree is empty
+ */
+auto VarlenBPlusTree::IsEmpty() const -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  auto root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (INVALID_PAGE_ID == root_page_id) {
+    return true;
+  }
+  guard = bpm_->FetchPageRead(root_page_id);
+  return 0 == guard.As<BPlusTreeSlottedPage>()->GetSize();
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the only value that associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+auto VarlenBPlusTree::GetValue(const VarlenKey &key, std::vector<RID> *result, Transaction *txn) -> bool {
+  auto guard = FindLeafRead(key.data_, SearchMode::KEY);
+  if (!guard.has_value()) {
+    return false;
+  }
+  auto leaf = guard->As<BPlusTreeSlottedPage>();
+  int index = leaf->LowerBound(key.data_);
+  if (index == leaf->GetSize() || !leaf->StartsWithAt(index, key.data_)) {
+    return false;
+  }
+  result->emplace_back(leaf->ValueAt(index));
+  return true;
+}
+
+auto VarlenBPlusTree::FindLeafRead(std::string_view key, SearchMode mode, std::optional<std::string> *low_key)
+    -> std::optional<ReadPageGuard> {
+  ReadPageGuard header_guard = bpm_->FetchPageRead(header_page_id_);
+  auto root_page_id = header_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (INVALID_PAGE_ID == root_page_id) {
+    return std::nullopt;
+  }
+  if (low_key != nullptr) {
+    low_key->reset();
+  }
+  ReadPageGuard guard = bpm_->FetchPageRead(root_page_id);
+  header_guard.Drop();
+  auto page = guard.As<BPlusTreeSlottedPage>();
+  while (!page->IsLeafPage()) {
+    int index;
+    switch (mode) {
+      case SearchMode::KEY:
+        index = page->UpperBound(key) - 1;
+        break;
+      case SearchMode::BELOW:
+        index = page->LowerBound(key) - 1;
+        break;
+      default:
+        index = page->GetSize() - 1;
+    }
+    if (low_key != nullptr && index > 0) {
+      *low_key = page->KeyAt(index);
+    }
+    // the child is latched before the parent is released
+    guard = bpm_->FetchPageRead(page->ValueAt(index));
+    page = guard.As<BPlusTreeSlottedPage>();
+  }
+  return guard;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert constant key & value pair into b+ tree
+ * The pages on the path are write latched top down, and the latches of the
+ * ancestors are released as soon as a page is safe, i.e. it takes one more
+ * entry of any size without splitting.
+ * @return: since we only support unique key, if user try to insert duplicate
+ * keys return false, otherwise return true.
+ */
+auto VarlenBPlusTree::Insert(const VarlenKey &key, const RID &value, Transaction *txn, std::string_view payload)
+    -> bool {
+  if (key.data_.size() + payload.size() > SLOTTED_PAGE_MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "index entry is too long for a varlen B+ tree");
+  }
+  std::string entry_key = key.data_;
+  entry_key.append(payload);
+  Context ctx;
+  ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+  auto head_page = ctx.header_page_->AsMut<BPlusTreeHeaderPage>();
+  if (INVALID_PAGE_ID == head_page->root_page_id_) {
+    page_id_t page_id = INVALID_PAGE_ID;
+    auto guard = bpm_->NewPageGuarded(&page_id);
+    guard.AsMut<BPlusTreeSlottedPage>()->Init(0);
+    head_page->root_page_id_ = page_id;
+  }
+  ctx.root_page_id_ = head_page->root_page_id_;
+
+  ctx.write_set_.push_back(bpm_->FetchPageWrite(ctx.root_page_id_));
+  while (true) {
+    auto page = ctx.write_set_.back().As<BPlusTreeSlottedPage>();
+    if (page->IsInsertSafe()) {
+      ctx.header_page_.reset();
+      while (ctx.write_set_.size() > 1) {
+        ctx.write_set_.pop_front();
+      }
+    }
+    if (page->IsLeafPage()) {
+      break;
+    }
+    ctx.write_set_.push_back(bpm_->FetchPageWrite(page->ValueAt(page->UpperBound(key.data_) - 1)));
+  }
+
+  auto &leaf_guard = ctx.write_set_.back();
+  auto leaf = leaf_guard.AsMut<BPlusTreeSlottedPage>();
+  int index = leaf->LowerBound(key.data_);
+  if (index < leaf->GetSize() && leaf->StartsWithAt(index, key.data_)) {
+    return false;
+  }
+  if (leaf->Insert(index, entry_key, value.Get())) {
+    return true;
+  }
+
+  // split the leaf, the new leaf takes the upper half of the entries
+  auto entries = leaf->GetEntries();
+  entries.emplace(entries.begin() + index, std::move(entry_key), value.Get());
+  size_t split = SplitIndex(entries, true);
+  page_id_t page_id = INVALID_PAGE_ID;
+  auto new_guard = bpm_->NewPageGuarded(&page_id);
+  auto new_leaf = new_guard.AsMut<BPlusTreeSlottedPage>();
+  new_leaf->Init(0);
+  BUSTUB_ENSURE(new_leaf->SetEntries(entries.cbegin() + split, entries.cend()), "split leaf overflows");
+  BUSTUB_ENSURE(leaf->SetEntries(entries.cbegin(), entries.cbegin() + split), "split leaf overflows");
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  leaf->SetNextPageId(page_id);
+  new_guard.Drop();
+
+  // suffix truncation: the shortest prefix of the first key of the new leaf that is still larger than the last key
+  // of the old one separates them
+  const auto &left = entries[split - 1].first;
+  const auto &right = entries[split].first;
+  size_t common = std::mismatch(left.begin(), left.end(), right.begin(), right.end()).first - left.begin();
+  InsertIntoParent(&ctx, right.substr(0, common + 1), page_id);
+  return true;
+}
+
+/*
+ * The keys of a page share the common prefix of its first and last key, so the
+ * bytes each half of a split takes are known without building it. The split
+ * point is the one with the smallest larger half, which also moves a key that
+ * shortened the prefix of the page away from the keys that share it.
+ */
+auto VarlenBPlusTree::SplitIndex(const SlottedEntries &entries, bool leaf) -> size_t {
+  size_t size = entries.size();
+  std::vector<size_t> key_bytes(size + 1, 0);
+  for (size_t i = 0; i < size; i++) {
+    key_bytes[i + 1] = key_bytes[i] + entries[i].first.size();
+  }
+  // bytes of a page with slots entries and the valid keys [begin, end)
+  auto page_bytes = [&](size_t slots, size_t begin, size_t end) {
+    size_t bytes = SLOTTED_PAGE_HEADER_SIZE + slots * BPlusTreeSlottedPage::EntrySize(0) + key_bytes[end] -
+                   key_bytes[begin];
+    if (end - begin >= 2) {
+      const auto &first = entries[begin].first;
+      const auto &last = entries[end - 1].first;
+      size_t prefix = std::mismatch(first.begin(), first.end(), last.begin(), last.end()).first - first.begin();
+      bytes -= (end - begin - 1) * prefix;
+    }
+    return bytes;
+  };
+  // both halves keep at least one entry, the first half of an internal page at least one key besides its first entry,
+  // and the first key of the second half of an internal page moves up to the parent
+  size_t best = leaf ? 1 : 2;
+  size_t best_bytes = SIZE_MAX;
+  for (size_t split = best; split < size; split++) {
+    size_t bytes = leaf ? std::max(page_bytes(split, 0, split), page_bytes(size - split, split, size))
+                        : std::max(page_bytes(split, 1, split), page_bytes(size - split, split + 1, size));
+    if (bytes < best_bytes) {
+      best = split;
+      best_bytes = bytes;
+    }
+  }
+  return best;
+}
+
+void VarlenBPlusTree::InsertIntoParent(Context *ctx, std::string separator, page_id_t page_id) {
+  while (true) {
+    page_id_t split_page_id = ctx->write_set_.back().PageId();
+    int level = ctx->write_set_.back().As<BPlusTreeSlottedPage>()->GetLevel();
+    ctx->write_set_.pop_back();
+
+    if (ctx->write_set_.empty()) {
+      // the root split, grow the tree by one level
+      BUSTUB_ASSERT(ctx->header_page_.has_value() && ctx->IsRootPage(split_page_id), "root split without header latch");
+      page_id_t root_page_id = INVALID_PAGE_ID;
+      auto root_guard = bpm_->NewPageGuarded(&root_page_id);
+      auto root = root_guard.AsMut<BPlusTreeSlottedPage>();
+      root->Init(level + 1);
+      SlottedEntries children{{"", split_page_id}, {std::move(separator), page_id}};
+      BUSTUB_ENSURE(root->SetEntries(children.cbegin(), children.cend()), "new root overflows");
+      ctx->header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+      return;
+    }
+
+    auto parent = ctx->write_set_.back().AsMut<BPlusTreeSlottedPage>();
+    int index = parent->UpperBound(separator);
+    if (parent->Insert(index, separator, page_id)) {
+      return;
+    }
+
+    // split the internal page, the key in the middle moves up and becomes the invalid first key of the new page
+    auto entries = parent->GetEntries();
+    entries.emplace(entries.begin() + index, std::move(separator), page_id);
+    size_t split = SplitIndex(entries, false);
+    separator = std::move(entries[split].first);
+    entries[split].first.clear();
+    auto new_guard = bpm_->NewPageGuarded(&page_id);
+    auto new_page = new_guard.AsMut<BPlusTreeSlottedPage>();
+    new_page->Init(parent->GetLevel());
+    BUSTUB_ENSURE(new_page->SetEntries(entries.cbegin() + split, entries.cend()), "split internal page overflows");
+    BUSTUB_ENSURE(parent->SetEntries(entries.cbegin(), entries.cbegin() + split), "split internal page overflows");
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key
+ * If current tree is empty, return immediately.
+ * Readers latches are coupled down to the parent of the leaf, only the leaf is
+ * write latched. Pages are never merged, so the structure above the leaf does
+ * not change.
+ */
+void VarlenBPlusTree::Remove(const VarlenKey &key, Transaction *txn) {
+  ReadPageGuard parent_guard = bpm_->FetchPageRead(header_page_id_);
+  auto root_page_id = parent_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (INVALID_PAGE_ID == root_page_id) {
+    return;
+  }
+  WritePageGuard leaf_guard;
+  page_id_t page_id = root_page_id;
+  while (true) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<BPlusTreeSlottedPage>();
+    if (page->IsLeafPage()) {
+      // only the root is a leaf here, the header latch keeps it from splitting into a new root meanwhile
+      guard.Drop();
+      leaf_guard = bpm_->FetchPageWrite(page_id);
+      break;
+    }
+    page_id = page->ValueAt(page->UpperBound(key.data_) - 1);
+    if (page->GetLevel() == 1) {
+      leaf_guard = bpm_->FetchPageWrite(page_id);
+      break;
+    }
+    parent_guard = std::move(guard);
+  }
+  parent_guard.Drop();
+
+  auto leaf = leaf_guard.AsMut<BPlusTreeSlottedPage>();
+  int index = leaf->LowerBound(key.data_);
+  if (index < leaf->GetSize() && leaf->StartsWithAt(index, key.data_)) {
+    leaf->Remove(index);
+  }
+}
+
+/*****************************************************************************
+ * INDEX ITERATOR
+ *****************************************************************************/
+
+auto VarlenBPlusTree::ScanRange(const std::optional<VarlenKey> &lo, bool lo_inclusive,
+                                const std::optional<VarlenKey> &hi, bool hi_inclusive, bool reverse)
+    -> VarlenRangeCursor {
+  std::optional<std::string> lo_key;
+  if (lo.has_value()) {
+    lo_key = lo->data_;
+  }
+  std::optional<std::string> hi_key;
+  if (hi.has_value()) {
+    hi_key = hi->data_;
+  }
+  return {this, std::move(lo_key), lo_inclusive, std::move(hi_key), hi_inclusive, reverse};
+}
+
+VarlenRangeCursor::VarlenRangeCursor(VarlenBPlusTree *tree, std::optional<std::string> lo, bool lo_inclusive,
+                                     std::optional<std::string> hi, bool hi_inclusive, bool reverse)
+    : tree_(tree),
+      lo_(std::move(lo)),
+      lo_inclusive_(lo_inclusive),
+      hi_(std::move(hi)),
+      hi_inclusive_(hi_inclusive),
+      reverse_(reverse) {}
+
+auto VarlenRangeCursor::NextBatch(BatchType *batch) -> bool {
+  batch->clear();
+  while (batch->empty() && !done_) {
+    if (reverse_ ? !NextReverse(batch) : !NextForward(batch)) {
+      done_ = true;
+    }
+  }
+  return !batch->empty();
+}
+
+void VarlenRangeCursor::Emit(const std::string &key, int64_t value, BatchType *batch) const {
+  VarlenKey index_key;
+  index_key.data_ = key;
+  batch->emplace_back(std::move(index_key), RID(value));
+}
+
+/*
+ * Copy the entries of one leaf from lo_ on, lo_ then moves to the last key
+ * copied so that the next leaf starts right after it.
+ * @return false if the scan reached hi or the last leaf
+ */
+auto VarlenRangeCursor::NextForward(BatchType *batch) -> bool {
+  std::optional<ReadPageGuard> guard;
+  if (next_page_id_ == INVALID_PAGE_ID) {
+    guard = tree_->FindLeafRead(lo_.value_or(""), VarlenBPlusTree::SearchMode::KEY);
+    if (!guard.has_value()) {
+      return false;
+    }
+  } else {
+    guard = tree_->bpm_->FetchPageRead(next_page_id_);
+  }
+  auto leaf = guard->As<BPlusTreeSlottedPage>();
+  int index = !lo_.has_value() ? 0 : (lo_inclusive_ ? leaf->LowerBound(*lo_) : leaf->UpperBound(*lo_));
+  for (; index < leaf->GetSize(); index++) {
+    auto key = leaf->KeyAt(index);
+    if (hi_.has_value() && (hi_inclusive_ ? key > *hi_ : key >= *hi_)) {
+      return false;
+    }
+    Emit(key, leaf->ValueAt(index), batch);
+    lo_ = std::move(key);
+    lo_inclusive_ = false;
+  }
+  next_page_id_ = leaf->GetNextPageId();
+  return next_page_id_ != INVALID_PAGE_ID;
+}
+
+/*
+ * Leaves have no back links, so every batch descends again to the leaf that
+ * holds the largest key below hi_, and hi_ moves down to the smallest key copied.
+ * A leaf without any entry below hi_ moves hi_ down to its low key instead.
+ * @return false if the scan reached lo or the first leaf
+ */
+auto VarlenRangeCursor::NextReverse(BatchType *batch) -> bool {
+  std::optional<std::string> low_key;
+  std::optional<ReadPageGuard> guard;
+  if (!hi_.has_value()) {
+    guard = tree_->FindLeafRead("", VarlenBPlusTree::SearchMode::RIGHTMOST, &low_key);
+  } else {
+    guard = tree_->FindLeafRead(
+        *hi_, hi_inclusive_ ? VarlenBPlusTree::SearchMode::KEY : VarlenBPlusTree::SearchMode::BELOW, &low_key);
+  }
+  if (!guard.has_value()) {
+    return false;
+  }
+  auto leaf = guard->As<BPlusTreeSlottedPage>();
+  int index = !hi_.has_value() ? leaf->GetSize() : (hi_inclusive_ ? leaf->UpperBound(*hi_) : leaf->LowerBound(*hi_));
+  for (index--; index >= 0; index--) {
+    auto key = leaf->KeyAt(index);
+    if (lo_.has_value() && (lo_inclusive_ ? key < *lo_ : key <= *lo_)) {
+      return false;
+    }
+    Emit(key, leaf->ValueAt(index), batch);
+    hi_ = std::move(key);
+    hi_inclusive_ = false;
+  }
+  if (!batch->empty()) {
+    return true;
+  }
+  if (!low_key.has_value()) {
+    return false;
+  }
+  hi_ = std::move(low_key);
+  hi_inclusive_ = false;
+  return true;
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+
+/**
+ * @return Page id of the root of this tree
+ */
+auto VarlenBPlusTree::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
+
+auto VarlenBPlusTree::GetHeight() -> int {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  auto root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (INVALID_PAGE_ID == root_page_id) {
+    return 0;
+  }
+  guard = bpm_->FetchPageRead(root_page_id);
+  return guard.As<BPlusTreeSlottedPage>()->GetLevel() + 1;
+}
+
+}  // namespace bustub
@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.cpp
+//
+// Identification: src/storage/index/varlen_b_plus_tree_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/varlen_b_plus_tree_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+VarlenBPlusTreeIndex::VarlenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                           BufferPoolManager *buffer_pool_manager, bool is_unique)
+    : Index(std::move(metadata)), is_unique_(is_unique) {
+  page_id_t header_page_id;
+  buffer_pool_manager->NewPage(&header_page_id);
+  container_ = std::make_shared<VarlenBPlusTree>(GetMetadata()->GetName(), header_page_id, buffer_pool_manager);
+}
+
+auto VarlenBPlusTreeIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  // construct insert index key, the included columns follow the key in the leaf
+  if (GetMetadata()->GetIncludeColumnCount() == 0) {
+    return container_->Insert(MakeKey(key, rid), rid, transaction);
+  }
+  const auto *entry_schema = GetMetadata()->GetEntrySchema();
+  char buf[VARLEN_KEY_MAX_SIZE];
+  size_t offset = 0;
+  for (uint32_t i = GetMetadata()->GetKeySchema()->GetColumnCount(); i < entry_schema->GetColumnCount(); i++) {
+    NormalizedKeyCodec::EncodeValue(key.GetValue(entry_schema, i), buf, VARLEN_KEY_MAX_SIZE, &offset);
+  }
+  return container_->Insert(MakeKey(key, rid), rid, transaction, std::string_view(buf, offset));
+}
+
+void VarlenBPlusTreeIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key, the rid picks the entry to delete in a non-unique index
+  container_->Remove(MakeKey(key, rid), transaction);
+}
+
+void VarlenBPlusTreeIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  VarlenKey index_key;
+  index_key.SetFromKey(key, GetMetadata()->GetKeySchema());
+  if (is_unique_) {
+    container_->GetValue(index_key, result, transaction);
+    return;
+  }
+  // the entries of the key are ordered by RID and may span several leaves
+  auto cursor = ScanRange(index_key, true, index_key, true);
+  VarlenRangeCursor::BatchType batch;
+  while (cursor.NextBatch(&batch)) {
+    for (const auto &entry : batch) {
+      result->push_back(entry.second);
+    }
+  }
+}
+
+/*
+ * The bounds of a non-unique or covering index are extended past every entry of
+ * the bound key where the range includes hi or excludes lo, the bound keys are
+ * prefixes of the entries with the RID and included columns. No entry continues
+ * the bound key with RID_SIZE 0xff bytes: a RID is not negative and the
+ * encoding of a column starts with its null byte, never 0xff.
+ */
+auto VarlenBPlusTreeIndex::ScanRange(const std::optional<VarlenKey> &lo, bool lo_inclusive,
+                                     const std::optional<VarlenKey> &hi, bool hi_inclusive, bool reverse)
+    -> VarlenRangeCursor {
+  if (is_unique_ && GetMetadata()->GetIncludeColumnCount() == 0) {
+    return container_->ScanRange(lo, lo_inclusive, hi, hi_inclusive, reverse);
+  }
+  auto lo_key = lo;
+  if (lo_key.has_value() && !lo_inclusive) {
+    lo_key->AppendMaxRid();
+  }
+  auto hi_key = hi;
+  if (hi_key.has_value() && hi_inclusive) {
+    hi_key->AppendMaxRid();
+  }
+  return container_->ScanRange(lo_key, lo_inclusive, hi_key, hi_inclusive, reverse);
+}
+
+auto VarlenBPlusTreeIndex::ScanKeyRange(const Tuple *lo, bool lo_inclusive, const Tuple *hi, bool hi_inclusive,
+                                        bool reverse) -> VarlenRangeCursor {
+  auto make_bound = [this](const Tuple *key) -> std::optional<VarlenKey> {
+    if (key == nullptr) {
+      return std::nullopt;
+    }
+    VarlenKey index_key;
+    index_key.SetFromKey(*key, GetMetadata()->GetKeySchema());
+    return index_key;
+  };
+  return ScanRange(make_bound(lo), lo_inclusive, make_bound(hi), hi_inclusive, reverse);
+}
+
+auto VarlenBPlusTreeIndex::EntryValues(const VarlenKey &entry) const -> std::vector<Value> {
+  const auto *entry_schema = GetMetadata()->GetEntrySchema();
+  auto key_column_count = GetMetadata()->GetKeySchema()->GetColumnCount();
+  std::vector<Value> values;
+  values.reserve(entry_schema->GetColumnCount());
+  size_t offset = 0;
+  for (uint32_t i = 0; i < entry_schema->GetColumnCount(); i++) {
+    if (i == key_column_count && !is_unique_) {
+      offset += VarlenKey::RID_SIZE;
+    }
+    values.push_back(NormalizedKeyCodec::DecodeValue(entry_schema->GetColumn(i).GetType(), entry.data_.data(),
+                                                     entry.data_.size(), &offset));
+  }
+  return values;
+}
+
+auto VarlenBPlusTreeIndex::MakeKey(const Tuple &key, RID rid) const -> VarlenKey {
+  VarlenKey index_key;
+  index_key.SetFromKey(key, GetMetadata()->GetKeySchema());
+  if (!is_unique_) {
+    index_key.AppendRid(rid);
+  }
+  return index_key;
+}
+
+}  // namespace bustub
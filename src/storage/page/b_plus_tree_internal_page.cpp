@@ -31,6 +31,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
   SetPageType(IndexPageType::INTERNAL_PAGE);
   SetSize(0);
   SetMaxSize(max_size);
+  next_page_id_ = INVALID_PAGE_ID;
+  fence_flags_ = 0;
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
@@ -50,6 +52,52 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { (
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { (array_ + index)->second = value; }
+/*
+ * Helper methods to set/get the right sibling link and the fence keys, an
+ * empty key clears the fence
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetLowKey() const -> std::optional<KeyType> {
+  if ((fence_flags_ & LOW_KEY_FENCE) == 0) {
+    return std::nullopt;
+  }
+  return low_key_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetLowKey(const std::optional<KeyType> &key) {
+  if (key.has_value()) {
+    low_key_ = key.value();
+    fence_flags_ |= LOW_KEY_FENCE;
+  } else {
+    fence_flags_ &= ~LOW_KEY_FENCE;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const -> std::optional<KeyType> {
+  if ((fence_flags_ & HIGH_KEY_FENCE) == 0) {
+    return std::nullopt;
+  }
+  return high_key_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const std::optional<KeyType> &key) {
+  if (key.has_value()) {
+    high_key_ = key.value();
+    fence_flags_ |= HIGH_KEY_FENCE;
+  } else {
+    fence_flags_ &= ~HIGH_KEY_FENCE;
+  }
+}
+
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
@@ -57,6 +105,22 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &valu
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return (array_ + index)->second; }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::UpperBound(const KeyType &key, const KeyComparator &comparator) const -> int {
+  // search in [1, size), the first key is invalid
+  int left = 1;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(key, array_[mid].first) >= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(int index, const KeyType &key, const ValueType &value) -> int {
   if (GetSize() >= GetMaxSize()) {
@@ -124,6 +188,8 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Merge(BPlusTreeInternalPage &page_p, int in
     memcpy(reinterpret_cast<void *>(array_ + mysize + 1), reinterpret_cast<void *>(page_bro.array_ + 1), cp_size);
   }
   IncreaseSize(brosize);
+  next_page_id_ = page_bro.next_page_id_;
+  SetHighKey(page_bro.GetHighKey());
   return 0;
 }
 // valuetype for internalNode should be page id_t
@@ -132,4 +198,25 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<NormalizedKey<8>, page_id_t, NormalizedComparator<8>>;
+template class BPlusTreeInternalPage<NormalizedKey<16>, page_id_t, NormalizedComparator<16>>;
+template class BPlusTreeInternalPage<NormalizedKey<32>, page_id_t, NormalizedComparator<32>>;
+template class BPlusTreeInternalPage<NormalizedKey<64>, page_id_t, NormalizedComparator<64>>;
+template class BPlusTreeInternalPage<IntegerKey<int32_t, 1>, page_id_t, IntegerKeyComparator<int32_t, 1>>;
+template class BPlusTreeInternalPage<IntegerKey<int64_t, 1>, page_id_t, IntegerKeyComparator<int64_t, 1>>;
+template class BPlusTreeInternalPage<IntegerKey<int32_t, 2>, page_id_t, IntegerKeyComparator<int32_t, 2>>;
+template class BPlusTreeInternalPage<NonUniqueKey<NormalizedKey<8>>, page_id_t,
+                                     NonUniqueComparator<NormalizedKey<8>, NormalizedComparator<8>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<NormalizedKey<16>>, page_id_t,
+                                     NonUniqueComparator<NormalizedKey<16>, NormalizedComparator<16>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<NormalizedKey<32>>, page_id_t,
+                                     NonUniqueComparator<NormalizedKey<32>, NormalizedComparator<32>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<NormalizedKey<64>>, page_id_t,
+                                     NonUniqueComparator<NormalizedKey<64>, NormalizedComparator<64>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<IntegerKey<int32_t, 1>>, page_id_t,
+                                     NonUniqueComparator<IntegerKey<int32_t, 1>, IntegerKeyComparator<int32_t, 1>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<IntegerKey<int64_t, 1>>, page_id_t,
+                                     NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>>;
+template class BPlusTreeInternalPage<NonUniqueKey<IntegerKey<int32_t, 2>>, page_id_t,
+                                     NonUniqueComparator<IntegerKey<int32_t, 2>, IntegerKeyComparator<int32_t, 2>>>;
 }  // namespace bustub
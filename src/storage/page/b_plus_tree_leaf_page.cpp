@@ -29,7 +29,7 @@ namespace bustub {
 
 /**
  * Init method after creating a new leaf page
- * Including set page type, set current size to zero, set next page id and set max size
+ * Including set page type, set current size to zero, set next/prev page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(int max_size) {
@@ -37,6 +37,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(int max_size) {
   SetSize(0);
   SetMaxSize(max_size);
   next_page_id_ = INVALID_PAGE_ID;
+  prev_page_id_ = INVALID_PAGE_ID;
+  fence_flags_ = 0;
 }
 
 /**
@@ -48,6 +50,54 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return nex
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+/**
+ * Helper methods to set/get prev page id
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const -> page_id_t { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+
+/**
+ * Helper methods to set/get the fence keys, an empty key clears the fence
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetLowKey() const -> std::optional<KeyType> {
+  if ((fence_flags_ & LOW_KEY_FENCE) == 0) {
+    return std::nullopt;
+  }
+  return low_key_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetLowKey(const std::optional<KeyType> &key) {
+  if (key.has_value()) {
+    low_key_ = key.value();
+    fence_flags_ |= LOW_KEY_FENCE;
+  } else {
+    fence_flags_ &= ~LOW_KEY_FENCE;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetHighKey() const -> std::optional<KeyType> {
+  if ((fence_flags_ & HIGH_KEY_FENCE) == 0) {
+    return std::nullopt;
+  }
+  return high_key_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetHighKey(const std::optional<KeyType> &key) {
+  if (key.has_value()) {
+    high_key_ = key.value();
+    fence_flags_ |= HIGH_KEY_FENCE;
+  } else {
+    fence_flags_ &= ~HIGH_KEY_FENCE;
+  }
+}
+
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
@@ -67,19 +117,29 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) -> void
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) -> void { array_[index].second = value; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int left = 0;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
     -> int {
-  int index = 0;
   int mysize = GetSize();
-  for (; index < mysize; ++index) {
-    auto res = comparator((array_ + index)->first, key);
-    if (0 == res) {
-      return 1;
-    }
-    if (0 < res) {
-      break;
-    }
+  int index = KeyIndex(key, comparator);
+  if (index < mysize && 0 == comparator((array_ + index)->first, key)) {
+    return 1;
   }
   if (mysize >= GetMaxSize()) {
     return -1;
@@ -129,20 +189,16 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator
   if (mysize == 0) {
     return -1;
   }
-  int index = 0;
-  for (; index < mysize; ++index) {
-    auto res = comparator((array_ + index)->first, key);
-    if (0 == res) {
-      if (index != mysize - 1) {
-        int cp_size = sizeof(MappingType) * (GetSize() - index - 1);
-        // 同一段内存不要用memcpy
-        memmove(reinterpret_cast<void *>(array_ + index), reinterpret_cast<void *>(array_ + index + 1), cp_size);
-      }
-      IncreaseSize(-1);
-      if (GetSize() < GetMinSize()) {
-        return 1;
-      }
-      return 0;
+  int index = KeyIndex(key, comparator);
+  if (index < mysize && 0 == comparator((array_ + index)->first, key)) {
+    if (index != mysize - 1) {
+      int cp_size = sizeof(MappingType) * (GetSize() - index - 1);
+      // 同一段内存不要用memcpy
+      memmove(reinterpret_cast<void *>(array_ + index), reinterpret_cast<void *>(array_ + index + 1), cp_size);
+    }
+    IncreaseSize(-1);
+    if (GetSize() < GetMinSize()) {
+      return 1;
     }
   }
   return 0;
@@ -156,6 +212,7 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Merge(BPlusTreeLeafPage &page) -> int {
     IncreaseSize(page.GetSize());
   }
   next_page_id_ = page.next_page_id_;
+  SetHighKey(page.GetHighKey());
   return 0;
 }
 INDEX_TEMPLATE_ARGUMENTS
@@ -165,4 +222,25 @@ template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeLeafPage<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class BPlusTreeLeafPage<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class BPlusTreeLeafPage<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class BPlusTreeLeafPage<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+template class BPlusTreeLeafPage<IntegerKey<int32_t, 1>, RID, IntegerKeyComparator<int32_t, 1>>;
+template class BPlusTreeLeafPage<IntegerKey<int64_t, 1>, RID, IntegerKeyComparator<int64_t, 1>>;
+template class BPlusTreeLeafPage<IntegerKey<int32_t, 2>, RID, IntegerKeyComparator<int32_t, 2>>;
+template class BPlusTreeLeafPage<NonUniqueKey<NormalizedKey<8>>, RID,
+                                 NonUniqueComparator<NormalizedKey<8>, NormalizedComparator<8>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<NormalizedKey<16>>, RID,
+                                 NonUniqueComparator<NormalizedKey<16>, NormalizedComparator<16>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<NormalizedKey<32>>, RID,
+                                 NonUniqueComparator<NormalizedKey<32>, NormalizedComparator<32>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<NormalizedKey<64>>, RID,
+                                 NonUniqueComparator<NormalizedKey<64>, NormalizedComparator<64>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<IntegerKey<int32_t, 1>>, RID,
+                                 NonUniqueComparator<IntegerKey<int32_t, 1>, IntegerKeyComparator<int32_t, 1>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<IntegerKey<int64_t, 1>>, RID,
+                                 NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>>;
+template class BPlusTreeLeafPage<NonUniqueKey<IntegerKey<int32_t, 2>>, RID,
+                                 NonUniqueComparator<IntegerKey<int32_t, 2>, IntegerKeyComparator<int32_t, 2>>>;
 }  // namespace bustub
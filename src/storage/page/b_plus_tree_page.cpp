@@ -18,6 +18,7 @@ namespace bustub {
  * Page type enum class is defined in b_plus_tree_page.h
  */
 auto BPlusTreePage::IsLeafPage() const -> bool { return static_cast<bool>(IndexPageType::LEAF_PAGE == page_type_); }
+auto BPlusTreePage::IsInvalidPage() const -> bool { return IndexPageType::INVALID_INDEX_PAGE == page_type_; }
 void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
 
 /*
@@ -0,0 +1,269 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_slotted_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include "common/config.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+static_assert(BUSTUB_PAGE_SIZE <= UINT16_MAX, "slot offsets of a slotted page are 16 bits");
+static_assert(sizeof(BPlusTreePage) + 12 == SLOTTED_PAGE_HEADER_SIZE, "slotted page header size");
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+
+/**
+ * Init method after creating a new slotted page
+ * Including set page type, set current size to zero, set the page size as max size and clear the prefix
+ */
+void BPlusTreeSlottedPage::Init(int level) {
+  SetPageType(level == 0 ? IndexPageType::LEAF_PAGE : IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetMaxSize(BUSTUB_PAGE_SIZE);
+  next_page_id_ = INVALID_PAGE_ID;
+  level_ = level;
+  prefix_size_ = 0;
+  free_end_ = BUSTUB_PAGE_SIZE;
+  garbage_size_ = 0;
+}
+
+auto BPlusTreeSlottedPage::GetLevel() const -> int { return level_; }
+
+auto BPlusTreeSlottedPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+void BPlusTreeSlottedPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+auto BPlusTreeSlottedPage::GetPrefix() const -> std::string_view {
+  return {reinterpret_cast<const char *>(this) + GetMaxSize() - prefix_size_, prefix_size_};
+}
+
+auto BPlusTreeSlottedPage::FirstKeyIndex() const -> int { return IsLeafPage() ? 0 : 1; }
+
+auto BPlusTreeSlottedPage::SuffixAt(int index) const -> std::string_view {
+  return {reinterpret_cast<const char *>(this) + slots_[index].offset_, slots_[index].size_};
+}
+
+auto BPlusTreeSlottedPage::CellBytes() const -> size_t {
+  size_t bytes = 0;
+  for (int i = 0; i < GetSize(); i++) {
+    bytes += slots_[i].size_;
+  }
+  return bytes;
+}
+
+auto BPlusTreeSlottedPage::KeyAt(int index) const -> std::string {
+  if (index < FirstKeyIndex()) {
+    return {};
+  }
+  std::string key(GetPrefix());
+  key.append(SuffixAt(index));
+  return key;
+}
+
+auto BPlusTreeSlottedPage::ValueAt(int index) const -> int64_t {
+  int64_t value;
+  memcpy(&value, slots_[index].value_, sizeof(value));
+  return value;
+}
+
+void BPlusTreeSlottedPage::SetValueAt(int index, int64_t value) {
+  memcpy(slots_[index].value_, &value, sizeof(value));
+}
+
+auto BPlusTreeSlottedPage::EntrySize(size_t key_size) -> size_t { return sizeof(Slot) + key_size; }
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+
+auto BPlusTreeSlottedPage::CompareAt(int index, std::string_view key) const -> int {
+  auto prefix = GetPrefix();
+  int res = memcmp(prefix.data(), key.data(), std::min(prefix.size(), key.size()));
+  if (res != 0) {
+    return res;
+  }
+  if (key.size() < prefix.size()) {
+    return 1;
+  }
+  return SuffixAt(index).compare(key.substr(prefix.size()));
+}
+
+auto BPlusTreeSlottedPage::StartsWithAt(int index, std::string_view key) const -> bool {
+  auto prefix = GetPrefix();
+  if (key.size() <= prefix.size()) {
+    return prefix.substr(0, key.size()) == key;
+  }
+  auto suffix = SuffixAt(index);
+  auto rest = key.substr(prefix.size());
+  return key.substr(0, prefix.size()) == prefix && rest.size() <= suffix.size() && suffix.substr(0, rest.size()) == rest;
+}
+
+auto BPlusTreeSlottedPage::LowerBound(std::string_view key) const -> int {
+  int lo = FirstKeyIndex();
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (CompareAt(mid, key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+auto BPlusTreeSlottedPage::UpperBound(std::string_view key) const -> int {
+  int lo = FirstKeyIndex();
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (CompareAt(mid, key) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/*****************************************************************************
+ * INSERTION / REMOVAL
+ *****************************************************************************/
+
+/*
+ * The suffix of the key goes into the free space if the key shares the prefix
+ * of the page, the page is compacted first if only the garbage of removed
+ * entries makes room for it. A key that does not share the prefix rebuilds the
+ * page with the prefix of all keys.
+ */
+auto BPlusTreeSlottedPage::Insert(int index, std::string_view key, int64_t value) -> bool {
+  auto prefix = GetPrefix();
+  if (key.substr(0, prefix.size()) != prefix) {
+    auto entries = GetEntries();
+    entries.emplace(entries.begin() + index, std::string(key), value);
+    return SetEntries(entries.cbegin(), entries.cend());
+  }
+  auto suffix = key.substr(prefix.size());
+  size_t slots_end = SLOTTED_PAGE_HEADER_SIZE + (GetSize() + 1) * sizeof(Slot);
+  if (slots_end + suffix.size() > free_end_) {
+    if (slots_end + suffix.size() > free_end_ + garbage_size_) {
+      return false;
+    }
+    // compact the cells of the live entries against the prefix
+    std::vector<std::string> suffixes;
+    suffixes.reserve(GetSize());
+    for (int i = 0; i < GetSize(); i++) {
+      suffixes.emplace_back(SuffixAt(i));
+    }
+    free_end_ = GetMaxSize() - prefix_size_;
+    for (int i = 0; i < GetSize(); i++) {
+      free_end_ -= suffixes[i].size();
+      memcpy(reinterpret_cast<char *>(this) + free_end_, suffixes[i].data(), suffixes[i].size());
+      slots_[i].offset_ = free_end_;
+    }
+    garbage_size_ = 0;
+  }
+  memmove(slots_ + index + 1, slots_ + index, (GetSize() - index) * sizeof(Slot));
+  free_end_ -= suffix.size();
+  memcpy(reinterpret_cast<char *>(this) + free_end_, suffix.data(), suffix.size());
+  slots_[index].offset_ = free_end_;
+  slots_[index].size_ = suffix.size();
+  SetValueAt(index, value);
+  IncreaseSize(1);
+  return true;
+}
+
+/*
+ * The cell of the entry is left as garbage, the prefix stays as it is since it
+ * is still shared by the keys left
+ */
+void BPlusTreeSlottedPage::Remove(int index) {
+  garbage_size_ += slots_[index].size_;
+  memmove(slots_ + index, slots_ + index + 1, (GetSize() - index - 1) * sizeof(Slot));
+  IncreaseSize(-1);
+}
+
+auto BPlusTreeSlottedPage::IsInsertSafe() const -> bool {
+  // every key with the whole prefix, plus the prefix itself in case no key is left to share it
+  size_t valid_keys = GetSize() - std::min(GetSize(), FirstKeyIndex());
+  size_t bytes = SLOTTED_PAGE_HEADER_SIZE + GetSize() * sizeof(Slot) + CellBytes() + (valid_keys + 1) * prefix_size_;
+  return bytes + EntrySize(SLOTTED_PAGE_MAX_KEY_SIZE) <= static_cast<size_t>(GetMaxSize());
+}
+
+auto BPlusTreeSlottedPage::GetEntries() const -> std::vector<std::pair<std::string, int64_t>> {
+  std::vector<std::pair<std::string, int64_t>> entries;
+  entries.reserve(GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  return entries;
+}
+
+auto BPlusTreeSlottedPage::SetEntries(std::vector<std::pair<std::string, int64_t>>::const_iterator begin,
+                                      std::vector<std::pair<std::string, int64_t>>::const_iterator end) -> bool {
+  auto first = begin + std::min<ptrdiff_t>(FirstKeyIndex(), end - begin);
+  // the prefix is the longest common prefix of the valid keys, a single key keeps all of its bytes in its cell
+  std::string_view prefix;
+  if (end - first >= 2) {
+    prefix = first->first;
+    for (auto it = first + 1; it != end; ++it) {
+      auto mismatch = std::mismatch(prefix.begin(), prefix.end(), it->first.begin(), it->first.end());
+      prefix = prefix.substr(0, mismatch.first - prefix.begin());
+    }
+  }
+  size_t bytes = SLOTTED_PAGE_HEADER_SIZE + prefix.size();
+  for (auto it = begin; it != end; ++it) {
+    bytes += EntrySize(it < first ? 0 : it->first.size() - prefix.size());
+  }
+  if (bytes > static_cast<size_t>(GetMaxSize())) {
+    return false;
+  }
+
+  prefix_size_ = prefix.size();
+  free_end_ = GetMaxSize() - prefix_size_;
+  memcpy(reinterpret_cast<char *>(this) + free_end_, prefix.data(), prefix_size_);
+  int index = 0;
+  for (auto it = begin; it != end; ++it, ++index) {
+    std::string_view suffix = it < first ? std::string_view() : std::string_view(it->first).substr(prefix_size_);
+    free_end_ -= suffix.size();
+    memcpy(reinterpret_cast<char *>(this) + free_end_, suffix.data(), suffix.size());
+    slots_[index].offset_ = free_end_;
+    slots_[index].size_ = suffix.size();
+    SetValueAt(index, it->second);
+  }
+  SetSize(index);
+  garbage_size_ = 0;
+  return true;
+}
+
+auto BPlusTreeSlottedPage::ToString() const -> std::string {
+  std::ostringstream out;
+  out << "(";
+  for (int i = FirstKeyIndex(); i < GetSize(); i++) {
+    if (i > FirstKeyIndex()) {
+      out << ",";
+    }
+    // separators are truncated keys, so print the bytes instead of decoding them
+    for (unsigned char c : KeyAt(i)) {
+      out << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(c);
+    }
+  }
+  out << ")";
+  return out.str();
+}
+
+}  // namespace bustub
@@ -11,71 +11,169 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_bucket_page.h"
+
+#include <algorithm>
+#include <bitset>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "common/logger.h"
 #include "common/util/hash_util.h"
 #include "storage/index/generic_key.h"
 #include "storage/index/hash_comparator.h"
+#include "storage/index/normalized_key.h"
 #include "storage/table/tmp_tuple.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return a mask with a bit set for each of the BUCKET_GROUP_SIZE control bytes from ctrl that is equal to byte */
+inline auto MatchByte(const uint8_t *ctrl, uint8_t byte) -> uint32_t {
+#ifdef __SSE2__
+  auto group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(byte)))));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < BUCKET_GROUP_SIZE; i++) {
+    mask |= static_cast<uint32_t>(ctrl[i] == byte) << i;
+  }
+  return mask;
+#endif
+}
+
+/** @return a mask with a bit set for each of the BUCKET_GROUP_SIZE control bytes from ctrl that has its high bit set */
+inline auto MatchHighBit(const uint8_t *ctrl) -> uint32_t {
+#ifdef __SSE2__
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < BUCKET_GROUP_SIZE; i++) {
+    mask |= static_cast<uint32_t>(ctrl[i] >> 7) << i;
+  }
+  return mask;
+#endif
+}
+
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
+template <typename Visit>
+auto HASH_TABLE_BUCKET_TYPE::ProbeSlots(uint8_t ctrl, Visit &&visit) const -> bool {
+  for (uint32_t group = 0; group < BUCKET_CTRL_SIZE; group += BUCKET_GROUP_SIZE) {
+    for (auto mask = MatchByte(ctrl_ + group, ctrl); mask != 0; mask &= mask - 1) {
+      if (visit(group + __builtin_ctz(mask))) {
+        return true;
+      }
+    }
+    // the slots after the first one that was never occupied are all free
+    if (MatchByte(ctrl_ + group, CTRL_EMPTY) != 0) {
+      return false;
+    }
+  }
   return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
-  return true;
+auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result,
+                                      uint32_t hash) const -> bool {
+  bool found = false;
+  ProbeSlots(Fingerprint(hash), [&](uint32_t bucket_idx) {
+    if (cmp(array_[bucket_idx].first, key) == 0) {
+      result->push_back(array_[bucket_idx].second);
+      found = true;
+    }
+    return false;
+  });
+  return found;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp, uint32_t hash) -> bool {
+  auto fingerprint = Fingerprint(hash);
+  if (ProbeSlots(fingerprint, [&](uint32_t bucket_idx) {
+        return cmp(array_[bucket_idx].first, key) == 0 && array_[bucket_idx].second == value;
+      })) {
+    return false;
+  }
+  // the first free slot, a tombstone or the first slot that was never occupied
+  for (uint32_t group = 0; group < BUCKET_CTRL_SIZE; group += BUCKET_GROUP_SIZE) {
+    auto free_mask = ~MatchHighBit(ctrl_ + group) & ((1U << BUCKET_GROUP_SIZE) - 1);
+    if (free_mask != 0) {
+      auto bucket_idx = group + __builtin_ctz(free_mask);
+      // the control bytes padding the last group are never used
+      if (bucket_idx >= BUCKET_ARRAY_SIZE) {
+        return false;
+      }
+      array_[bucket_idx] = MappingType(key, value);
+      ctrl_[bucket_idx] = fingerprint;
+      return true;
+    }
+  }
   return false;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp, uint32_t hash) -> bool {
+  return ProbeSlots(Fingerprint(hash), [&](uint32_t bucket_idx) {
+    if (cmp(array_[bucket_idx].first, key) == 0 && array_[bucket_idx].second == value) {
+      RemoveAt(bucket_idx);
+      return true;
+    }
+    return false;
+  });
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  // the slot stays occupied as a tombstone, so that lookups keep probing past it
+  ctrl_[bucket_idx] = CTRL_DELETED;
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return ctrl_[bucket_idx] != CTRL_EMPTY;
 }
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
-
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (ctrl_[bucket_idx] & CTRL_FULL) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
-
-template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::IsFull() const -> bool {
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+auto HASH_TABLE_BUCKET_TYPE::NumReadable() const -> uint32_t {
+  uint32_t size = 0;
+  for (uint32_t group = 0; group < BUCKET_CTRL_SIZE; group += BUCKET_GROUP_SIZE) {
+    size += std::bitset<BUCKET_GROUP_SIZE>(MatchHighBit(ctrl_ + group)).count();
+  }
+  return size;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::IsEmpty() const -> bool {
+  for (uint32_t group = 0; group < BUCKET_CTRL_SIZE; group += BUCKET_GROUP_SIZE) {
+    if (MatchHighBit(ctrl_ + group) != 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -109,6 +207,11 @@ template class HashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class HashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class HashTableBucketPage<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class HashTableBucketPage<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class HashTableBucketPage<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class HashTableBucketPage<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
 // template class HashTableBucketPage<hash_t, TmpTuple, HashComparator>;
 
 }  // namespace bustub
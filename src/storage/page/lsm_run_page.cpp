@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_run_page.cpp
+//
+// Identification: src/storage/page/lsm_run_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/lsm_run_page.h"
+
+#include "common/rid.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_RUN_PAGE_TYPE::Init() {
+  size_ = 0;
+  padding_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_RUN_PAGE_TYPE::GetSize() const -> int {
+  return size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_RUN_PAGE_TYPE::IsFull() const -> bool {
+  return static_cast<size_t>(size_) == LSM_RUN_PAGE_SIZE;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_RUN_PAGE_TYPE::EntryAt(int index) const -> const LsmEntry<KeyType, ValueType> & {
+  return array_[index];
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LSM_RUN_PAGE_TYPE::Append(const LsmEntry<KeyType, ValueType> &entry) {
+  array_[size_++] = entry;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LSM_RUN_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int left = 0;
+  int right = size_;
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(array_[mid].key_, key) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+template class LsmRunPage<NormalizedKey<8>, RID, NormalizedComparator<8>>;
+template class LsmRunPage<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+template class LsmRunPage<NormalizedKey<32>, RID, NormalizedComparator<32>>;
+template class LsmRunPage<NormalizedKey<64>, RID, NormalizedComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// rid_bitmap.cpp
+//
+// Identification: src/storage/table/rid_bitmap.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/rid_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace bustub {
+
+void RidBitmap::Insert(const RID &rid) {
+  auto &words = pages_[rid.GetPageId()];
+  auto word = rid.GetSlotNum() / WORD_BITS;
+  if (word >= words.size()) {
+    words.resize(word + 1, 0);
+  }
+  words[word] |= uint64_t{1} << (rid.GetSlotNum() % WORD_BITS);
+}
+
+auto RidBitmap::Contains(const RID &rid) const -> bool {
+  auto it = pages_.find(rid.GetPageId());
+  if (it == pages_.end()) {
+    return false;
+  }
+  auto word = rid.GetSlotNum() / WORD_BITS;
+  return word < it->second.size() && (it->second[word] >> (rid.GetSlotNum() % WORD_BITS) & 1) != 0;
+}
+
+void RidBitmap::IntersectWith(const RidBitmap &other) {
+  for (auto it = pages_.begin(); it != pages_.end();) {
+    auto other_it = other.pages_.find(it->first);
+    if (other_it == other.pages_.end()) {
+      it = pages_.erase(it);
+      continue;
+    }
+    auto &words = it->second;
+    const auto &other_words = other_it->second;
+    words.resize(std::min(words.size(), other_words.size()));
+    bool any = false;
+    for (size_t i = 0; i < words.size(); i++) {
+      words[i] &= other_words[i];
+      any = any || words[i] != 0;
+    }
+    it = any ? std::next(it) : pages_.erase(it);
+  }
+}
+
+void RidBitmap::UnionWith(const RidBitmap &other) {
+  for (const auto &[page_id, other_words] : other.pages_) {
+    auto &words = pages_[page_id];
+    if (words.size() < other_words.size()) {
+      words.resize(other_words.size(), 0);
+    }
+    for (size_t i = 0; i < other_words.size(); i++) {
+      words[i] |= other_words[i];
+    }
+  }
+}
+
+auto RidBitmap::Size() const -> size_t {
+  size_t size = 0;
+  for (const auto &[page_id, words] : pages_) {
+    for (auto word : words) {
+      size += std::bitset<WORD_BITS>(word).count();
+    }
+  }
+  return size;
+}
+
+auto RidBitmap::GetPageIds() const -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(pages_.size());
+  for (const auto &[page_id, words] : pages_) {
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+
+auto RidBitmap::GetSlots(page_id_t page_id) const -> std::vector<uint32_t> {
+  std::vector<uint32_t> slots;
+  auto it = pages_.find(page_id);
+  if (it == pages_.end()) {
+    return slots;
+  }
+  const auto &words = it->second;
+  for (uint32_t i = 0; i < words.size(); i++) {
+    for (auto word = words[i]; word != 0; word &= word - 1) {
+      slots.push_back(i * WORD_BITS + __builtin_ctzll(word));
+    }
+  }
+  return slots;
+}
+
+}  // namespace bustub
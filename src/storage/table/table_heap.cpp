@@ -89,6 +89,21 @@ auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
   return std::make_pair(meta, std::move(tuple));
 }
 
+auto TableHeap::GetTuples(page_id_t page_id, const std::vector<uint32_t> &slots)
+    -> std::vector<std::pair<TupleMeta, Tuple>> {
+  auto page_guard = bpm_->FetchPageRead(page_id);
+  auto page = page_guard.As<TablePage>();
+  std::vector<std::pair<TupleMeta, Tuple>> tuples;
+  tuples.reserve(slots.size());
+  for (auto slot : slots) {
+    RID rid{page_id, slot};
+    auto [meta, tuple] = page->GetTuple(rid);
+    tuple.rid_ = rid;
+    tuples.emplace_back(meta, std::move(tuple));
+  }
+  return tuples;
+}
+
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
   auto page = page_guard.As<TablePage>();
@@ -12,6 +12,8 @@
 
 #include <cassert>
 #include <optional>
+#include <tuple>
+#include <utility>
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -24,22 +26,32 @@ TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
     : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
   // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
   // we set rid_ to invalid.
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  if (rid_.GetSlotNum() >= page->GetNumTuples()) {
+  FetchPage(rid_.GetPageId());
+  if (rid_.GetSlotNum() >= num_tuples_) {
     rid_ = RID{INVALID_PAGE_ID, 0};
+    page_guard_.Drop();
   }
 }
 
-auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> { return table_heap_->GetTuple(rid_); }
+void TableIterator::FetchPage(page_id_t page_id) {
+  page_guard_ = table_heap_->bpm_->FetchPageBasic(page_id);
+  std::tie(num_tuples_, next_page_id_) = page_guard_.ReadLatched<TablePage>(
+      [](const TablePage *page) { return std::make_pair(page->GetNumTuples(), page->GetNextPageId()); });
+}
+
+auto TableIterator::GetTuple() -> std::pair<TupleMeta, Tuple> {
+  return page_guard_.ReadLatched<TablePage>([this](const TablePage *page) { return page->GetTuple(rid_); });
+}
+
+auto TableIterator::GetTupleView() -> std::pair<TupleMeta, TupleView> {
+  return page_guard_.ReadLatched<TablePage>([this](const TablePage *page) { return page->GetTupleView(rid_); });
+}
 
 auto TableIterator::GetRID() -> RID { return rid_; }
 
 auto TableIterator::IsEnd() -> bool { return rid_.GetPageId() == INVALID_PAGE_ID; }
 
 auto TableIterator::operator++() -> TableIterator & {
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
   auto next_tuple_id = rid_.GetSlotNum() + 1;
 
   BUSTUB_ASSERT(
@@ -52,16 +64,19 @@ auto TableIterator::operator++() -> TableIterator & {
 
   if (rid_ == stop_at_rid_) {
     rid_ = RID{INVALID_PAGE_ID, 0};
-  } else if (next_tuple_id < page->GetNumTuples()) {
-    // that's fine
+  } else if (next_tuple_id < num_tuples_) {
+    // the tuple is on the pinned page
+    return *this;
   } else {
-    auto next_page_id = page->GetNextPageId();
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
-    rid_ = RID{next_page_id, 0};
+    rid_ = RID{next_page_id_, 0};
   }
 
-  page_guard.Drop();
-
+  if (IsEnd()) {
+    page_guard_.Drop();
+  } else {
+    FetchPage(rid_.GetPageId());
+  }
   return *this;
 }
 
@@ -13,10 +13,13 @@
 #include "buffer/buffer_pool_manager.h"
 
 #include <cstdio>
+#include <memory>
+#include <optional>
 #include <random>
 #include <string>
 
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
@@ -144,4 +147,46 @@ TEST(BufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+TEST(BufferPoolManagerTest, ReadResidentOptimisticTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(2, disk_manager.get());
+  auto read = [&bpm](page_id_t page_id) -> std::optional<std::string> {
+    std::string data;
+    if (bpm->ReadResidentOptimistic(page_id, [&data](const char *page) { data = page; })) {
+      return data;
+    }
+    return std::nullopt;
+  };
+
+  page_id_t page_id0;
+  page_id_t page_id1;
+  {
+    auto guard = bpm->NewPageGuarded(&page_id0);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "page0");
+  }
+  // a resident page is read without pinning it, unless a writer holds it
+  EXPECT_EQ(read(page_id0), "page0");
+  {
+    auto guard = bpm->FetchPageWrite(page_id0);
+    EXPECT_EQ(read(page_id0), std::nullopt);
+  }
+  EXPECT_EQ(read(page_id0), "page0");
+  {
+    auto guard = bpm->NewPageGuarded(&page_id1);
+    snprintf(guard.AsMut<char>(), BUSTUB_PAGE_SIZE, "page1");
+  }
+
+  // once its frame is given to another page, it is not found until it is fetched again
+  page_id_t page_id2;
+  bpm->NewPageGuarded(&page_id2);
+  EXPECT_EQ(read(page_id0), std::nullopt);
+  EXPECT_EQ(read(page_id1), "page1");
+  bpm->FetchPageBasic(page_id0);
+  EXPECT_EQ(read(page_id0), "page0");
+
+  // nor once it is deleted
+  EXPECT_TRUE(bpm->DeletePage(page_id0));
+  EXPECT_EQ(read(page_id0), std::nullopt);
+}
+
 }  // namespace bustub
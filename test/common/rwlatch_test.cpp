@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -57,4 +58,49 @@ TEST(RWLatchTest, BasicTest) {
   }
   EXPECT_EQ(counter.Read(), 55);
 }
+
+// NOLINTNEXTLINE
+TEST(RWLatchTest, OptimisticReadTest) {
+  ReaderWriterLatch latch;
+  auto version = latch.ReadVersion();
+  EXPECT_TRUE(latch.Validate(version));
+
+  // readers do not change the version
+  latch.RLock();
+  latch.RUnlock();
+  EXPECT_TRUE(latch.Validate(version));
+
+  // the version is odd while a writer holds the latch, and changed afterwards
+  latch.WLock();
+  EXPECT_FALSE(latch.Validate(latch.ReadVersion()));
+  EXPECT_FALSE(latch.Validate(version));
+  latch.WUnlock();
+  EXPECT_FALSE(latch.Validate(version));
+  EXPECT_TRUE(latch.Validate(latch.ReadVersion()));
+
+  // writers keep both halves equal, a validated optimistic read never sees them differ
+  std::atomic<int> first{0};
+  std::atomic<int> second{0};
+  std::atomic<bool> done{false};
+  std::thread writer([&]() {
+    for (int i = 1; i <= 10000; i++) {
+      latch.WLock();
+      first.store(i, std::memory_order_relaxed);
+      second.store(i, std::memory_order_relaxed);
+      latch.WUnlock();
+    }
+    done = true;
+  });
+  while (!done) {
+    auto v = latch.ReadVersion();
+    int a = first.load(std::memory_order_relaxed);
+    int b = second.load(std::memory_order_relaxed);
+    if (latch.Validate(v)) {
+      EXPECT_EQ(a, b);
+    }
+  }
+  writer.join();
+  EXPECT_TRUE(latch.Validate(latch.ReadVersion()));
+  EXPECT_EQ(first.load(), 10000);
+}
 }  // namespace bustub
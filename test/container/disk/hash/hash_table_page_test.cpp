@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
 #include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -23,7 +25,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -56,7 +58,7 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -113,4 +115,54 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageFingerprintTest) {
+  auto data = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  auto bucket_page = reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(data.get());
+  // the fingerprint of a key is the top 7 bits of its hash
+  auto hash = [](int key) { return static_cast<uint32_t>(key % 128) << 25; };
+
+  // a pair takes its size and a control byte, less the padding of the last group of control bytes
+  const int capacity = (BUSTUB_PAGE_SIZE - 15) / (sizeof(std::pair<int, int>) + 1);
+  for (int i = 0; i < capacity; i++) {
+    ASSERT_TRUE(bucket_page->Insert(i, i, IntComparator(), hash(i)));
+  }
+  EXPECT_FALSE(bucket_page->Insert(capacity, capacity, IntComparator(), hash(capacity)));
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_EQ(capacity, bucket_page->NumReadable());
+
+  // only the slots whose fingerprint matches are compared, keys with the same fingerprint are told apart
+  std::vector<int> result;
+  for (int i = 0; i < capacity; i++) {
+    result.clear();
+    ASSERT_TRUE(bucket_page->GetValue(i, IntComparator(), &result, hash(i)));
+    EXPECT_EQ(std::vector<int>{i}, result);
+  }
+  EXPECT_FALSE(bucket_page->GetValue(3, IntComparator(), &result, hash(4)));
+  EXPECT_FALSE(bucket_page->Remove(3, 3, IntComparator(), hash(4)));
+
+  // tombstones are reused, the first one first
+  for (int i = 0; i < capacity; i += 2) {
+    ASSERT_TRUE(bucket_page->Remove(i, i, IntComparator(), hash(i)));
+  }
+  EXPECT_FALSE(bucket_page->IsFull());
+  EXPECT_EQ(capacity / 2, bucket_page->NumReadable());
+  EXPECT_FALSE(bucket_page->IsReadable(0));
+  EXPECT_TRUE(bucket_page->IsOccupied(0));
+  EXPECT_FALSE(bucket_page->Insert(1, 1, IntComparator(), hash(1)));
+  EXPECT_TRUE(bucket_page->Insert(1, 100, IntComparator(), hash(1)));
+  EXPECT_EQ(1, bucket_page->KeyAt(0));
+  EXPECT_EQ(100, bucket_page->ValueAt(0));
+  result.clear();
+  EXPECT_TRUE(bucket_page->GetValue(1, IntComparator(), &result, hash(1)));
+  EXPECT_EQ((std::vector<int>{100, 1}), result);
+
+  for (int i = 1; i < capacity; i += 2) {
+    ASSERT_TRUE(bucket_page->Remove(i, i, IntComparator(), hash(i)));
+  }
+  EXPECT_TRUE(bucket_page->Remove(1, 100, IntComparator(), hash(1)));
+  EXPECT_TRUE(bucket_page->IsEmpty());
+  EXPECT_EQ(0, bucket_page->NumReadable());
+}
+
 }  // namespace bustub
@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bloom_filter_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bloom_filter_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/non_unique_key.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using Int64Tree = BPlusTree<IntegerKey<int64_t, 1>, RID, IntegerKeyComparator<int64_t, 1>>;
+using NonUniqueInt64Key = NonUniqueKey<IntegerKey<int64_t, 1>>;
+using NonUniqueInt64Comparator = NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>;
+using NonUniqueTree = BPlusTree<NonUniqueInt64Key, RID, NonUniqueInt64Comparator>;
+
+template <typename KeyType>
+static auto Key(int64_t key) -> KeyType {
+  KeyType index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+TEST(BPlusTreeTests, BloomFilterTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  IntegerKeyComparator<int64_t, 1> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id);
+  Int64Tree tree("foo_pk", page_id, bpm.get(), comparator);
+  auto initial_bytes = tree.GetFilterByteCount();
+  EXPECT_GT(initial_bytes, 0);
+
+  // the even keys, many more than the filter of an empty tree is sized for
+  const int64_t key_count = 20000;
+  for (int64_t key = 0; key < key_count; key += 2) {
+    ASSERT_TRUE(tree.Insert(Key<IntegerKey<int64_t, 1>>(key), RID(key)));
+  }
+  EXPECT_GT(tree.GetFilterByteCount(), initial_bytes);
+  EXPECT_LT(tree.GetFilterFalsePositiveRate(), 0.05);
+
+  // no false negatives, and the odd keys are absent
+  for (int64_t key = 0; key < key_count; key++) {
+    std::vector<RID> result;
+    ASSERT_EQ(tree.GetValue(Key<IntegerKey<int64_t, 1>>(key), &result), key % 2 == 0);
+  }
+
+  // removed keys stay in the filter until it is rebuilt, the tree still answers for them
+  for (int64_t key = 0; key < key_count; key += 4) {
+    tree.Remove(Key<IntegerKey<int64_t, 1>>(key), nullptr);
+  }
+  auto stale_rate = tree.GetFilterFalsePositiveRate();
+  tree.RebuildFilter();
+  EXPECT_LT(tree.GetFilterFalsePositiveRate(), stale_rate);
+  for (int64_t key = 0; key < key_count; key++) {
+    std::vector<RID> result;
+    ASSERT_EQ(tree.GetValue(Key<IntegerKey<int64_t, 1>>(key), &result), key % 4 == 2);
+  }
+
+  // a bulk loaded tree rebuilds its filter from the leaves
+  bpm->NewPageGuarded(&page_id);
+  Int64Tree loaded("bar_pk", page_id, bpm.get(), comparator);
+  std::vector<std::pair<IntegerKey<int64_t, 1>, RID>> entries;
+  for (int64_t key = 0; key < key_count; key += 2) {
+    entries.emplace_back(Key<IntegerKey<int64_t, 1>>(key), RID(key));
+  }
+  ASSERT_TRUE(loaded.BulkLoad(entries));
+  for (int64_t key = 0; key < key_count; key++) {
+    std::vector<RID> result;
+    ASSERT_EQ(loaded.GetValue(Key<IntegerKey<int64_t, 1>>(key), &result), key % 2 == 0);
+  }
+
+  // without the filter a tree takes no memory for it
+  enable_index_bloom_filter = false;
+  bpm->NewPageGuarded(&page_id);
+  Int64Tree plain("baz_pk", page_id, bpm.get(), comparator);
+  EXPECT_EQ(plain.GetFilterByteCount(), 0);
+  enable_index_bloom_filter = true;
+}
+
+TEST(BPlusTreeTests, BloomFilterNonUniqueTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  NonUniqueInt64Comparator comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id);
+  NonUniqueTree tree("foo_idx", page_id, bpm.get(), comparator);
+
+  // the filter holds the key without its RID, so a lookup with any RID finds every entry
+  for (int64_t key = 0; key < 3000; key += 3) {
+    for (int32_t dup = 0; dup < 3; dup++) {
+      auto index_key = Key<NonUniqueInt64Key>(key);
+      index_key.SetRid(RID(dup, key));
+      ASSERT_TRUE(tree.Insert(index_key, RID(dup, key)));
+    }
+  }
+  for (int64_t key = 0; key < 3000; key++) {
+    std::vector<RID> result;
+    ASSERT_EQ(tree.GetValue(Key<NonUniqueInt64Key>(key), &result), key % 3 == 0);
+    ASSERT_EQ(result.size(), key % 3 == 0 ? 3 : 0);
+  }
+}
+
+TEST(BPlusTreeTests, BloomFilterConcurrentTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  IntegerKeyComparator<int64_t, 1> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id);
+  Int64Tree tree("foo_pk", page_id, bpm.get(), comparator);
+
+  // every thread reads its keys right after inserting them, while other threads grow and rebuild the filter, and one
+  // more keeps rebuilding it, the inserts during a rebuild are not lost from the filter it publishes
+  const int64_t thread_count = 4;
+  const int64_t keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  std::atomic<int64_t> misses{0};
+  std::atomic<bool> done{false};
+  std::thread rebuild_thread([&] {
+    while (!done.load()) {
+      tree.RebuildFilter();
+    }
+  });
+  for (int64_t thread_id = 0; thread_id < thread_count; thread_id++) {
+    threads.emplace_back([&, thread_id] {
+      for (int64_t i = 0; i < keys_per_thread; i++) {
+        auto key = i * thread_count + thread_id;
+        tree.Insert(Key<IntegerKey<int64_t, 1>>(key), RID(key));
+        std::vector<RID> result;
+        if (!tree.GetValue(Key<IntegerKey<int64_t, 1>>(key), &result)) {
+          misses++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  rebuild_thread.join();
+  EXPECT_EQ(misses.load(), 0);
+  for (int64_t key = 0; key < thread_count * keys_per_thread; key++) {
+    std::vector<RID> result;
+    ASSERT_TRUE(tree.GetValue(Key<IntegerKey<int64_t, 1>>(key), &result));
+  }
+}
+
+}  // namespace bustub
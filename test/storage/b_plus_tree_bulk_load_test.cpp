@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BulkLoadTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using BulkLoadInternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+using BulkLoadLeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+static auto MakeEntries(int64_t begin, int64_t end) -> std::vector<std::pair<GenericKey<8>, RID>> {
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  GenericKey<8> index_key;
+  for (int64_t key = begin; key < end; key++) {
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)));
+  }
+  return entries;
+}
+
+static void CheckKeys(BulkLoadTree *tree, const std::vector<int64_t> &keys) {
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree->GetValue(index_key, &rids)) << key;
+    ASSERT_EQ(rids[0].GetSlotNum(), static_cast<uint32_t>(key));
+  }
+
+  auto sorted = keys;
+  std::sort(sorted.begin(), sorted.end());
+  size_t i = 0;
+  for (auto iter = tree->Begin(); iter != tree->End(); ++iter, ++i) {
+    ASSERT_LT(i, sorted.size());
+    ASSERT_EQ((*iter).first.ToString(), sorted[i]);
+  }
+  ASSERT_EQ(i, sorted.size());
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (int64_t count : {1, 2, 3, 5, 6, 7, 31, 200, 1000}) {
+    for (double fill_factor : {0.1, 0.7, 1.0}) {
+      auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+      auto *bpm = new BufferPoolManager(50, disk_manager.get());
+      page_id_t page_id;
+      auto header_page = bpm->NewPage(&page_id);
+      BulkLoadTree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 5);
+      auto *transaction = new Transaction(0);
+
+      ASSERT_TRUE(tree.BulkLoad(MakeEntries(0, count), fill_factor, transaction));
+      ASSERT_FALSE(tree.BulkLoad(MakeEntries(0, count), fill_factor, transaction));
+
+      std::vector<int64_t> keys;
+      for (int64_t key = 0; key < count; key++) {
+        keys.push_back(key);
+      }
+      CheckKeys(&tree, keys);
+
+      // the bulk loaded tree keeps working with regular inserts and removes
+      GenericKey<8> index_key;
+      for (int64_t key = count; key < 2 * count; key++) {
+        index_key.SetFromInteger(key);
+        ASSERT_TRUE(tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)),
+                                transaction));
+        keys.push_back(key);
+      }
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(count));
+      std::vector<int64_t> removed(keys.begin(), keys.begin() + keys.size() / 2);
+      keys.erase(keys.begin(), keys.begin() + keys.size() / 2);
+      for (auto key : removed) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, transaction);
+      }
+      CheckKeys(&tree, keys);
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete transaction;
+      delete bpm;
+    }
+  }
+}
+
+TEST(BPlusTreeTests, BulkLoadFillFactorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BulkLoadTree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 10, 10);
+
+  ASSERT_TRUE(tree.BulkLoad(MakeEntries(0, 80), 0.8));
+
+  // 80 keys at 8 keys per leaf fill 10 leaves, 10 leaves at 8 children per internal page need 2 internal pages
+  auto root_guard = bpm->FetchPageRead(tree.GetRootPageId());
+  auto root = root_guard.As<BulkLoadInternalPage>();
+  ASSERT_FALSE(root->IsLeafPage());
+  ASSERT_EQ(root->GetSize(), 2);
+  for (int i = 0; i < root->GetSize(); i++) {
+    auto child_guard = bpm->FetchPageRead(root->ValueAt(i));
+    auto child = child_guard.As<BulkLoadInternalPage>();
+    ASSERT_EQ(child->GetSize(), 5);
+    auto leaf_guard = bpm->FetchPageRead(child->ValueAt(0));
+    ASSERT_EQ(leaf_guard.As<BulkLoadLeafPage>()->GetSize(), 8);
+  }
+  root_guard.Drop();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+}  // namespace bustub
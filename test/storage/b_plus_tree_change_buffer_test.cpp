@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_change_buffer_test.cpp
+//
+// Identification: test/storage/b_plus_tree_change_buffer_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using NonUniqueInt32Index =
+    BPlusTreeIndex<NonUniqueKey<Int32KeyType>, RID, NonUniqueComparator<Int32KeyType, Int32ComparatorType>>;
+
+static auto ScanKey(Index *index, const Schema &key_schema, int32_t key) -> std::vector<RID> {
+  Tuple key_tuple({ValueFactory::GetIntegerValue(key)}, &key_schema);
+  std::vector<RID> rids;
+  index->ScanKey(key_tuple, &rids, nullptr);
+  return rids;
+}
+
+TEST(BPlusTreeTests, ChangeBufferTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  // a small pool, so that most leaves are evicted while the index grows
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+
+  auto schema = ParseCreateStatement("a integer,b integer");
+  catalog->CreateTable(nullptr, "t", *schema);
+  Schema key_schema = Schema::CopySchema(schema.get(), {0});
+  auto *index_info = catalog->CreateIndex(nullptr, "t_a", "t", *schema, key_schema, {0}, false);
+  ASSERT_NE(index_info, nullptr);
+  auto *index = dynamic_cast<NonUniqueInt32Index *>(index_info->index_.get());
+  ASSERT_NE(index, nullptr);
+
+  const int32_t key_count = 20000;
+  std::vector<int32_t> keys(key_count);
+  for (int32_t i = 0; i < key_count; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(445));
+
+  // inserts into leaves that are not resident are buffered, and merged once the buffer is full
+  size_t max_buffered = 0;
+  for (auto key : keys) {
+    Tuple key_tuple({ValueFactory::GetIntegerValue(key % (key_count / 2))}, &key_schema);
+    ASSERT_TRUE(index->InsertEntry(key_tuple, RID(key, 0), nullptr));
+    max_buffered = std::max(max_buffered, index->GetChangeBufferSize());
+  }
+  EXPECT_GT(max_buffered, 0);
+  EXPECT_LE(max_buffered, CHANGE_BUFFER_MAX_SIZE);
+
+  // a lookup merges the changes of its key first
+  for (int32_t key = 0; key < key_count / 2; key++) {
+    ASSERT_EQ(ScanKey(index, key_schema, key), (std::vector<RID>{RID(key, 0), RID(key + key_count / 2, 0)}));
+  }
+
+  // a buffered remove replaces a buffered insert of the same entry
+  for (auto key : keys) {
+    if (key % 3 == 0) {
+      Tuple key_tuple({ValueFactory::GetIntegerValue(key % (key_count / 2))}, &key_schema);
+      index->DeleteEntry(key_tuple, RID(key, 0), nullptr);
+    }
+  }
+  Tuple key_tuple({ValueFactory::GetIntegerValue(7)}, &key_schema);
+  ASSERT_TRUE(index->InsertEntry(key_tuple, RID(key_count, 0), nullptr));
+  index->DeleteEntry(key_tuple, RID(key_count, 0), nullptr);
+
+  index->MergeChangeBuffer();
+  EXPECT_EQ(index->GetChangeBufferSize(), 0);
+  for (int32_t key = 0; key < key_count / 2; key++) {
+    std::vector<RID> expected;
+    for (auto rid_key : {key, key + key_count / 2}) {
+      if (rid_key % 3 != 0) {
+        expected.emplace_back(rid_key, 0);
+      }
+    }
+    ASSERT_EQ(ScanKey(index, key_schema, key), expected);
+  }
+
+  // range scans see the buffered changes too
+  for (int32_t key = 0; key < key_count / 2; key += 3) {
+    Tuple tuple({ValueFactory::GetIntegerValue(key)}, &key_schema);
+    index->InsertEntry(tuple, RID(key, 0), nullptr);
+  }
+  size_t count = 0;
+  auto cursor = index->ScanKeyRange(nullptr, true, nullptr, true);
+  std::vector<std::pair<NonUniqueKey<Int32KeyType>, RID>> batch;
+  while (cursor.NextBatch(&batch)) {
+    count += batch.size();
+  }
+  // every entry but those of the RIDs that are multiples of 3 at or above key_count / 2
+  EXPECT_EQ(count, key_count - (key_count - 1) / 3 + (key_count / 2 - 1) / 3);
+
+  // without the change buffer every change goes to the tree
+  enable_index_change_buffer = false;
+  for (int32_t key = 0; key < key_count / 2; key += 5) {
+    Tuple tuple({ValueFactory::GetIntegerValue(key)}, &key_schema);
+    index->InsertEntry(tuple, RID(key, 1), nullptr);
+    ASSERT_EQ(index->GetChangeBufferSize(), 0);
+  }
+  enable_index_change_buffer = true;
+}
+
+}  // namespace bustub
@@ -10,10 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
+#include <optional>
 #include <thread>  // NOLINT
+#include <type_traits>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -122,6 +126,60 @@ void LookupHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, con
   delete transaction;
 }
 
+using BLinkInternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+using BLinkLeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+// helper function to check the fence keys and sibling links of every level, level by level from the root
+template <typename Page>
+void CheckLevel(BufferPoolManager *bpm, const std::vector<page_id_t> &level, std::vector<page_id_t> *children) {
+  std::optional<GenericKey<8>> prev_high;
+  for (size_t i = 0; i < level.size(); i++) {
+    auto guard = bpm->FetchPageRead(level[i]);
+    auto page = guard.template As<Page>();
+    ASSERT_FALSE(page->IsInvalidPage());
+    auto low = page->GetLowKey();
+    auto high = page->GetHighKey();
+    // fences of neighbors meet, the first and last page of a level are unbounded
+    ASSERT_EQ(low.has_value(), i > 0);
+    ASSERT_EQ(high.has_value(), i + 1 < level.size());
+    ASSERT_EQ(page->GetNextPageId(), i + 1 < level.size() ? level[i + 1] : INVALID_PAGE_ID);
+    if (low.has_value()) {
+      ASSERT_EQ(low->ToString(), prev_high->ToString());
+    }
+    prev_high = high;
+    // the first key of an internal page is invalid
+    for (int j = page->IsLeafPage() ? 0 : 1; j < page->GetSize(); j++) {
+      if (low.has_value()) {
+        ASSERT_GE(page->KeyAt(j).ToString(), low->ToString());
+      }
+      if (high.has_value()) {
+        ASSERT_LT(page->KeyAt(j).ToString(), high->ToString());
+      }
+    }
+    if constexpr (std::is_same_v<Page, BLinkInternalPage>) {
+      for (int j = 0; j < page->GetSize(); j++) {
+        children->push_back(page->ValueAt(j));
+      }
+    }
+  }
+}
+
+void CheckFences(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, BufferPoolManager *bpm) {
+  std::vector<page_id_t> level{tree->GetRootPageId()};
+  while (true) {
+    auto guard = bpm->FetchPageRead(level.front());
+    bool is_leaf = guard.As<BPlusTreePage>()->IsLeafPage();
+    guard.Drop();
+    if (is_leaf) {
+      CheckLevel<BLinkLeafPage>(bpm, level, nullptr);
+      return;
+    }
+    std::vector<page_id_t> children;
+    CheckLevel<BLinkInternalPage>(bpm, level, &children);
+    level = std::move(children);
+  }
+}
+
 TEST(BPlusTreeConcurrentTest, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
@@ -402,4 +460,209 @@ TEST(BPlusTreeConcurrentTest, MixTest2) {
   delete bpm;
 }
 
+TEST(BPlusTreeConcurrentTest, BLinkReadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // small pages, so that writers keep splitting, redistributing and merging pages under the readers
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 3, 4);
+
+  std::vector<int64_t> perserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  for (int64_t i = 1; i <= 300; i++) {
+    if (i % 3 == 0) {
+      perserved_keys.push_back(i);
+    } else {
+      dynamic_keys.push_back(i);
+    }
+  }
+  InsertHelper(&tree, perserved_keys);
+
+  // readers never hold more than one latch, and read resident pages without pinning them, every preserved key must
+  // still be found
+  enable_optimistic_index_read = true;
+  auto write_task = [&](int tid) {
+    for (int round = 0; round < 5; round++) {
+      InsertHelperSplit(&tree, dynamic_keys, 2, tid);
+      DeleteHelperSplit(&tree, dynamic_keys, 2, tid);
+    }
+  };
+  auto read_task = [&](int tid) {
+    for (int round = 0; round < 10; round++) {
+      LookupHelper(&tree, perserved_keys, tid);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.emplace_back(write_task, 0);
+  threads.emplace_back(write_task, 1);
+  threads.emplace_back(read_task, 2);
+  threads.emplace_back(read_task, 3);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  enable_optimistic_index_read = false;
+
+  CheckFences(&tree, bpm);
+  std::vector<int64_t> keys;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    keys.push_back((*iter).first.ToString());
+  }
+  ASSERT_EQ(keys, perserved_keys);
+
+  // the fences also hold after the tree grows again
+  InsertHelper(&tree, dynamic_keys);
+  CheckFences(&tree, bpm);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeConcurrentTest, BLinkScanTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // small pages, so that writers keep splitting and merging the leaves under the scans
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 3, 4);
+
+  std::vector<int64_t> perserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  for (int64_t i = 1; i <= 300; i++) {
+    if (i % 3 == 0) {
+      perserved_keys.push_back(i);
+    } else {
+      dynamic_keys.push_back(i);
+    }
+  }
+  InsertHelper(&tree, perserved_keys);
+
+  // a scan returns every preserved key once and in order, whatever leaves it steps to are split or merged away
+  auto check_scan = [&](const std::vector<int64_t> &keys, bool reverse) {
+    std::vector<int64_t> preserved;
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (i > 0) {
+        ASSERT_TRUE(reverse ? keys[i] < keys[i - 1] : keys[i] > keys[i - 1]);
+      }
+      if (keys[i] % 3 == 0) {
+        preserved.push_back(keys[i]);
+      }
+    }
+    if (reverse) {
+      std::reverse(preserved.begin(), preserved.end());
+    }
+    ASSERT_EQ(preserved, perserved_keys);
+  };
+  auto write_task = [&](int tid) {
+    for (int round = 0; round < 5; round++) {
+      InsertHelperSplit(&tree, dynamic_keys, 2, tid);
+      DeleteHelperSplit(&tree, dynamic_keys, 2, tid);
+    }
+  };
+  auto scan_task = [&](int tid) {
+    for (int round = 0; round < 20; round++) {
+      std::vector<int64_t> keys;
+      auto cursor = tree.ScanRange(std::nullopt, true, std::nullopt, true, true);
+      std::vector<std::pair<GenericKey<8>, RID>> batch;
+      while (cursor.NextBatch(&batch)) {
+        for (const auto &entry : batch) {
+          keys.push_back(entry.first.ToString());
+        }
+      }
+      check_scan(keys, true);
+      keys.clear();
+      for (auto iter = tree.RBegin(); iter != tree.End(); ++iter) {
+        keys.push_back((*iter).first.ToString());
+      }
+      check_scan(keys, true);
+      keys.clear();
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        keys.push_back((*iter).first.ToString());
+      }
+      check_scan(keys, false);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.emplace_back(write_task, 0);
+  threads.emplace_back(write_task, 1);
+  threads.emplace_back(scan_task, 2);
+  threads.emplace_back(scan_task, 3);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  CheckFences(&tree, bpm);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeConcurrentTest, InsertBatchTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // small pages, so that batches split leaves into several pages and the splits reach the root
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 4, 5);
+
+  // every thread inserts batches of interleaved keys, batches overlap so that some keys are skipped
+  const int64_t key_count = 2000;
+  auto batch_task = [&](int tid) {
+    GenericKey<8> index_key;
+    for (int64_t start = 0; start < key_count; start += 50) {
+      std::vector<std::pair<GenericKey<8>, RID>> entries;
+      for (int64_t key = start; key < std::min(start + 100, key_count); key++) {
+        if (key % 4 == tid || key % 4 == (tid + 1) % 4) {
+          index_key.SetFromInteger(key);
+          entries.emplace_back(index_key, RID(0, key));
+        }
+      }
+      tree.InsertBatch(entries);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 4; tid++) {
+    threads.emplace_back(batch_task, tid);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  CheckFences(&tree, bpm);
+  int64_t current_key = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, key_count);
+  EXPECT_EQ(tree.GetEntryCount(), key_count);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cstdio>
 #include <random>
+#include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -221,4 +222,215 @@ TEST(BPlusTreeTests, DDeleteTest2) {
   delete transaction;
   delete bpm;
 }
+
+using CompactTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// Page ids of the leaves of the tree, following the sibling links from the leftmost leaf.
+auto LeafPageIds(BufferPoolManager *bpm, CompactTree *tree) -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  auto page_id = tree->GetRootPageId();
+  if (page_id == INVALID_PAGE_ID) {
+    return page_ids;
+  }
+  while (true) {
+    auto guard = bpm->FetchPageRead(page_id);
+    auto page = guard.As<BPlusTreePage>();
+    if (page->IsLeafPage()) {
+      break;
+    }
+    page_id = guard.As<BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>>()->ValueAt(0);
+  }
+  while (page_id != INVALID_PAGE_ID) {
+    page_ids.push_back(page_id);
+    auto guard = bpm->FetchPageRead(page_id);
+    page_id = guard.As<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>>()->GetNextPageId();
+  }
+  return page_ids;
+}
+
+// Number of leaves of the tree.
+auto LeafCount(BufferPoolManager *bpm, CompactTree *tree) -> size_t { return LeafPageIds(bpm, tree).size(); }
+
+// Check that exactly the keys in [1, scale) not in removed are found, by point lookups and by a full scan.
+void CheckKeys(CompactTree *tree, int64_t scale, const std::vector<bool> &removed) {
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  std::vector<int64_t> expected;
+  for (int64_t key = 1; key < scale; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree->GetValue(index_key, &rids), !removed[key]) << key;
+    if (!removed[key]) {
+      ASSERT_EQ(rids.size(), 1);
+      EXPECT_EQ(rids[0].GetSlotNum(), key);
+      expected.push_back(key);
+    }
+  }
+  std::vector<int64_t> scanned;
+  for (auto it = tree->Begin(); !it.IsEnd(); ++it) {
+    scanned.push_back((*it).second.GetSlotNum());
+  }
+  EXPECT_EQ(scanned, expected);
+}
+
+TEST(BPlusTreeTests, RelaxedUnderflowTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  bpm->UnpinPage(header_page->GetPageId(), true);
+  page_id_t relaxed_page_id;
+  header_page = bpm->NewPage(&relaxed_page_id);
+  bpm->UnpinPage(header_page->GetPageId(), true);
+  // the default tree rebalances half-empty pages, the relaxed one only empty pages
+  CompactTree tree("foo_pk", page_id, bpm.get(), comparator, 4, 5);
+  CompactTree relaxed("bar_pk", relaxed_page_id, bpm.get(), comparator, 4, 5, 0.0);
+
+  int64_t scale = 500;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key < scale; key++) {
+    keys.push_back(key);
+  }
+  auto rng = std::default_random_engine{};
+  std::shuffle(keys.begin(), keys.end(), rng);
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+    relaxed.Insert(index_key, RID(0, key));
+  }
+
+  // remove three keys out of four
+  std::vector<bool> removed(scale, false);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    if (key % 4 != 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, nullptr);
+      relaxed.Remove(index_key, nullptr);
+      removed[key] = true;
+    }
+  }
+  CheckKeys(&tree, scale, removed);
+  CheckKeys(&relaxed, scale, removed);
+  EXPECT_GT(LeafCount(bpm.get(), &relaxed), LeafCount(bpm.get(), &tree));
+
+  // emptied pages are still merged away
+  for (auto key : keys) {
+    if (!removed[key]) {
+      index_key.SetFromInteger(key);
+      relaxed.Remove(index_key, nullptr);
+      removed[key] = true;
+    }
+  }
+  CheckKeys(&relaxed, scale, removed);
+  EXPECT_TRUE(relaxed.IsEmpty());
+}
+
+TEST(BPlusTreeTests, CompactTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  bpm->UnpinPage(header_page->GetPageId(), true);
+  CompactTree tree("foo_pk", page_id, bpm.get(), comparator, 8, 5, 0.0);
+
+  int64_t scale = 2000;
+  GenericKey<8> index_key;
+  for (int64_t key = 1; key < scale; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  std::vector<bool> removed(scale, false);
+  for (int64_t key = 1; key < scale; key++) {
+    if (key % 5 != 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, nullptr);
+      removed[key] = true;
+    }
+  }
+  auto leaves = LeafPageIds(bpm.get(), &tree);
+  auto merged = tree.Compact(1.0);
+  EXPECT_GT(merged, 0);
+  auto compacted = LeafPageIds(bpm.get(), &tree);
+  EXPECT_EQ(compacted.size(), leaves.size() - merged);
+  // the leaves merged away are deleted from the buffer pool
+  for (auto leaf : leaves) {
+    if (std::find(compacted.begin(), compacted.end(), leaf) == compacted.end()) {
+      EXPECT_FALSE(bpm->IsPageResident(leaf));
+    }
+  }
+  CheckKeys(&tree, scale, removed);
+  // a compacted tree has nothing left to merge
+  EXPECT_EQ(tree.Compact(1.0), 0);
+
+  // the compacted tree still splits and merges
+  for (int64_t key = 1; key < scale; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+    removed[key] = false;
+  }
+  for (int64_t key = 1; key < scale; key += 3) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, nullptr);
+    removed[key] = true;
+  }
+  CheckKeys(&tree, scale, removed);
+}
+
+TEST(BPlusTreeTests, ConcurrentCompactTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  bpm->UnpinPage(header_page->GetPageId(), true);
+  CompactTree tree("foo_pk", page_id, bpm.get(), comparator, 6, 5, 0.0);
+
+  int64_t scale = 3000;
+  GenericKey<8> index_key;
+  for (int64_t key = 1; key < scale; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+
+  // removes race with a compaction pass running in a loop
+  std::atomic<bool> done{false};
+  std::thread compactor([&] {
+    while (!done) {
+      tree.Compact();
+    }
+  });
+  std::vector<std::thread> threads;
+  for (int64_t thread = 0; thread < 4; thread++) {
+    threads.emplace_back([&, thread] {
+      GenericKey<8> key_buf;
+      for (int64_t key = 1 + thread; key < scale; key += 4) {
+        if (key % 7 != 0) {
+          key_buf.SetFromInteger(key);
+          tree.Remove(key_buf, nullptr);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  compactor.join();
+
+  std::vector<bool> removed(scale, false);
+  for (int64_t key = 1; key < scale; key++) {
+    removed[key] = key % 7 != 0;
+  }
+  CheckKeys(&tree, scale, removed);
+}
 }  // namespace bustub
@@ -13,6 +13,10 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdio>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -185,4 +189,76 @@ TEST(BPlusTreeTests, InsertTest3) {
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, InsertBatchTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 5);
+  GenericKey<8> index_key;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  std::mt19937 rng(15445);
+  std::set<int64_t> expected;
+  for (int batch = 0; batch < 20; batch++) {
+    // random keys with duplicates inside the batch and against the tree, the first value of a key wins
+    std::vector<std::pair<GenericKey<8>, RID>> entries;
+    size_t new_keys = 0;
+    std::set<int64_t> batch_keys;
+    for (int i = 0; i < 1 + batch * 10; i++) {
+      int64_t key = rng() % 1000;
+      index_key.SetFromInteger(key);
+      entries.emplace_back(index_key, RID(batch, static_cast<uint32_t>(key)));
+      if (expected.count(key) == 0 && batch_keys.insert(key).second) {
+        new_keys++;
+      }
+    }
+    EXPECT_EQ(tree.InsertBatch(entries, transaction), new_keys);
+    expected.insert(batch_keys.begin(), batch_keys.end());
+  }
+
+  std::vector<RID> rids;
+  for (auto key : expected) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+  auto expected_iter = expected.begin();
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++expected_iter) {
+    ASSERT_NE(expected_iter, expected.end());
+    EXPECT_EQ((*iterator).first.ToString(), *expected_iter);
+  }
+  EXPECT_EQ(expected_iter, expected.end());
+
+  // single inserts and removes keep working on the batch built tree
+  for (int64_t key = 0; key < 1000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+    expected.erase(key);
+  }
+  for (int64_t key = 1000; key < 1100; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+    expected.insert(key);
+  }
+  expected_iter = expected.begin();
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++expected_iter) {
+    ASSERT_NE(expected_iter, expected.end());
+    EXPECT_EQ((*iterator).first.ToString(), *expected_iter);
+  }
+  EXPECT_EQ(expected_iter, expected.end());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
 }  // namespace bustub
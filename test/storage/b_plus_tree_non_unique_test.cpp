@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_non_unique_test.cpp
+//
+// Identification: test/storage/b_plus_tree_non_unique_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using NonUniqueInt64Key = NonUniqueKey<IntegerKey<int64_t, 1>>;
+using NonUniqueInt64Comparator = NonUniqueComparator<IntegerKey<int64_t, 1>, IntegerKeyComparator<int64_t, 1>>;
+using NonUniqueTree = BPlusTree<NonUniqueInt64Key, RID, NonUniqueInt64Comparator>;
+
+static auto Key(int64_t key, RID rid) -> NonUniqueInt64Key {
+  NonUniqueInt64Key index_key;
+  index_key.SetFromInteger(key);
+  index_key.SetRid(rid);
+  return index_key;
+}
+
+TEST(BPlusTreeTests, NonUniqueKeyTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  NonUniqueInt64Comparator comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  NonUniqueTree tree("foo_idx", header_page->GetPageId(), bpm, comparator, 3, 5);
+  auto *transaction = new Transaction(0);
+
+  // every key gets 10 entries, so the entries of one key span several leaves
+  const int64_t key_count = 20;
+  const int32_t dup_count = 10;
+  for (int32_t page = dup_count - 1; page >= 0; page--) {
+    for (int64_t key = 0; key < key_count; key++) {
+      RID rid(page, static_cast<uint32_t>(key));
+      ASSERT_TRUE(tree.Insert(Key(key, rid), rid, transaction));
+    }
+  }
+  // the same key with the same RID is still a duplicate entry
+  ASSERT_FALSE(tree.Insert(Key(3, RID(0, 3)), RID(0, 3), transaction));
+
+  // a lookup returns every RID of the key, in RID order, whatever RID the probe key carries
+  for (int64_t key = 0; key < key_count; key++) {
+    std::vector<RID> rids;
+    ASSERT_TRUE(tree.GetValue(Key(key, RID(dup_count + 5, 0)), &rids));
+    ASSERT_EQ(rids.size(), dup_count);
+    for (int32_t page = 0; page < dup_count; page++) {
+      EXPECT_EQ(rids[page], RID(page, static_cast<uint32_t>(key)));
+    }
+  }
+  std::vector<RID> rids;
+  ASSERT_FALSE(tree.GetValue(Key(key_count, RID()), &rids));
+  ASSERT_TRUE(rids.empty());
+
+  // removing an entry only removes the entry with that RID
+  for (int64_t key = 0; key < key_count; key += 2) {
+    for (int32_t page = 0; page < dup_count; page += 2) {
+      tree.Remove(Key(key, RID(page, static_cast<uint32_t>(key))), transaction);
+    }
+  }
+  for (int64_t key = 0; key < key_count; key++) {
+    rids.clear();
+    ASSERT_TRUE(tree.GetValue(Key(key, RID()), &rids));
+    ASSERT_EQ(rids.size(), key % 2 == 0 ? dup_count / 2 : dup_count);
+    for (const auto &rid : rids) {
+      EXPECT_EQ(rid.GetSlotNum(), key);
+      EXPECT_TRUE(key % 2 == 1 || rid.GetPageId() % 2 == 1);
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, NonUniqueIndexTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+
+  auto schema = ParseCreateStatement("a integer,b integer");
+  auto *table_info = catalog->CreateTable(nullptr, "t", *schema);
+  std::vector<RID> table_rids;
+  for (int32_t i = 0; i < 100; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i % 4), ValueFactory::GetIntegerValue(i)}, schema.get());
+    table_rids.push_back(*table_info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+
+  // a non-unique index keeps every row of a duplicate key, a unique one only the first
+  Schema key_schema = Schema::CopySchema(schema.get(), {0});
+  auto *index_info = catalog->CreateIndex(nullptr, "t_a", "t", *schema, key_schema, {0}, false);
+  auto *unique_info = catalog->CreateIndex(nullptr, "t_a_unique", "t", *schema, key_schema, {0}, true);
+  ASSERT_NE(index_info, nullptr);
+  ASSERT_NE(unique_info, nullptr);
+
+  for (int32_t a = 0; a < 4; a++) {
+    Tuple key({ValueFactory::GetIntegerValue(a)}, &key_schema);
+    std::vector<RID> rids;
+    index_info->index_->ScanKey(key, &rids, nullptr);
+    ASSERT_EQ(rids.size(), 25);
+    rids.clear();
+    unique_info->index_->ScanKey(key, &rids, nullptr);
+    ASSERT_EQ(rids.size(), 1);
+  }
+
+  // rows inserted and deleted after the index was built
+  Tuple key({ValueFactory::GetIntegerValue(1)}, &key_schema);
+  ASSERT_TRUE(index_info->index_->InsertEntry(key, RID(1000, 0), nullptr));
+  index_info->index_->DeleteEntry(key, table_rids[1], nullptr);
+  index_info->index_->DeleteEntry(key, table_rids[5], nullptr);
+  std::vector<RID> rids;
+  index_info->index_->ScanKey(key, &rids, nullptr);
+  ASSERT_EQ(rids.size(), 24);
+  EXPECT_EQ(rids.back(), RID(1000, 0));
+  for (const auto &rid : rids) {
+    EXPECT_FALSE(rid == table_rids[1]);
+    EXPECT_FALSE(rid == table_rids[5]);
+  }
+}
+
+}  // namespace bustub
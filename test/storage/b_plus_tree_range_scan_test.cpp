@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_range_scan_test.cpp
+//
+// Identification: test/storage/b_plus_tree_range_scan_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using RangeScanTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+static auto Key(int64_t key) -> std::optional<GenericKey<8>> {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+// collect the keys returned by a range scan, checking that no batch spans more than one leaf
+static auto Scan(RangeScanTree *tree, const std::optional<GenericKey<8>> &lo, bool lo_inclusive,
+                 const std::optional<GenericKey<8>> &hi, bool hi_inclusive, bool reverse = false)
+    -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  auto cursor = tree->ScanRange(lo, lo_inclusive, hi, hi_inclusive, reverse);
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  while (cursor.NextBatch(&batch)) {
+    EXPECT_LE(batch.size(), 3);
+    for (const auto &entry : batch) {
+      keys.push_back(entry.first.ToString());
+    }
+  }
+  EXPECT_TRUE(batch.empty());
+  EXPECT_TRUE(cursor.IsEnd());
+  return keys;
+}
+
+static auto Range(int64_t begin, int64_t end, int64_t step = 2) -> std::vector<int64_t> {
+  std::vector<int64_t> keys;
+  for (int64_t key = begin; key < end; key += step) {
+    keys.push_back(key);
+  }
+  return keys;
+}
+
+static auto Reversed(std::vector<int64_t> keys) -> std::vector<int64_t> {
+  std::reverse(keys.begin(), keys.end());
+  return keys;
+}
+
+TEST(BPlusTreeTests, RangeScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  RangeScanTree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 5);
+  auto *transaction = new Transaction(0);
+
+  // empty tree
+  EXPECT_TRUE(Scan(&tree, std::nullopt, true, std::nullopt, true).empty());
+
+  // even keys 0, 2, ..., 198
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 200; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key), transaction);
+  }
+
+  EXPECT_EQ(Scan(&tree, std::nullopt, true, std::nullopt, true), Range(0, 200));
+  EXPECT_EQ(Scan(&tree, Key(10), true, Key(20), true), Range(10, 21));
+  EXPECT_EQ(Scan(&tree, Key(10), false, Key(20), false), Range(12, 20));
+  EXPECT_EQ(Scan(&tree, Key(11), true, Key(21), true), Range(12, 21));
+  EXPECT_EQ(Scan(&tree, Key(11), false, Key(21), false), Range(12, 21));
+  EXPECT_EQ(Scan(&tree, std::nullopt, true, Key(7), true), Range(0, 7));
+  EXPECT_EQ(Scan(&tree, Key(191), true, std::nullopt, true), Range(192, 200));
+  EXPECT_EQ(Scan(&tree, Key(50), true, Key(50), true), Range(50, 51));
+  EXPECT_TRUE(Scan(&tree, Key(50), false, Key(50), true).empty());
+  EXPECT_TRUE(Scan(&tree, Key(51), true, Key(51), true).empty());
+  EXPECT_TRUE(Scan(&tree, Key(300), true, std::nullopt, true).empty());
+  EXPECT_TRUE(Scan(&tree, std::nullopt, true, Key(-1), true).empty());
+  EXPECT_TRUE(Scan(&tree, Key(20), true, Key(10), true).empty());
+
+  // the iterator keeps returning the right entries across leaves after being copied
+  auto iter = tree.Begin();
+  auto copy = iter;
+  int64_t expected = 0;
+  for (; copy != tree.End(); ++copy) {
+    EXPECT_EQ((*copy).second.GetSlotNum(), expected);
+    expected += 2;
+  }
+  EXPECT_EQ(expected, 200);
+  EXPECT_EQ((*iter).second.GetSlotNum(), 0);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, ReverseScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  RangeScanTree tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 5);
+  auto *transaction = new Transaction(0);
+
+  EXPECT_TRUE(tree.RBegin() == tree.End());
+  EXPECT_TRUE(Scan(&tree, std::nullopt, true, std::nullopt, true, true).empty());
+
+  // keys 0, 2, ..., 398, then remove every other key of the lower half so that leaves get merged
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < 400; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key), transaction);
+  }
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 400; key += 2) {
+    if (key < 200 && key % 4 == 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    } else {
+      keys.push_back(key);
+    }
+  }
+
+  std::vector<int64_t> reversed;
+  for (auto iter = tree.RBegin(); iter != tree.End(); ++iter) {
+    reversed.push_back((*iter).first.ToString());
+  }
+  EXPECT_EQ(reversed, Reversed(keys));
+  EXPECT_EQ(Scan(&tree, std::nullopt, true, std::nullopt, true, true), Reversed(keys));
+
+  EXPECT_EQ(Scan(&tree, Key(300), true, Key(310), true, true), Reversed(Range(300, 311)));
+  EXPECT_EQ(Scan(&tree, Key(300), false, Key(310), false, true), Reversed(Range(302, 310)));
+  EXPECT_EQ(Scan(&tree, Key(301), true, Key(311), true, true), Reversed(Range(302, 311)));
+  EXPECT_EQ(Scan(&tree, Key(390), true, std::nullopt, true, true), Reversed(Range(390, 400)));
+  EXPECT_EQ(Scan(&tree, std::nullopt, true, Key(10), true, true), Reversed(std::vector<int64_t>{2, 6, 10}));
+  EXPECT_EQ(Scan(&tree, Key(250), true, Key(250), true, true), Range(250, 251));
+  EXPECT_TRUE(Scan(&tree, Key(250), true, Key(250), false, true).empty());
+  EXPECT_TRUE(Scan(&tree, Key(4), true, Key(4), true, true).empty());
+  EXPECT_TRUE(Scan(&tree, Key(500), true, std::nullopt, true, true).empty());
+
+  // inserting again splits the merged leaves, the prev links follow
+  for (int64_t key = 1; key < 400; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key), transaction);
+    keys.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(Scan(&tree, std::nullopt, true, std::nullopt, true, true), Reversed(keys));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+}  // namespace bustub
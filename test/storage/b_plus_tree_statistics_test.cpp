@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_statistics_test.cpp
+//
+// Identification: test/storage/b_plus_tree_statistics_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/non_unique_key.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using Int64Key = IntegerKey<int64_t, 1>;
+using Int64Tree = BPlusTree<Int64Key, RID, IntegerKeyComparator<int64_t, 1>>;
+using NonUniqueInt64Key = NonUniqueKey<Int64Key>;
+using NonUniqueTree =
+    BPlusTree<NonUniqueInt64Key, RID, NonUniqueComparator<Int64Key, IntegerKeyComparator<int64_t, 1>>>;
+
+static auto Key(int64_t key) -> Int64Key {
+  Int64Key index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+static auto NonUniqueKeyOf(int64_t key, const RID &rid) -> NonUniqueInt64Key {
+  NonUniqueInt64Key index_key;
+  index_key.key_ = Key(key);
+  index_key.rid_ = rid;
+  return index_key;
+}
+
+TEST(BPlusTreeTests, StatisticsTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  IntegerKeyComparator<int64_t, 1> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id);
+  // small pages, so that the tree grows a few levels
+  Int64Tree tree("foo_pk", page_id, bpm.get(), comparator, 8, 8);
+  EXPECT_EQ(tree.GetEntryCount(), 0);
+  EXPECT_EQ(tree.GetHeight(), 0);
+
+  const int64_t key_count = 2000;
+  for (int64_t key = 0; key < key_count; key += 2) {
+    ASSERT_TRUE(tree.Insert(Key(key), RID(key)));
+  }
+  // a key already in the tree is not counted again
+  ASSERT_FALSE(tree.Insert(Key(0), RID(0)));
+  std::vector<std::pair<Int64Key, RID>> batch;
+  for (int64_t key = 1; key < key_count; key += 2) {
+    batch.emplace_back(Key(key), RID(key));
+  }
+  batch.emplace_back(Key(0), RID(0));
+  ASSERT_EQ(tree.InsertBatch(batch), key_count / 2);
+
+  EXPECT_EQ(tree.GetEntryCount(), key_count);
+  EXPECT_EQ(tree.GetDistinctKeyCount(), key_count);
+  // leaves are at least half full, and at least 4 levels of 8 children hold 2000 entries
+  EXPECT_GE(tree.GetLeafPageCount(), key_count / 8);
+  EXPECT_LE(tree.GetLeafPageCount(), key_count / 4 + 1);
+  EXPECT_GE(tree.GetHeight(), 4);
+  EXPECT_LE(tree.GetHeight(), 8);
+
+  size_t leaves = 0;
+  for (auto cursor = tree.ScanRange(std::nullopt, true, std::nullopt, true); cursor.NextBatch(&batch);) {
+    leaves++;
+  }
+  EXPECT_EQ(tree.GetLeafPageCount(), leaves);
+
+  // removes merge the leaves back, a key that is absent is not counted
+  for (int64_t key = 0; key < key_count; key++) {
+    if (key % 4 != 0) {
+      tree.Remove(Key(key), nullptr);
+    }
+  }
+  tree.Remove(Key(key_count), nullptr);
+  EXPECT_EQ(tree.GetEntryCount(), key_count / 4);
+  leaves = 0;
+  for (auto cursor = tree.ScanRange(std::nullopt, true, std::nullopt, true); cursor.NextBatch(&batch);) {
+    leaves++;
+  }
+  EXPECT_EQ(tree.GetLeafPageCount(), leaves);
+
+  // a bulk loaded tree counts its entries and leaves too
+  bpm->NewPageGuarded(&page_id);
+  Int64Tree loaded("bar_pk", page_id, bpm.get(), comparator, 8, 8);
+  batch.clear();
+  for (int64_t key = 0; key < key_count; key++) {
+    batch.emplace_back(Key(key), RID(key));
+  }
+  ASSERT_TRUE(loaded.BulkLoad(batch));
+  EXPECT_EQ(loaded.GetEntryCount(), key_count);
+  leaves = 0;
+  for (auto cursor = loaded.ScanRange(std::nullopt, true, std::nullopt, true); cursor.NextBatch(&batch);) {
+    leaves++;
+  }
+  EXPECT_EQ(loaded.GetLeafPageCount(), leaves);
+  EXPECT_GE(loaded.GetHeight(), 4);
+}
+
+TEST(BPlusTreeTests, DistinctKeyCountTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  NonUniqueComparator<Int64Key, IntegerKeyComparator<int64_t, 1>> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id);
+  NonUniqueTree tree("foo_a", page_id, bpm.get(), comparator);
+
+  // 5000 distinct keys of 10 entries each
+  const int64_t distinct_count = 5000;
+  for (int64_t i = 0; i < distinct_count * 10; i++) {
+    RID rid(static_cast<page_id_t>(i), 0);
+    ASSERT_TRUE(tree.Insert(NonUniqueKeyOf(i % distinct_count, rid), rid));
+  }
+  EXPECT_EQ(tree.GetEntryCount(), distinct_count * 10);
+  auto estimate = static_cast<double>(tree.GetDistinctKeyCount());
+  EXPECT_NEAR(estimate, distinct_count, distinct_count * 0.05);
+
+  // a few distinct keys are counted exactly enough to tell a selective key from an unselective one
+  bpm->NewPageGuarded(&page_id);
+  NonUniqueTree few("bar_a", page_id, bpm.get(), comparator);
+  for (int64_t i = 0; i < 1000; i++) {
+    RID rid(static_cast<page_id_t>(i), 0);
+    ASSERT_TRUE(few.Insert(NonUniqueKeyOf(i % 3, rid), rid));
+  }
+  EXPECT_EQ(few.GetDistinctKeyCount(), 3);
+}
+
+}  // namespace bustub
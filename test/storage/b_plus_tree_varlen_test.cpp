@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen_test.cpp
+//
+// Identification: test/storage/b_plus_tree_varlen_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/varlen_b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// keys with a long common prefix, ordered like their number
+static auto KeyString(int64_t key) -> std::string {
+  auto number = std::to_string(key);
+  return "https://example.com/catalog/items/" + std::string(8 - number.size(), '0') + number;
+}
+
+static auto Key(int64_t key) -> VarlenKey {
+  VarlenKey index_key;
+  index_key.SetFromString(KeyString(key));
+  return index_key;
+}
+
+static auto ScanKeys(VarlenBPlusTree *tree, std::optional<int64_t> lo, bool lo_inclusive, std::optional<int64_t> hi,
+                     bool hi_inclusive, bool reverse) -> std::vector<int64_t> {
+  std::optional<VarlenKey> lo_key;
+  if (lo.has_value()) {
+    lo_key = Key(*lo);
+  }
+  std::optional<VarlenKey> hi_key;
+  if (hi.has_value()) {
+    hi_key = Key(*hi);
+  }
+  auto cursor = tree->ScanRange(lo_key, lo_inclusive, hi_key, hi_inclusive, reverse);
+  std::vector<int64_t> values;
+  VarlenRangeCursor::BatchType batch;
+  while (cursor.NextBatch(&batch)) {
+    for (const auto &entry : batch) {
+      values.push_back(entry.second.GetSlotNum());
+    }
+  }
+  return values;
+}
+
+TEST(BPlusTreeTests, VarlenKeyTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  VarlenBPlusTree tree("foo_idx", header_page->GetPageId(), bpm);
+  auto *transaction = new Transaction(0);
+
+  const int64_t key_count = 5000;
+  std::vector<int64_t> keys(key_count);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    ASSERT_TRUE(tree.Insert(Key(key), RID(0, key), transaction));
+  }
+  ASSERT_FALSE(tree.Insert(Key(42), RID(0, 42), transaction));
+
+  for (int64_t key = 0; key < key_count; key++) {
+    std::vector<RID> rids;
+    ASSERT_TRUE(tree.GetValue(Key(key), &rids));
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+  std::vector<RID> rids;
+  ASSERT_FALSE(tree.GetValue(Key(key_count), &rids));
+
+  // each leaf stores the prefix shared by its 45 byte keys once and each separator only the bytes that tell its
+  // leaves apart, so 5000 keys fit under a single internal page
+  ASSERT_EQ(tree.GetHeight(), 2);
+  {
+    auto guard = bpm->FetchPageRead(tree.GetRootPageId());
+    auto root = guard.As<BPlusTreeSlottedPage>();
+    ASSERT_FALSE(root->IsLeafPage());
+    for (int i = 1; i < root->GetSize(); i++) {
+      EXPECT_LT(root->KeyAt(i).size(), Key(0).data_.size());
+    }
+    auto leaf_guard = bpm->FetchPageRead(root->ValueAt(0));
+    auto leaf = leaf_guard.As<BPlusTreeSlottedPage>();
+    ASSERT_TRUE(leaf->IsLeafPage());
+    EXPECT_GE(leaf->GetPrefix().size(), KeyString(0).size() - 8);
+  }
+
+  // full and bounded scans in both directions
+  std::vector<int64_t> expected(key_count);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(ScanKeys(&tree, std::nullopt, true, std::nullopt, true, false), expected);
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(ScanKeys(&tree, std::nullopt, true, std::nullopt, true, true), expected);
+  for (bool lo_inclusive : {true, false}) {
+    for (bool hi_inclusive : {true, false}) {
+      expected.clear();
+      for (int64_t key = lo_inclusive ? 1000 : 1001; key <= (hi_inclusive ? 3000 : 2999); key++) {
+        expected.push_back(key);
+      }
+      EXPECT_EQ(ScanKeys(&tree, 1000, lo_inclusive, 3000, hi_inclusive, false), expected);
+      std::reverse(expected.begin(), expected.end());
+      EXPECT_EQ(ScanKeys(&tree, 1000, lo_inclusive, 3000, hi_inclusive, true), expected);
+    }
+  }
+
+  // remove all keys but every tenth, empty leaves are skipped by scans
+  for (auto key : keys) {
+    if (key % 10 != 0) {
+      tree.Remove(Key(key), transaction);
+    }
+  }
+  expected.clear();
+  for (int64_t key = 0; key < key_count; key += 10) {
+    expected.push_back(key);
+    rids.clear();
+    ASSERT_TRUE(tree.GetValue(Key(key), &rids));
+    ASSERT_FALSE(tree.GetValue(Key(key + 1), &rids));
+  }
+  EXPECT_EQ(ScanKeys(&tree, std::nullopt, true, std::nullopt, true, false), expected);
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(ScanKeys(&tree, std::nullopt, true, std::nullopt, true, true), expected);
+
+  // keys that do not fit in a page slot are rejected
+  VarlenKey long_key;
+  long_key.data_ = std::string(SLOTTED_PAGE_MAX_KEY_SIZE + 1, 'x');
+  EXPECT_THROW(tree.Insert(long_key, RID(0, 0), transaction), Exception);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, VarlenIndexTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+
+  auto schema = ParseCreateStatement("a varchar(100),b integer");
+  auto *table_info = catalog->CreateTable(nullptr, "t", *schema);
+  std::vector<RID> table_rids;
+  for (int32_t i = 0; i < 200; i++) {
+    Tuple tuple({ValueFactory::GetVarcharValue("name_" + std::to_string(i % 20)), ValueFactory::GetIntegerValue(i)},
+                schema.get());
+    table_rids.push_back(*table_info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+
+  // VARCHAR keys get a varlen index, unique or not
+  Schema key_schema = Schema::CopySchema(schema.get(), {0});
+  auto *index_info = catalog->CreateIndex(nullptr, "t_a", "t", *schema, key_schema, {0}, false);
+  auto *unique_info = catalog->CreateIndex(nullptr, "t_a_unique", "t", *schema, key_schema, {0}, true);
+  ASSERT_NE(dynamic_cast<VarlenBPlusTreeIndex *>(index_info->index_.get()), nullptr);
+  ASSERT_NE(dynamic_cast<VarlenBPlusTreeIndex *>(unique_info->index_.get()), nullptr);
+
+  for (int32_t i = 0; i < 20; i++) {
+    Tuple key({ValueFactory::GetVarcharValue("name_" + std::to_string(i))}, &key_schema);
+    std::vector<RID> rids;
+    index_info->index_->ScanKey(key, &rids, nullptr);
+    ASSERT_EQ(rids.size(), 10);
+    for (const auto &rid : rids) {
+      EXPECT_EQ(table_info->table_->GetTuple(rid).second.GetValue(schema.get(), 1).GetAs<int32_t>() % 20, i);
+    }
+    rids.clear();
+    unique_info->index_->ScanKey(key, &rids, nullptr);
+    ASSERT_EQ(rids.size(), 1);
+  }
+
+  // a range scan of a non-unique index returns every entry of the bound keys it includes
+  auto *index = dynamic_cast<VarlenBPlusTreeIndex *>(index_info->index_.get());
+  VarlenKey lo;
+  lo.SetFromKey(Tuple({ValueFactory::GetVarcharValue("name_1")}, &key_schema), &key_schema);
+  VarlenKey hi;
+  hi.SetFromKey(Tuple({ValueFactory::GetVarcharValue("name_11")}, &key_schema), &key_schema);
+  for (bool reverse : {false, true}) {
+    auto cursor = index->ScanRange(lo, true, hi, true, reverse);
+    size_t count = 0;
+    VarlenRangeCursor::BatchType batch;
+    while (cursor.NextBatch(&batch)) {
+      for (const auto &entry : batch) {
+        EXPECT_EQ(entry.first.ToValue(&key_schema, 0).ToString().substr(0, 6), "name_1");
+        count++;
+      }
+    }
+    EXPECT_EQ(count, 30);
+  }
+
+  // rows deleted after the index was built
+  Tuple key({ValueFactory::GetVarcharValue("name_3")}, &key_schema);
+  index_info->index_->DeleteEntry(key, table_rids[3], nullptr);
+  std::vector<RID> rids;
+  index_info->index_->ScanKey(key, &rids, nullptr);
+  ASSERT_EQ(rids.size(), 9);
+  for (const auto &rid : rids) {
+    EXPECT_FALSE(rid == table_rids[3]);
+  }
+}
+
+}  // namespace bustub
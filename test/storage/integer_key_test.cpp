@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// integer_key_test.cpp
+//
+// Identification: test/storage/integer_key_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/integer_key.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(IntegerKeyTest, NullAndNegativeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  IntegerKeyComparator<int64_t, 1> comparator(key_schema.get());
+
+  IntegerKey<int64_t, 1> null_key;
+  IntegerKey<int64_t, 1> min_key;
+  IntegerKey<int64_t, 1> minus_one_key;
+  IntegerKey<int64_t, 1> zero_key;
+  std::vector<Value> values{ValueFactory::GetNullValueByType(TypeId::BIGINT)};
+  null_key.SetFromKey(Tuple(values, key_schema.get()), key_schema.get());
+  min_key.SetFromInteger(BUSTUB_INT64_MIN);
+  minus_one_key.SetFromInteger(-1);
+  zero_key.SetFromInteger(0);
+
+  // the NULL sentinel sorts before the smallest value
+  ASSERT_LT(comparator(null_key, min_key), 0);
+  ASSERT_LT(comparator(min_key, minus_one_key), 0);
+  ASSERT_LT(comparator(minus_one_key, zero_key), 0);
+  ASSERT_EQ(comparator(null_key, null_key), 0);
+  ASSERT_EQ(minus_one_key.ToString(), -1);
+  ASSERT_TRUE(null_key.ToValue(key_schema.get(), 0).IsNull());
+  ASSERT_EQ(min_key.ToValue(key_schema.get(), 0).GetAs<int64_t>(), BUSTUB_INT64_MIN);
+}
+
+TEST(IntegerKeyTest, TwoColumnTest) {
+  auto key_schema = ParseCreateStatement("a integer,b integer");
+  IntegerKeyComparator<int32_t, 2> comparator(key_schema.get());
+
+  std::vector<Tuple> tuples;
+  std::vector<Value> candidates{ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetIntegerValue(-7),
+                                ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(1),
+                                ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX)};
+  for (const auto &a : candidates) {
+    for (const auto &b : candidates) {
+      tuples.emplace_back(std::vector<Value>{a, b}, key_schema.get());
+    }
+  }
+
+  // the first column decides, the second breaks ties, NULL sorts first in either
+  auto compare_values = [](const Value &lhs, const Value &rhs) {
+    if (lhs.IsNull() || rhs.IsNull()) {
+      return static_cast<int>(rhs.IsNull()) - static_cast<int>(lhs.IsNull());
+    }
+    if (lhs.CompareLessThan(rhs) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    return lhs.CompareGreaterThan(rhs) == CmpBool::CmpTrue ? 1 : 0;
+  };
+  for (const auto &lhs : tuples) {
+    for (const auto &rhs : tuples) {
+      IntegerKey<int32_t, 2> lhs_key;
+      IntegerKey<int32_t, 2> rhs_key;
+      lhs_key.SetFromKey(lhs, key_schema.get());
+      rhs_key.SetFromKey(rhs, key_schema.get());
+
+      int expected = 0;
+      for (uint32_t i = 0; i < key_schema->GetColumnCount() && expected == 0; i++) {
+        expected = compare_values(lhs.GetValue(key_schema.get(), i), rhs.GetValue(key_schema.get(), i));
+      }
+      ASSERT_EQ(comparator(lhs_key, rhs_key), expected);
+    }
+  }
+
+  // round trip
+  IntegerKey<int32_t, 2> key;
+  key.SetFromKey(tuples[8], key_schema.get());
+  ASSERT_EQ(key.ToValue(key_schema.get(), 0).GetAs<int32_t>(),
+            tuples[8].GetValue(key_schema.get(), 0).GetAs<int32_t>());
+  ASSERT_EQ(key.ToValue(key_schema.get(), 1).GetAs<int32_t>(),
+            tuples[8].GetValue(key_schema.get(), 1).GetAs<int32_t>());
+}
+
+TEST(IntegerKeyTest, BPlusTreeTest) {
+  auto key_schema = ParseCreateStatement("a integer");
+  IntegerKeyComparator<int32_t, 1> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<IntegerKey<int32_t, 1>, RID, IntegerKeyComparator<int32_t, 1>> tree("foo_pk", header_page->GetPageId(),
+                                                                                 bpm, comparator, 3, 5);
+  auto *transaction = new Transaction(0);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = -500; key < 500; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  IntegerKey<int32_t, 1> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)), transaction);
+  }
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids[0].GetSlotNum(), static_cast<uint32_t>(key));
+  }
+
+  int64_t expected = -500;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ((*iter).first.ToString(), expected);
+    expected++;
+  }
+  ASSERT_EQ(expected, 500);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(IntegerKeyTest, CatalogKeyTypeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+
+  auto schema = ParseCreateStatement("a integer,b integer,c bigint,d integer");
+  auto *table_info = catalog->CreateTable(nullptr, "t", *schema);
+  for (int32_t i = 0; i < 100; i++) {
+    auto a = i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+    Tuple tuple(
+        {a, ValueFactory::GetIntegerValue(-i), ValueFactory::GetBigIntValue(i), ValueFactory::GetIntegerValue(i)},
+        schema.get());
+    table_info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+  }
+
+  // one INTEGER, one BIGINT and two INTEGER columns get native integer keys
+  auto *int32_info = catalog->CreateIndex(nullptr, "t_a", "t", *schema, Schema::CopySchema(schema.get(), {0}), {0});
+  auto *int64_info = catalog->CreateIndex(nullptr, "t_c", "t", *schema, Schema::CopySchema(schema.get(), {2}), {2});
+  auto *two_int32_info =
+      catalog->CreateIndex(nullptr, "t_ab", "t", *schema, Schema::CopySchema(schema.get(), {0, 1}), {0, 1});
+  ASSERT_NE(dynamic_cast<BPlusTreeIndexForInt32Column *>(int32_info->index_.get()), nullptr);
+  ASSERT_NE(dynamic_cast<BPlusTreeIndexForInt64Column *>(int64_info->index_.get()), nullptr);
+  ASSERT_NE(dynamic_cast<BPlusTreeIndexForTwoInt32Column *>(two_int32_info->index_.get()), nullptr);
+
+  // columns of mixed integer types or more than two columns do not
+  auto *mixed_info =
+      catalog->CreateIndex(nullptr, "t_ac", "t", *schema, Schema::CopySchema(schema.get(), {0, 2}), {0, 2});
+  auto *three_info =
+      catalog->CreateIndex(nullptr, "t_abd", "t", *schema, Schema::CopySchema(schema.get(), {0, 1, 3}), {0, 1, 3});
+  using NormalizedIndex = BPlusTreeIndex<NormalizedKey<16>, RID, NormalizedComparator<16>>;
+  ASSERT_NE(dynamic_cast<NormalizedIndex *>(mixed_info->index_.get()), nullptr);
+  ASSERT_NE(dynamic_cast<NormalizedIndex *>(three_info->index_.get()), nullptr);
+
+  // the indexes built over the table find its rows, NULL keys included
+  auto key_schema = Schema::CopySchema(schema.get(), {0, 1});
+  for (int32_t i = 0; i < 100; i++) {
+    auto a = i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+    std::vector<RID> rids;
+    two_int32_info->index_->ScanKey(Tuple({a, ValueFactory::GetIntegerValue(-i)}, &key_schema), &rids, nullptr);
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(table_info->table_->GetTuple(rids[0]).second.GetValue(schema.get(), 3).GetAs<int32_t>(), i);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// learned_index_test.cpp
+//
+// Identification: test/storage/learned_index_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/learned_leaf_array.h"
+#include "storage/index/normalized_key.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+static auto MakeKey(int64_t key) -> NormalizedKey<16> {
+  NormalizedKey<16> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+TEST(LearnedIndexTest, LookupTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto key_schema = ParseCreateStatement("a bigint");
+  NormalizedComparator<16> comparator(key_schema.get());
+  // a small error bound, so that the model needs many segments
+  LearnedLeafArray<NormalizedKey<16>, RID, NormalizedComparator<16>> array("learned", bpm.get(), comparator, 4);
+
+  // keys with random gaps, every fifth key twice
+  std::mt19937_64 gen(445);
+  std::uniform_int_distribution<int64_t> gap(2, 100);
+  std::vector<int64_t> keys;
+  std::vector<std::pair<NormalizedKey<16>, RID>> entries;
+  int64_t key = -50000;
+  for (int i = 0; i < 30000; i++) {
+    key += gap(gen);
+    keys.push_back(key);
+    entries.emplace_back(MakeKey(key), RID(i, 0));
+    if (i % 5 == 0) {
+      entries.emplace_back(MakeKey(key), RID(i, 1));
+    }
+  }
+  array.Build(entries);
+  EXPECT_EQ(array.GetSize(), entries.size());
+  EXPECT_GT(array.GetSegmentCount(), 1);
+  EXPECT_GT(array.GetLeafPageCount(), 64);
+
+  for (int i = 0; i < static_cast<int>(keys.size()); i++) {
+    std::vector<RID> result;
+    ASSERT_TRUE(array.GetValue(MakeKey(keys[i]), &result));
+    std::vector<RID> expected{RID(i, 0)};
+    if (i % 5 == 0) {
+      expected.emplace_back(i, 1);
+    }
+    ASSERT_EQ(result, expected);
+    // the gaps are at least 2, so the key after each one is missing
+    result.clear();
+    ASSERT_FALSE(array.GetValue(MakeKey(keys[i] + 1), &result));
+    ASSERT_TRUE(result.empty());
+  }
+  std::vector<RID> result;
+  EXPECT_FALSE(array.GetValue(MakeKey(keys.front() - 1), &result));
+  EXPECT_FALSE(array.GetValue(MakeKey(keys.back() + 1000), &result));
+}
+
+TEST(LearnedIndexTest, SharedPrefixTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto key_schema = ParseCreateStatement("a varchar(24)");
+  NormalizedComparator<32> comparator(key_schema.get());
+  LearnedLeafArray<NormalizedKey<32>, RID, NormalizedComparator<32>> array("learned", bpm.get(), comparator, 4);
+
+  // the first 8 bytes of every key are the same, so the model can not tell the keys apart and the search widens
+  auto make_key = [&key_schema](int i) {
+    NormalizedKey<32> index_key;
+    Tuple tuple({ValueFactory::GetVarcharValue(fmt::format("same_prefix_{:06}", i))}, key_schema.get());
+    index_key.SetFromKey(tuple, key_schema.get());
+    return index_key;
+  };
+  std::vector<std::pair<NormalizedKey<32>, RID>> entries;
+  for (int i = 0; i < 5000; i += 2) {
+    entries.emplace_back(make_key(i), RID(i, 0));
+  }
+  array.Build(entries);
+  EXPECT_EQ(array.GetSegmentCount(), 1);
+
+  for (int i = 0; i < 5000; i++) {
+    std::vector<RID> result;
+    ASSERT_EQ(array.GetValue(make_key(i), &result), i % 2 == 0);
+    if (i % 2 == 0) {
+      ASSERT_EQ(result, std::vector<RID>{RID(i, 0)});
+    }
+  }
+}
+
+TEST(LearnedIndexTest, EmptyTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(8, disk_manager.get());
+  auto key_schema = ParseCreateStatement("a bigint");
+  NormalizedComparator<16> comparator(key_schema.get());
+  LearnedLeafArray<NormalizedKey<16>, RID, NormalizedComparator<16>> array("learned", bpm.get(), comparator);
+  array.Build({});
+  std::vector<RID> result;
+  EXPECT_FALSE(array.GetValue(MakeKey(1), &result));
+  EXPECT_EQ(array.GetSegmentCount(), 0);
+}
+
+}  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lsm_tree_test.cpp
+//
+// Identification: test/storage/lsm_tree_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/bloom_filter.h"
+#include "storage/index/lsm_tree.h"
+#include "storage/index/normalized_key.h"
+
+namespace bustub {
+
+using LsmKeyType = NormalizedKey<16>;
+using LsmTreeType = LsmTree<LsmKeyType, RID, NormalizedComparator<16>>;
+
+static auto MakeKey(int64_t key) -> LsmKeyType {
+  LsmKeyType index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+static auto Lookup(LsmTreeType *tree, int64_t key) -> std::vector<RID> {
+  std::vector<RID> result;
+  tree->GetValue(MakeKey(key), &result);
+  std::sort(result.begin(), result.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+  return result;
+}
+
+TEST(LsmTreeTest, BloomFilterTest) {
+  HashFunction<LsmKeyType> hash_fn;
+  BloomFilter filter(1000);
+  for (int64_t key = 0; key < 1000; key++) {
+    filter.Insert(hash_fn.GetHash(MakeKey(key)));
+  }
+  for (int64_t key = 0; key < 1000; key++) {
+    ASSERT_TRUE(filter.MayContain(hash_fn.GetHash(MakeKey(key))));
+  }
+  // about 1% false positives at the default bits per key
+  int false_positives = 0;
+  for (int64_t key = 1000; key < 11000; key++) {
+    false_positives += filter.MayContain(hash_fn.GetHash(MakeKey(key))) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, 300);
+}
+
+TEST(LsmTreeTest, InsertRemoveTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LsmTreeType tree("lsm", bpm.get(), NormalizedComparator<16>(nullptr), HashFunction<LsmKeyType>(), false, 64);
+
+  const int64_t num_keys = 1000;
+  for (int64_t key = 0; key < num_keys; key++) {
+    tree.Insert(MakeKey(key), RID(static_cast<page_id_t>(key), 0));
+    tree.Insert(MakeKey(key), RID(static_cast<page_id_t>(key), 1));
+  }
+  // the memtable and the runs are both read before the flush
+  EXPECT_EQ(Lookup(&tree, 7), (std::vector<RID>{RID(7, 0), RID(7, 1)}));
+  tree.Flush();
+  // compaction keeps a logarithmic number of runs
+  EXPECT_GT(tree.GetRunCount(), 0);
+  EXPECT_LE(tree.GetRunCount(), 6);
+  for (int64_t key = 0; key < num_keys; key++) {
+    auto page_id = static_cast<page_id_t>(key);
+    ASSERT_EQ(Lookup(&tree, key), (std::vector<RID>{RID(page_id, 0), RID(page_id, 1)}));
+  }
+  EXPECT_TRUE(Lookup(&tree, num_keys).empty());
+
+  // a tombstone hides the entry in the older runs, a later insert brings it back
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    tree.Remove(MakeKey(key), RID(static_cast<page_id_t>(key), 0));
+  }
+  tree.Insert(MakeKey(10), RID(10, 0));
+  for (int64_t key = 0; key < num_keys; key++) {
+    auto page_id = static_cast<page_id_t>(key);
+    if (key % 2 == 0 && key != 10) {
+      ASSERT_EQ(Lookup(&tree, key), (std::vector<RID>{RID(page_id, 1)}));
+    } else {
+      ASSERT_EQ(Lookup(&tree, key), (std::vector<RID>{RID(page_id, 0), RID(page_id, 1)}));
+    }
+  }
+
+  for (int64_t key = 0; key < num_keys; key++) {
+    tree.Remove(MakeKey(key), RID(static_cast<page_id_t>(key), 0));
+    tree.Remove(MakeKey(key), RID(static_cast<page_id_t>(key), 1));
+  }
+  tree.Flush();
+  for (int64_t key = 0; key < num_keys; key++) {
+    ASSERT_TRUE(Lookup(&tree, key).empty());
+  }
+}
+
+TEST(LsmTreeTest, UniqueKeysTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LsmTreeType tree("lsm", bpm.get(), NormalizedComparator<16>(nullptr), HashFunction<LsmKeyType>(), true, 32);
+
+  for (int64_t key = 0; key < 500; key++) {
+    ASSERT_TRUE(tree.Insert(MakeKey(key), RID(static_cast<page_id_t>(key), 0)));
+  }
+  tree.Flush();
+  for (int64_t key = 0; key < 500; key++) {
+    ASSERT_FALSE(tree.Insert(MakeKey(key), RID(static_cast<page_id_t>(key), 1)));
+  }
+  tree.Remove(MakeKey(42), RID(42, 0));
+  EXPECT_TRUE(tree.Insert(MakeKey(42), RID(42, 1)));
+  tree.Flush();
+  EXPECT_EQ(Lookup(&tree, 42), (std::vector<RID>{RID(42, 1)}));
+  EXPECT_EQ(Lookup(&tree, 43), (std::vector<RID>{RID(43, 0)}));
+}
+
+TEST(LsmTreeTest, ConcurrentInsertTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LsmTreeType tree("lsm", bpm.get(), NormalizedComparator<16>(nullptr), HashFunction<LsmKeyType>(), true, 128);
+
+  const int num_threads = 4;
+  const int64_t keys_per_thread = 2000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&tree, tid] {
+      for (int64_t key = tid; key < num_threads * keys_per_thread; key += num_threads) {
+        tree.Insert(MakeKey(key), RID(static_cast<page_id_t>(key), 0));
+        // lookups run alongside the flushes and compactions of the background thread
+        ASSERT_EQ(Lookup(&tree, key).size(), 1);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  tree.Flush();
+  for (int64_t key = 0; key < num_threads * keys_per_thread; key++) {
+    ASSERT_EQ(Lookup(&tree, key), (std::vector<RID>{RID(static_cast<page_id_t>(key), 0)}));
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key_test.cpp
+//
+// Identification: test/storage/normalized_key_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/normalized_key.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(NormalizedKeyTest, OrderPreservingTest) {
+  auto key_schema = ParseCreateStatement("a integer,b varchar(16)");
+  NormalizedComparator<32> comparator(key_schema.get());
+
+  std::vector<Tuple> tuples;
+  for (int32_t a : {-100000, -1, 0, 1, 7, 100000}) {
+    for (const char *b : {"", "a", "ab", "b", "ba"}) {
+      std::vector<Value> values{ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(b)};
+      tuples.emplace_back(values, key_schema.get());
+    }
+  }
+
+  for (const auto &lhs : tuples) {
+    for (const auto &rhs : tuples) {
+      NormalizedKey<32> lhs_key;
+      NormalizedKey<32> rhs_key;
+      lhs_key.SetFromKey(lhs, key_schema.get());
+      rhs_key.SetFromKey(rhs, key_schema.get());
+
+      int expected = 0;
+      for (uint32_t i = 0; i < key_schema->GetColumnCount() && expected == 0; i++) {
+        auto lhs_value = lhs.GetValue(key_schema.get(), i);
+        auto rhs_value = rhs.GetValue(key_schema.get(), i);
+        if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+          expected = -1;
+        } else if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+          expected = 1;
+        }
+      }
+      ASSERT_EQ(comparator(lhs_key, rhs_key), expected);
+    }
+  }
+
+  // round trip
+  NormalizedKey<32> key;
+  key.SetFromKey(tuples[7], key_schema.get());
+  ASSERT_EQ(key.ToValue(key_schema.get(), 0).GetAs<int32_t>(),
+            tuples[7].GetValue(key_schema.get(), 0).GetAs<int32_t>());
+  ASSERT_EQ(key.ToValue(key_schema.get(), 1).ToString(), tuples[7].GetValue(key_schema.get(), 1).ToString());
+}
+
+TEST(NormalizedKeyTest, NullAndNegativeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  NormalizedComparator<16> comparator(key_schema.get());
+
+  NormalizedKey<16> null_key;
+  NormalizedKey<16> min_key;
+  NormalizedKey<16> minus_one_key;
+  NormalizedKey<16> zero_key;
+  std::vector<Value> values{ValueFactory::GetNullValueByType(TypeId::BIGINT)};
+  null_key.SetFromKey(Tuple(values, key_schema.get()), key_schema.get());
+  min_key.SetFromInteger(BUSTUB_INT64_MIN);
+  minus_one_key.SetFromInteger(-1);
+  zero_key.SetFromInteger(0);
+
+  ASSERT_LT(comparator(null_key, min_key), 0);
+  ASSERT_LT(comparator(min_key, minus_one_key), 0);
+  ASSERT_LT(comparator(minus_one_key, zero_key), 0);
+  ASSERT_EQ(minus_one_key.ToString(), -1);
+  ASSERT_TRUE(null_key.ToValue(key_schema.get(), 0).IsNull());
+}
+
+TEST(NormalizedKeyTest, BPlusTreeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  NormalizedComparator<16> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<NormalizedKey<16>, RID, NormalizedComparator<16>> tree("foo_pk", header_page->GetPageId(), bpm,
+                                                                   comparator, 3, 5);
+  auto *transaction = new Transaction(0);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = -500; key < 500; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  NormalizedKey<16> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)), transaction);
+  }
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids[0].GetSlotNum(), static_cast<uint32_t>(key));
+  }
+
+  int64_t expected = -500;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ((*iter).first.ToString(), expected);
+    expected++;
+  }
+  ASSERT_EQ(expected, 500);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// rid_bitmap_test.cpp
+//
+// Identification: test/storage/rid_bitmap_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/table/rid_bitmap.h"
+
+namespace bustub {
+
+TEST(RidBitmapTest, InsertTest) {
+  RidBitmap bitmap;
+  bitmap.Insert(RID{7, 130});
+  bitmap.Insert(RID{3, 2});
+  bitmap.Insert(RID{7, 0});
+  bitmap.Insert(RID{3, 2});
+  bitmap.Insert(RID{3, 64});
+
+  EXPECT_EQ(bitmap.Size(), 4);
+  EXPECT_EQ(bitmap.GetPageCount(), 2);
+  EXPECT_EQ(bitmap.GetPageIds(), (std::vector<page_id_t>{3, 7}));
+  EXPECT_EQ(bitmap.GetSlots(3), (std::vector<uint32_t>{2, 64}));
+  EXPECT_EQ(bitmap.GetSlots(7), (std::vector<uint32_t>{0, 130}));
+  EXPECT_TRUE(bitmap.GetSlots(5).empty());
+  EXPECT_TRUE(bitmap.Contains(RID{7, 130}));
+  EXPECT_FALSE(bitmap.Contains(RID{7, 131}));
+  EXPECT_FALSE(bitmap.Contains(RID{7, 1000}));
+}
+
+TEST(RidBitmapTest, IntersectUnionTest) {
+  RidBitmap lhs;
+  RidBitmap rhs;
+  for (uint32_t slot = 0; slot < 200; slot += 2) {
+    lhs.Insert(RID{1, slot});
+    rhs.Insert(RID{2, slot});
+  }
+  for (uint32_t slot = 0; slot < 100; slot += 3) {
+    rhs.Insert(RID{1, slot});
+  }
+  lhs.Insert(RID{4, 9});
+
+  auto both = lhs;
+  both.IntersectWith(rhs);
+  // pages without a common slot are dropped
+  EXPECT_EQ(both.GetPageIds(), (std::vector<page_id_t>{1}));
+  std::vector<uint32_t> expected;
+  for (uint32_t slot = 0; slot < 100; slot += 6) {
+    expected.push_back(slot);
+  }
+  EXPECT_EQ(both.GetSlots(1), expected);
+
+  auto either = lhs;
+  either.UnionWith(rhs);
+  EXPECT_EQ(either.GetPageIds(), (std::vector<page_id_t>{1, 2, 4}));
+  EXPECT_EQ(either.Size(), 100 + 34 - expected.size() + 100 + 1);
+
+  RidBitmap empty;
+  either.IntersectWith(empty);
+  EXPECT_EQ(either.Size(), 0);
+  EXPECT_EQ(either.GetPageCount(), 0);
+}
+
+}  // namespace bustub
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -22,6 +23,8 @@
 #include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/generic_key.h"
+#include "storage/index/learned_leaf_array.h"
+#include "storage/index/normalized_key.h"
 #include "test_util.h"
 
 #include <sys/time.h>
@@ -34,10 +37,13 @@ auto ClockMs() -> uint64_t {
 
 static const size_t BUSTUB_READ_THREAD = 4;
 static const size_t BUSTUB_WRITE_THREAD = 2;
+static const size_t BUSTUB_SWEEP_MAX_THREAD = 64;
 static const size_t LRU_K_SIZE = 4;
 static const size_t BUSTUB_BPM_SIZE = 256;
 static const size_t TOTAL_KEYS = 100000;
 static const size_t KEY_MODIFY_RANGE = 2048;
+static const size_t LEARNED_BPM_SIZE = 4096;
+static const size_t LEARNED_LOOKUPS = 1000000;
 
 struct BTreeTotalMetrics {
   uint64_t write_cnt_{0};
@@ -57,11 +63,13 @@ struct BTreeTotalMetrics {
     read_cnt_ += get_cnt;
   }
 
+  auto WritePerSec() -> double { return write_cnt_ / static_cast<double>(ClockMs() - start_time_) * 1000; }
+
+  auto ReadPerSec() -> double { return read_cnt_ / static_cast<double>(ClockMs() - start_time_) * 1000; }
+
   void Report() {
-    auto now = ClockMs();
-    auto elsped = now - start_time_;
-    auto write_per_sec = write_cnt_ / static_cast<double>(elsped) * 1000;
-    auto read_per_sec = read_cnt_ / static_cast<double>(elsped) * 1000;
+    auto write_per_sec = WritePerSec();
+    auto read_per_sec = ReadPerSec();
 
     fmt::print("<<< BEGIN\n");
     fmt::print("write: {}\n", write_per_sec);
@@ -110,67 +118,44 @@ auto KeyWillVanish(size_t key) -> bool { return key % 7 == 0; }
 // These keys will be overwritten to a new value
 auto KeyWillChange(size_t key) -> bool { return key % 5 == 0; }
 
-// NOLINTNEXTLINE
-auto main(int argc, char **argv) -> int {
-  using bustub::AccessType;
-  using bustub::BufferPoolManager;
-  using bustub::DiskManagerUnlimitedMemory;
-  using bustub::page_id_t;
-
-  argparse::ArgumentParser program("bustub-btree-bench");
-  program.add_argument("--duration").help("run btree bench for n milliseconds");
-
-  try {
-    program.parse_args(argc, argv);
-  } catch (const std::runtime_error &err) {
-    std::cerr << err.what() << std::endl;
-    std::cerr << program;
-    return 1;
-  }
-
-  uint64_t duration_ms = 30000;
-  if (program.present("--duration")) {
-    duration_ms = std::stoi(program.get("--duration"));
-  }
-
-  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
-
-  fmt::print(stderr, "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}\n", TOTAL_KEYS, duration_ms,
-             LRU_K_SIZE, BUSTUB_BPM_SIZE);
+using BPlusTreeType = bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+using LeafPageType = bustub::BPlusTreeLeafPage<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+using InternalPageType =
+    bustub::BPlusTreeInternalPage<bustub::GenericKey<8>, bustub::page_id_t, bustub::GenericComparator<8>>;
 
-  auto key_schema = bustub::ParseCreateStatement("a bigint");
-  bustub::GenericComparator<8> comparator(key_schema.get());
+// the default page sizes of BPlusTreeType, LEAF_PAGE_SIZE and INTERNAL_PAGE_SIZE
+static const int LEAF_MAX_SIZE =
+    (bustub::BUSTUB_PAGE_SIZE - sizeof(LeafPageType)) / sizeof(std::pair<bustub::GenericKey<8>, bustub::RID>);
+static const int INTERNAL_MAX_SIZE =
+    (bustub::BUSTUB_PAGE_SIZE - sizeof(InternalPageType)) / sizeof(std::pair<bustub::GenericKey<8>, bustub::page_id_t>);
 
-  page_id_t page_id;
-  auto header_page = bpm->NewPageGuarded(&page_id);
+// run the reader and writer threads against index for duration_ms, the throughput is added to total_metrics.
+// With a compact_interval_ms, a background thread also compacts the leaves of the index at that interval.
+void RunWorkload(BPlusTreeType *index, size_t read_threads, size_t write_threads, uint64_t duration_ms,
+                 BTreeTotalMetrics *total_metrics, uint64_t compact_interval_ms = 0) {
+  total_metrics->Begin();
 
-  bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>> index("foo_pk", page_id,
-                                                                                            bpm.get(), comparator);
+  std::vector<std::thread> threads;
 
-  for (size_t key = 0; key < TOTAL_KEYS; key++) {
-    bustub::GenericKey<8> index_key;
-    bustub::RID rid;
-    uint32_t value = key;
-    rid.Set(value, value);
-    index_key.SetFromInteger(key);
-    index.Insert(index_key, rid, nullptr);
+  if (compact_interval_ms > 0) {
+    threads.emplace_back(std::thread([index, duration_ms, compact_interval_ms] {
+      auto start = ClockMs();
+      size_t merged = 0;
+      while (ClockMs() - start + compact_interval_ms < duration_ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(compact_interval_ms));
+        merged += index->Compact();
+      }
+      fmt::print(stderr, "[info] compaction merged {} leaves\n", merged);
+    }));
   }
 
-  fmt::print(stderr, "[info] benchmark start\n");
-
-  BTreeTotalMetrics total_metrics;
-  total_metrics.Begin();
-
-  std::vector<std::thread> threads;
-
-  for (size_t thread_id = 0; thread_id < BUSTUB_READ_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &index, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < read_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, read_threads, index, duration_ms, total_metrics] {
       BTreeMetrics metrics(fmt::format("read  {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t key_start = TOTAL_KEYS / BUSTUB_READ_THREAD * thread_id;
-      size_t key_end = TOTAL_KEYS / BUSTUB_READ_THREAD * (thread_id + 1);
+      size_t key_start = TOTAL_KEYS / read_threads * thread_id;
+      size_t key_end = TOTAL_KEYS / read_threads * (thread_id + 1);
       std::random_device r;
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
@@ -184,7 +169,7 @@ auto main(int argc, char **argv) -> int {
         for (auto key = base_key; key < key_end && cnt < KEY_MODIFY_RANGE; key++, cnt++) {
           rids.clear();
           index_key.SetFromInteger(key);
-          index.GetValue(index_key, &rids);
+          index->GetValue(index_key, &rids);
 
           if (!KeyWillVanish(key) && rids.empty()) {
             std::string msg = fmt::format("key not found: {}", key);
@@ -206,17 +191,17 @@ auto main(int argc, char **argv) -> int {
         }
       }
 
-      total_metrics.ReportRead(metrics.cnt_);
+      total_metrics->ReportRead(metrics.cnt_);
     }));
   }
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_WRITE_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &index, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < write_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, write_threads, index, duration_ms, total_metrics] {
       BTreeMetrics metrics(fmt::format("write {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t key_start = TOTAL_KEYS / BUSTUB_WRITE_THREAD * thread_id;
-      size_t key_end = TOTAL_KEYS / BUSTUB_WRITE_THREAD * (thread_id + 1);
+      size_t key_start = TOTAL_KEYS / write_threads * thread_id;
+      size_t key_end = TOTAL_KEYS / write_threads * (thread_id + 1);
       std::random_device r;
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
@@ -235,9 +220,9 @@ auto main(int argc, char **argv) -> int {
             rid.Set(value, value);
             index_key.SetFromInteger(key);
             if (do_insert) {
-              index.Insert(index_key, rid, nullptr);
+              index->Insert(index_key, rid, nullptr);
             } else {
-              index.Remove(index_key, nullptr);
+              index->Remove(index_key, nullptr);
             }
             metrics.Tick();
             metrics.Report();
@@ -245,7 +230,7 @@ auto main(int argc, char **argv) -> int {
             uint32_t value = key;
             rid.Set(value, dis(gen));
             index_key.SetFromInteger(key);
-            index.Insert(index_key, rid, nullptr);
+            index->Insert(index_key, rid, nullptr);
             metrics.Tick();
             metrics.Report();
           }
@@ -253,15 +238,192 @@ auto main(int argc, char **argv) -> int {
         do_insert = !do_insert;
       }
 
-      total_metrics.ReportWrite(metrics.cnt_);
+      total_metrics->ReportWrite(metrics.cnt_);
     }));
   }
 
   for (auto &thread : threads) {
     thread.join();
   }
+}
+
+using NormalizedKeyType = bustub::NormalizedKey<16>;
+using NormalizedComparatorType = bustub::NormalizedComparator<16>;
+
+// the ns per lookup of random existing keys, over LEARNED_LOOKUPS lookups from one thread
+template <typename Lookup>
+auto TimeLookups(const std::vector<NormalizedKeyType> &keys, Lookup &&lookup) -> double {
+  std::mt19937_64 gen(15445);
+  std::uniform_int_distribution<size_t> dis(0, keys.size() - 1);
+  std::vector<bustub::RID> result;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < LEARNED_LOOKUPS; i++) {
+    result.clear();
+    if (!lookup(keys[dis(gen)], &result)) {
+      throw bustub::Exception("a key is missing");
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(elapsed.count()) / LEARNED_LOOKUPS;
+}
+
+// compare the lookup latency and the memory of a B+ tree and a learned leaf array over the same TOTAL_KEYS sorted
+// keys, spread with random gaps. Each has its own buffer pool, large enough to keep all of its pages.
+void RunLearnedComparison() {
+  std::mt19937_64 gen(445);
+  std::uniform_int_distribution<int64_t> gap(1, 64);
+  std::vector<NormalizedKeyType> keys(TOTAL_KEYS);
+  std::vector<std::pair<NormalizedKeyType, bustub::RID>> entries;
+  int64_t key = 0;
+  for (size_t i = 0; i < TOTAL_KEYS; i++) {
+    key += gap(gen);
+    keys[i].SetFromInteger(key);
+    entries.emplace_back(keys[i], bustub::RID(i, i));
+  }
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  NormalizedComparatorType comparator(key_schema.get());
+
+  // the page ids of a buffer pool are allocated from 0, so a new page tells how many pages were written before it
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto tree_bpm = std::make_unique<bustub::BufferPoolManager>(LEARNED_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  bustub::page_id_t header_page_id;
+  tree_bpm->NewPageGuarded(&header_page_id);
+  bustub::BPlusTree<NormalizedKeyType, bustub::RID, NormalizedComparatorType> tree("tree", header_page_id,
+                                                                                    tree_bpm.get(), comparator);
+  tree.InsertBatch(entries);
+  bustub::page_id_t tree_pages;
+  tree_bpm->NewPageGuarded(&tree_pages);
+
+  auto learned_disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto learned_bpm =
+      std::make_unique<bustub::BufferPoolManager>(LEARNED_BPM_SIZE, learned_disk_manager.get(), LRU_K_SIZE);
+  using LearnedType = bustub::LearnedLeafArray<NormalizedKeyType, bustub::RID, NormalizedComparatorType>;
+  LearnedType learned("learned", learned_bpm.get(), comparator);
+  learned.Build(entries);
+  bustub::page_id_t learned_pages;
+  learned_bpm->NewPageGuarded(&learned_pages);
+
+  auto tree_ns = TimeLookups(keys, [&tree](const auto &key, auto *result) { return tree.GetValue(key, result); });
+  auto learned_ns =
+      TimeLookups(keys, [&learned](const auto &key, auto *result) { return learned.GetValue(key, result); });
+
+  fmt::print("index        lookup_ns  pages  bytes\n");
+  fmt::print("{:<12} {:<10.0f} {:<6} {}\n", "b+tree", tree_ns, tree_pages,
+             static_cast<size_t>(tree_pages) * bustub::BUSTUB_PAGE_SIZE);
+  fmt::print("{:<12} {:<10.0f} {:<6} {}\n", "learned", learned_ns, learned_pages,
+             static_cast<size_t>(learned_pages) * bustub::BUSTUB_PAGE_SIZE + learned.GetModelBytes());
+  fmt::print(stderr, "[info] learned model: {} segments, max_error={}\n", learned.GetSegmentCount(),
+             bustub::LEARNED_INDEX_MAX_ERROR);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  using bustub::AccessType;
+  using bustub::BufferPoolManager;
+  using bustub::DiskManagerUnlimitedMemory;
+  using bustub::page_id_t;
+
+  argparse::ArgumentParser program("bustub-btree-bench");
+  program.add_argument("--duration").help("run btree bench for n milliseconds");
+  program.add_argument("--read-threads").help("number of reader threads");
+  program.add_argument("--write-threads").help("number of writer threads");
+  program.add_argument("--latch").help("how readers latch pages: optimistic or pessimistic");
+  program.add_argument("--underflow-fill").help("fraction of a page below which a delete rebalances it, 0 to 0.5");
+  program.add_argument("--compact-interval").help("compact the leaves in the background every n milliseconds");
+  program.add_argument("--sweep")
+      .help("compare both latch modes from 1 to 64 reader threads, every run takes --duration")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--learned")
+      .help("compare the lookup latency and memory of a B+ tree and a learned index over read-only keys")
+      .default_value(false)
+      .implicit_value(true);
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  if (program.get<bool>("--learned")) {
+    RunLearnedComparison();
+    return 0;
+  }
+
+  uint64_t duration_ms = 30000;
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+  size_t read_threads = BUSTUB_READ_THREAD;
+  if (program.present("--read-threads")) {
+    read_threads = std::stoi(program.get("--read-threads"));
+  }
+  size_t write_threads = BUSTUB_WRITE_THREAD;
+  if (program.present("--write-threads")) {
+    write_threads = std::stoi(program.get("--write-threads"));
+  }
+  if (program.present("--latch")) {
+    bustub::enable_optimistic_index_read = program.get("--latch") != "pessimistic";
+  }
+  double underflow_fill = bustub::UNDERFLOW_FILL_FACTOR;
+  if (program.present("--underflow-fill")) {
+    underflow_fill = std::stod(program.get("--underflow-fill"));
+  }
+  uint64_t compact_interval_ms = 0;
+  if (program.present("--compact-interval")) {
+    compact_interval_ms = std::stoi(program.get("--compact-interval"));
+  }
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+
+  fmt::print(stderr,
+             "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}, optimistic_read={}, "
+             "underflow_fill={}, compact_interval_ms={}\n",
+             TOTAL_KEYS, duration_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE, bustub::enable_optimistic_index_read.load(),
+             underflow_fill, compact_interval_ms);
 
+  auto key_schema = bustub::ParseCreateStatement("a bigint");
+  bustub::GenericComparator<8> comparator(key_schema.get());
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPageGuarded(&page_id);
+
+  BPlusTreeType index("foo_pk", page_id, bpm.get(), comparator, LEAF_MAX_SIZE, INTERNAL_MAX_SIZE, underflow_fill);
+
+  for (size_t key = 0; key < TOTAL_KEYS; key++) {
+    bustub::GenericKey<8> index_key;
+    bustub::RID rid;
+    uint32_t value = key;
+    rid.Set(value, value);
+    index_key.SetFromInteger(key);
+    index.Insert(index_key, rid, nullptr);
+  }
+
+  fmt::print(stderr, "[info] benchmark start\n");
+
+  if (program.get<bool>("--sweep")) {
+    // reader throughput of both latch modes at 1, 2, 4, ... reader threads
+    fmt::print("latch        read_threads  read/s        write/s\n");
+    for (bool optimistic : {false, true}) {
+      bustub::enable_optimistic_index_read = optimistic;
+      for (size_t threads = 1; threads <= BUSTUB_SWEEP_MAX_THREAD; threads *= 2) {
+        BTreeTotalMetrics total_metrics;
+        RunWorkload(&index, threads, write_threads, duration_ms, &total_metrics, compact_interval_ms);
+        fmt::print("{:<12} {:<13} {:<13.0f} {:.0f}\n", optimistic ? "optimistic" : "pessimistic", threads,
+                   total_metrics.ReadPerSec(), total_metrics.WritePerSec());
+      }
+    }
+    return 0;
+  }
+
+  BTreeTotalMetrics total_metrics;
+  RunWorkload(&index, read_threads, write_threads, duration_ms, &total_metrics, compact_interval_ms);
   total_metrics.Report();
+  fmt::print(stderr, "[info] bloom filter: {} bytes, expected false positive rate {:.4f}\n", index.GetFilterByteCount(),
+             index.GetFilterFalsePositiveRate());
 
   return 0;
 }
@@ -105,6 +105,21 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           return false;
         }
         check_options->check_options_set_.emplace(bustub::CheckOption::ENABLE_TOPN_CHECK);
+      } else if (opt == "ensure:index_only_scan") {
+        if (!bustub::StringUtil::Contains(result.str(), "index_only=true")) {
+          fmt::print("index-only IndexScan not found\n");
+          return false;
+        }
+      } else if (opt == "ensure:bitmap_heap_scan") {
+        if (!bustub::StringUtil::Contains(result.str(), "BitmapHeapScan")) {
+          fmt::print("BitmapHeapScan not found\n");
+          return false;
+        }
+      } else if (opt == "ensure:skip_scan") {
+        if (!bustub::StringUtil::Contains(result.str(), "skip=")) {
+          fmt::print("skip scan not found\n");
+          return false;
+        }
       } else if (opt == "ensure:index_join") {
         if (!bustub::StringUtil::Contains(result.str(), "NestedIndexJoin")) {
           fmt::print("NestedIndexJoin not found\n");